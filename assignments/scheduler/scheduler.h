@@ -0,0 +1,1132 @@
+/**
+ * CPU Scheduler Simulator: constants, types and prototypes shared by the
+ * scheduling functions (scheduler.c) and the simulator (simulator.c)
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // sched_setaffinity and CPU_SET (implies _DEFAULT_SOURCE)
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <inttypes.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <glob.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/mman.h>
+#include <sched.h>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+/************************* CONSTANTS & DEFINITIONS *************************/
+
+// Scheduling algorithm identifiers
+typedef enum {
+    FCFS = 0,  // First-Come, First-Served
+    RR   = 1,  // Round Robin
+    SRTF = 2,  // Shortest Remaining Time First (preemptive)
+    SJF  = 3,  // Shortest Job First (non-preemptive)
+    LAS  = 4,  // Least Attained Service (preemptive, needs no job sizes)
+    PRIO = 5,  // Highest priority first (preemptive)
+    MLQ  = 6   // Multi-level queue: a policy per workload class (see --mlq)
+} Algorithm;
+
+// How lock owners' priorities react to contention
+typedef enum {
+    LOCK_PROTOCOL_NONE    = 0,  // Owners keep their own priority
+    LOCK_PROTOCOL_INHERIT = 1,  // Owners inherit the priority of their highest waiter
+    LOCK_PROTOCOL_CEILING = 2   // Owners run at the lock's ceiling priority while holding it
+} LockProtocol;
+
+// What the burst predictor keys its history on
+typedef enum {
+    PREDICT_NONE  = 0,  // Policies see true burst times (oracle)
+    PREDICT_PID   = 1,  // Exponential average of prior bursts with the same PID
+    PREDICT_CLASS = 2   // Exponential average of prior bursts in the same class
+} PredictionMode;
+
+// Process states
+typedef enum {
+    WAITING    = 0,  // Ready to run but not yet scheduled or arrived
+    RUNNING    = 1,  // Currently executing on a CPU
+    COMPLETED  = 2,  // Finished execution
+    READY      = 3,  // In the ready queue (specifically for RR)
+    BLOCKED    = 4,  // Waiting for a storage I/O request or a lock
+    THROTTLED  = 5   // Out of CPU bandwidth until the next period
+} ProcessState;
+
+// Workload file formats
+typedef enum {
+    FORMAT_NATIVE = 0,  // <PID> <arrival> <burst> [priority] [key=value ...]
+    FORMAT_SWF    = 1,  // Standard Workload Format (Parallel Workloads Archive)
+    FORMAT_CSV    = 2   // Delimited text with a user-supplied column mapping
+} TraceFormat;
+
+// Cluster dispatch policies
+typedef enum {
+    DISPATCH_ROUND_ROBIN = 0,  // Hosts in turn
+    DISPATCH_RANDOM      = 1,  // Uniformly random host
+    DISPATCH_JSQ         = 2,  // Join-shortest-queue (fewest jobs in system)
+    DISPATCH_POWER_OF_D  = 3   // Shortest queue among d random hosts
+} DispatchPolicy;
+
+// Garbage-collection victim selection for the flash storage model
+typedef enum {
+    GC_GREEDY       = 0,  // Block with the fewest valid pages
+    GC_COST_BENEFIT = 1   // Block maximizing (1-u)*age/(1+u), favours cold blocks
+} GcPolicy;
+
+// CPU frequency / idle-state management
+typedef enum {
+    ENERGY_OFF         = 0,  // No power model
+    ENERGY_PERFORMANCE = 1,  // Highest frequency, shallow idle states only
+    ENERGY_POWERSAVE   = 2,  // Lowest frequency
+    ENERGY_ONDEMAND    = 3,  // Frequency follows each CPU's recent utilization
+    ENERGY_RACE        = 4,  // Race to idle: highest frequency, deepest idle states
+    ENERGY_CONSOLIDATE = 5   // Pack work onto as few cores as possible, park the rest
+} EnergyPolicy;
+
+// Where NUMA processes run relative to their memory (see --numa-policy)
+typedef enum {
+    NUMA_OBLIVIOUS = 0,  // The scheduling policy's CPU choice stands
+    NUMA_LOCAL     = 1,  // Move processes onto their home node when a CPU there allows
+    NUMA_BALANCE   = 2   // Local placement, and memory follows a process that stays remote
+} NumaPolicy;
+
+// Columns of the results store (see --results)
+typedef enum {
+    RESULT_WORKLOAD   = 0,  // Dictionary id of the input file
+    RESULT_ALGORITHM  = 1,  // Dictionary id of the -a name
+    RESULT_CPUS       = 2,
+    RESULT_QUANTUM    = 3,
+    RESULT_PID        = 4,
+    RESULT_ARRIVAL    = 5,
+    RESULT_BURST      = 6,
+    RESULT_PRIORITY   = 7,
+    RESULT_START      = 8,  // Time columns from here on use -1 for N/A
+    RESULT_FINISH     = 9,
+    RESULT_TURNAROUND = 10,
+    RESULT_WAITING    = 11,
+    RESULT_RESPONSE   = 12,
+    NUM_RESULT_COLUMNS
+} ResultColumn;
+
+// Comparisons in results queries
+typedef enum {
+    FILTER_EQ = 0,  // =
+    FILTER_NE = 1,  // !=
+    FILTER_LT = 2,  // <
+    FILTER_LE = 3,  // <=
+    FILTER_GT = 4,  // >
+    FILTER_GE = 5   // >=
+} FilterOp;
+
+// Configuration constants
+#define DEFAULT_TIME_QUANTUM 2
+#define INITIAL_TIMELINE_CAPACITY 1000
+#define INITIAL_HOST_CAPACITY 64     // Jobs a cluster host has room for before its storage grows
+#define MAX_LINE_LENGTH 256
+#define TRACE_LINE_LENGTH 4096
+#define INITIAL_TRACE_CAPACITY 1024
+#define DEFAULT_IO_PAGES 64
+#define DEFAULT_DISPATCH_CHOICES 2
+#define DEFAULT_SEED 12345u
+#define DEFAULT_PREDICTION_ALPHA 0.5
+#define DEFAULT_INITIAL_ESTIMATE 5
+#define MAX_CLASSES 16
+#define MAX_WHATIF_BRANCHES 8
+#define MAX_SWEEP_LANES 16
+#define SWEEP_BENCH_ROUNDS 3
+#define MAX_LOCKS 16
+#define MAX_PROCESS_LOCKS 4
+#define WINDOW_EXACT_BUCKETS 64     // Response times below this are counted exactly
+#define WINDOW_SUB_BUCKETS 8        // Buckets per power of two above that
+#define WINDOW_RESPONSE_BUCKETS (WINDOW_EXACT_BUCKETS + 57 * WINDOW_SUB_BUCKETS) // Up to 2^63
+#define MAX_CLASS_NAME 32
+#define DEFAULT_TICK_MS 1.0
+#define PARK_IDLE_TICKS 8           // Idle ticks before consolidation parks a core
+#define UNPARK_PRESSURE_TICKS 2     // Ticks of backlog before consolidation unparks one
+#define PARK_EXIT_LATENCY 10        // Ticks to power a parked (gated) core back up
+#define RESULTS_CHUNK_ROWS 4096     // Rows per chunk of a results store
+#define MAX_RESULT_FILTERS 8
+#define MAX_TIMELINE_TICKS 1000000   // Longer runs are not drawn
+#define QUEUE_BENCH_CAPACITY 1024    // Work queue size in --queue-bench (half full throughout)
+#define QUEUE_BENCH_OPERATIONS 500000 // Tasks taken per benchmark run, split across the threads
+#define QUEUE_BENCH_WORK 200         // xorshift steps per tiny task
+#define QUEUE_BENCH_ROUNDS 3
+#define MAX_QUEUE_BENCH_THREADS 256  // At most half of QUEUE_BENCH_CAPACITY, so the queue never runs dry
+#define DEFAULT_CHECKPOINT_INTERVAL 1000
+#define DEFAULT_NUMA_PENALTY 1.5
+#define MAX_NUMA_PENALTY 4.0         // Keeps runs within sim_time_limit
+#define NUMA_MIGRATE_TICKS 20        // Consecutive remote ticks before balancing moves the memory
+#define NUMA_MIGRATE_COST 5          // Ticks a memory migration stalls the process
+#define DEFAULT_MLQ_SLICE 10         // Ticks a level leads each frame under time-slice arbitration
+#define MAX_VALIDATE_PROCESSES 64    // Children forked by --validate
+#define MAX_VALIDATE_NS 60000000000.0 // Total CPU time --validate may burn
+#define VALIDATE_LEAD_NS 50000000LL  // Delay before the first release, so every child is waiting
+#define VALIDATE_CALIBRATION_NS 20000000LL
+#define VALIDATE_CALIBRATION_ROUNDS 5
+
+// Flash storage defaults (latencies are in simulation ticks)
+#define SSD_DEFAULT_BLOCKS 128
+#define SSD_DEFAULT_PAGES_PER_BLOCK 32
+#define SSD_DEFAULT_OP_PERCENT 10
+#define SSD_DEFAULT_PREFILL_PERCENT 90
+#define SSD_DEFAULT_GC_FREE_BLOCKS 2
+#define SSD_DEFAULT_READ_LATENCY 1
+#define SSD_DEFAULT_PROGRAM_LATENCY 1
+#define SSD_DEFAULT_ERASE_LATENCY 4
+
+// Display settings
+#define TIMELINE_WIDTH 80
+#define TIME_UNIT_WIDTH 5
+
+// Color codes for visualization
+#define COLOR_RESET  "\033[0m"
+#define COLOR_BOLD   "\033[1m"
+#define COLOR_RED    "\033[31m"
+#define COLOR_GREEN  "\033[32m"
+#define COLOR_YELLOW "\033[33m"
+#define COLOR_BLUE   "\033[34m"
+#define COLOR_MAGENTA "\033[35m"
+#define COLOR_CYAN   "\033[36m"
+#define COLOR_WHITE  "\033[37m"
+
+// Workload class names seen in the input (class 0 is the default class)
+extern char CLASS_NAMES[MAX_CLASSES][MAX_CLASS_NAME];
+extern int CLASS_COUNT;
+extern pthread_mutex_t CLASS_LOCK; // Batch workers load files concurrently
+
+// Length of one tick in nanoseconds, for times given in real units (see --resolution)
+extern long long TICK_NS;
+
+// Column names of the results store, and the keys recorded for each Algorithm
+extern const char *RESULT_COLUMN_NAMES[NUM_RESULT_COLUMNS];
+extern const char *ALGORITHM_KEYS[];
+
+/************************* TYPE DEFINITIONS *************************/
+
+/**
+ * Simulated time: a count of ticks, each TICK_NS nanoseconds long (see
+ * --resolution). 64 bits keep traces spanning days at ns resolution in range.
+ */
+typedef long long SimTime;
+#define SIMTIME_MAX LLONG_MAX
+
+/**
+ * A CPU operating point. Bursts are measured at the highest frequency, so
+ * a CPU at f MHz completes f / f_max units of work per tick.
+ */
+typedef struct {
+    int mhz;
+    double active_watts;
+} FreqLevel;
+
+/**
+ * A CPU idle state. The idle governor enters the deepest allowed state
+ * whose target residency the current idle period has reached; waking from
+ * it delays the next process by exit_latency ticks.
+ */
+typedef struct {
+    const char *name;
+    double watts;
+    int exit_latency;
+    int target_residency;
+} IdleState;
+
+#define NUM_FREQ_LEVELS 3
+extern const FreqLevel FREQ_LEVELS[NUM_FREQ_LEVELS];
+
+#define NUM_IDLE_STATES 3
+extern const IdleState IDLE_STATES[NUM_IDLE_STATES];
+
+/**
+ * A critical section: the process holds lock from acquire_at to release_at
+ * (both measured in CPU time the process has received)
+ */
+typedef struct {
+    int lock;             // Lock id (0..MAX_LOCKS-1)
+    SimTime acquire_at;   // Attained CPU time at which the lock is taken
+    SimTime release_at;   // Attained CPU time at which the lock is released
+} LockUse;
+
+/**
+ * Process data structure containing all information about a process
+ */
+typedef struct {
+    int pid;              // Process ID
+    SimTime arrival_time; // Time when process becomes available
+    SimTime burst_time;   // Total CPU time required
+    int priority;         // Priority (higher value = higher priority)
+    SimTime remaining_time; // Remaining CPU time needed
+    ProcessState state;   // Current state (WAITING, RUNNING, etc.)
+    SimTime start_time;   // When process first started (-1 if not started)
+    SimTime finish_time;  // When process completed (-1 if not finished)
+    SimTime waiting_time; // Total time spent waiting
+    SimTime quantum_used; // Time units used in current quantum (for RR)
+    SimTime response_time; // Time between arrival and first execution
+    SimTime io_interval;  // CPU time between page writes (0 = CPU-bound)
+    int io_pages;         // Size of the logical working set written to
+    SimTime io_wake_time; // When the outstanding write completes (-1 if none)
+    SimTime io_time;      // Total time spent blocked on storage I/O
+    int class_id;         // Workload class (see class=NAME), 0 = default
+    SimTime predicted_burst; // Burst estimate the policy sees (-1 = true burst)
+    int base_priority;    // Priority before any inheritance or ceiling boost
+    LockUse lock_uses[MAX_PROCESS_LOCKS]; // Critical sections (see lock=ID:ACQ:REL)
+    int lock_use_count;   // Number of entries in lock_uses
+    int locks_held;       // Bit u set while lock_uses[u] is held
+    int blocked_on;       // Lock the process is waiting for (-1 if none)
+    SimTime lock_wait_time; // Total time blocked on locks
+    SimTime inversion_time; // Time blocked on a lock owned by a lower-priority process
+    SimTime bw_quota;     // Own CPU bandwidth limit: quota ticks per bw_period (0 = none)
+    SimTime bw_period;
+    int bucket;           // Bandwidth bucket the process is charged to (-1 if unlimited)
+    SimTime throttle_start; // When the current throttling began
+    SimTime throttled_time; // Total time spent throttled
+    long queued_at;       // When it joined its MLQ level's queue, in queueing order
+    int home_node;        // NUMA node holding its memory (see node=N; -1: where it first runs)
+    double numa_credit;   // Work accumulated while running remotely
+    int remote_streak;    // Consecutive ticks run off the home node
+    SimTime local_time;   // CPU time on the home node
+    SimTime remote_time;  // CPU time off the home node
+} Process;
+
+/**
+ * CPU data structure representing a processor
+ */
+typedef struct {
+    int id;               // CPU identifier
+    Process *current_process; // Process currently running (NULL if idle)
+    SimTime idle_time;    // Total time CPU was idle
+    SimTime busy_time;    // Total time CPU was busy
+} CPU;
+
+/**
+ * Flash device configuration (see --ssd)
+ */
+typedef struct {
+    bool enabled;         // Whether storage I/O is modelled at all
+    int blocks;           // Physical erase blocks
+    int pages_per_block;  // Pages per erase block
+    int op_percent;       // Over-provisioning: % of physical pages hidden from the host
+    int prefill_percent;  // % of logical space written before the simulation starts
+    int gc_free_blocks;   // Run GC while fewer than this many blocks are free
+    GcPolicy gc_policy;   // Victim selection policy
+    int read_latency;     // Ticks to read one page
+    int program_latency;  // Ticks to program one page
+    int erase_latency;    // Ticks to erase one block
+} SsdConfig;
+
+/**
+ * Per-block bookkeeping for the flash translation layer
+ */
+typedef struct {
+    int valid_pages;      // Pages still referenced by the mapping table
+    int next_page;        // Next unwritten page (pages_per_block when full)
+    int erase_count;      // Number of erases (wear)
+    SimTime last_write;   // Time of the most recent program (cost-benefit age)
+} FlashBlock;
+
+/**
+ * Page-mapped SSD with out-of-place writes and foreground garbage collection.
+ * Requests are served one at a time, so GC pauses delay every queued writer.
+ */
+typedef struct {
+    SsdConfig cfg;
+    int logical_pages;    // Host-visible capacity in pages
+    int *l2p;             // Logical -> physical page (-1 if unmapped)
+    int *p2l;             // Physical -> logical page (-1 if free or stale)
+    FlashBlock *blocks;   // Per-block state
+    int *free_blocks;     // Stack of erased blocks
+    int free_count;       // Number of erased blocks on the stack
+    int active_block;     // Block receiving new writes (-1 if none)
+    SimTime busy_until;   // Device is serving earlier requests until this time
+    unsigned int rng;     // xorshift state for choosing page addresses
+    long host_writes;     // Pages written on behalf of processes
+    long flash_writes;    // Pages programmed, including GC relocations
+    long gc_runs;         // Blocks reclaimed by GC
+    SimTime *latencies;   // Service latency of each host write
+    int latency_count;    // Number of recorded latencies
+    int latency_capacity; // Allocated size of latencies
+} Ssd;
+
+/**
+ * How trace records are turned into processes (see --format, --csv-map)
+ */
+typedef struct {
+    TraceFormat format;   // Input file format
+    int pid_column;       // CSV: 1-based column of each field (0 = absent)
+    int arrival_column;
+    int burst_column;
+    int priority_column;
+    char separator;       // CSV field separator
+    int skip_lines;       // CSV: header lines to ignore
+    int time_scale;       // Divide all times by this (e.g. seconds -> minutes)
+} TraceOptions;
+
+/**
+ * Cluster layout and dispatching (see --hosts, --dispatch)
+ */
+typedef struct {
+    int hosts;            // Number of hosts (1 = plain single-host simulation)
+    DispatchPolicy dispatch; // How arriving jobs are routed to hosts
+    int choices;          // d for power-of-d-choices
+    unsigned int seed;    // Seed for randomized dispatch
+} ClusterOptions;
+
+/**
+ * Burst prediction settings (see --predict)
+ */
+typedef struct {
+    PredictionMode mode;  // History key, or PREDICT_NONE for oracle sizes
+    double alpha;         // Weight of the most recent burst
+    SimTime initial_estimate; // Estimate for a key with no history
+} PredictionOptions;
+
+/**
+ * What-if branching (see --whatif, --alt)
+ */
+typedef struct {
+    SimTime branch_time;  // Time at which the simulation forks (-1 = off)
+    int branch_count;     // Number of alternatives
+    Algorithm algorithms[MAX_WHATIF_BRANCHES]; // Policy of each alternative
+    SimTime quanta[MAX_WHATIF_BRANCHES];       // Quantum of each alternative
+} WhatIfOptions;
+
+/**
+ * Time-series export (see --window)
+ */
+typedef struct {
+    SimTime width;        // Ticks per row (0 = off)
+    const char *path;     // Output file
+    bool binary;          // Fixed-size binary records instead of CSV
+} WindowOptions;
+
+/**
+ * Per-class CPU bandwidth limits (see --cpu-max); quota 0 means unlimited
+ */
+typedef struct {
+    SimTime quota[MAX_CLASSES];
+    SimTime period[MAX_CLASSES];
+} BandwidthOptions;
+
+/**
+ * SRTF preemption checks (see --preempt-threshold, --preempt-stats)
+ */
+typedef struct {
+    SimTime threshold;    // Preempt only for a remaining-time advantage above this (or equal to it,
+                          // for a higher priority)
+    bool report;          // Print preemption statistics
+} PreemptionOptions;
+
+/**
+ * How often SRTF preemption was checked, skipped and carried out
+ */
+typedef struct {
+    long ticks;           // Ticks simulated under SRTF
+    long checks;          // Calls to handle_srtf_preemption
+    long skipped;         // Ticks on which no check was needed
+    long preemptions;     // Running processes displaced
+    long suppressed;      // Arrivals shorter than a running process, but within the threshold
+    long visits_avoided;  // Process-table entries a per-tick check would have scanned
+} PreemptionStats;
+
+/**
+ * Power model settings (see --energy)
+ */
+typedef struct {
+    EnergyPolicy policy;
+    double tick_ms;       // Wall-clock length of one tick
+} EnergyOptions;
+
+/**
+ * NUMA model settings (see --numa)
+ */
+typedef struct {
+    int nodes;            // NUMA nodes (0: off)
+    double penalty;       // Slowdown of a process running off its home node
+    NumaPolicy policy;
+} NumaOptions;
+
+/**
+ * NUMA topology and accounting of a simulation
+ */
+typedef struct {
+    int *cpu_node;        // Node of each CPU
+    Process **stalled;    // Process held back from execute_processes this tick, per CPU
+    long *local_ticks;    // CPU ticks each node ran processes homed on it
+    long *remote_ticks;   // CPU ticks each node ran processes homed elsewhere
+    long migrations;      // Processes moved between CPUs by placement
+    long memory_migrations; // Home nodes moved by balancing
+} NumaState;
+
+/**
+ * Power state and energy accounting of one CPU
+ */
+typedef struct {
+    int level;            // Current frequency level
+    int idle_state;       // Idle state during the last tick (-1 while active)
+    int idle_ticks;       // Length of the current idle period
+    int waking;           // Exit-latency ticks left before the CPU can run
+    double credit;        // Work accumulated at reduced frequency
+    double utilization;   // Moving average of busy ticks (ondemand)
+    double joules;        // Energy consumed
+    long level_ticks[NUM_FREQ_LEVELS];  // Active ticks at each frequency
+    long state_ticks[NUM_IDLE_STATES];  // Idle ticks in each state
+    long wakeups[NUM_IDLE_STATES];      // Wake-ups from each state
+    bool parked;          // Power-gated by consolidation during the last tick
+    long parked_ticks;    // Ticks spent power-gated (drawing nothing)
+    long unparks;         // Times the core was powered back up
+    long wake_ticks;      // Ticks processes waited for this CPU to wake
+    Process *stalled;     // Process held back from execute_processes this tick
+} CpuPower;
+
+/**
+ * Runtime state of one bandwidth-limited group (a class or a single process)
+ */
+typedef struct {
+    SimTime quota;        // CPU ticks allowed per period
+    SimTime period;       // Refill interval
+    SimTime used;         // CPU ticks consumed in the current period
+    bool throttled;       // Members are off the ready structures until the refill
+    bool refill_pending;  // A refill timer is queued
+    int *members;         // Process indices charged to this bucket
+    int member_count;
+    int member_capacity;
+    long throttle_count;  // Periods in which the quota ran out
+    int owner_pid;        // PID for a per-process bucket, -1 for a class
+} Bucket;
+
+/**
+ * A pending bandwidth refill
+ */
+typedef struct {
+    SimTime time;
+    int bucket;
+} RefillTimer;
+/**
+ * Lockstep sweep (see --sweep-quanta, --sweep-cpus). Each list holds the
+ * values to try; an empty list means the -q / -c value. Quanta are swept
+ * under LAS only, since PRIO never looks at the quantum.
+ */
+typedef struct {
+    int quanta[MAX_SWEEP_LANES];
+    int quantum_count;
+    int cpus[MAX_SWEEP_LANES];
+    int cpu_value_count;
+    bool bench;           // Also time K independent runs and compare
+} SweepOptions;
+
+/**
+ * Counters for the current time-series window. Every event touches a fixed
+ * number of counters; response percentiles come from a log-linear histogram.
+ */
+typedef struct {
+    FILE *out;            // Destination (NULL when disabled)
+    bool binary;
+    SimTime width;        // Ticks per window
+    int cpu_count;
+    SimTime start;        // First tick of the current window
+    long *cpu_busy;       // Busy ticks of each CPU in this window
+    long arrivals;
+    long completions;
+    long preemptions;
+    long queue_area;      // Sum of run-queue length over the window's ticks
+    int queue_peak;       // Longest run queue seen in the window
+    int responses[WINDOW_RESPONSE_BUCKETS]; // Histogram of responses of completed jobs
+    int response_count;
+} WindowStats;
+
+/**
+ * Runtime state of one simulated mutex
+ */
+typedef struct {
+    Process *owner;       // Current holder (NULL if free)
+    int ceiling;          // Highest base priority of any process that uses it
+    int *waiters;         // Blocked processes (indices), in arrival order
+    int waiter_count;     // Number of blocked processes
+    long acquisitions;    // Times the lock was taken
+    long contended;       // Acquisitions that had to wait
+} SimLock;
+
+/**
+ * One filter of a results query (see --where), e.g. cpus>=4
+ */
+typedef struct {
+    int column;           // ResultColumn to test
+    FilterOp op;
+    const char *value;    // Integer, or a key for dictionary-encoded columns
+} ResultFilter;
+
+/**
+ * Batch runs over many workload files (see --batch, --workers, --queue-bench)
+ */
+typedef struct {
+    const char *path;     // Directory or glob of workload files (NULL: off)
+    int workers;          // Worker threads
+    bool format_given;    // --format / --csv-map applies to every file
+    bool queue_bench;     // Benchmark the work queue instead of simulating
+} BatchOptions;
+
+/**
+ * Bounded lock-free multi-producer multi-consumer queue of ints (Vyukov's
+ * array queue). Each cell's sequence number says whether it is free for
+ * the producer at position pos (sequence == pos) or holds the value for
+ * the consumer at pos (sequence == pos + 1); a producer or consumer claims
+ * its position with one compare-and-swap and never waits on a lock. The
+ * two positions sit on cache lines of their own.
+ */
+typedef struct {
+    atomic_size_t sequence;
+    int value;
+} WorkCell;
+
+typedef struct {
+    WorkCell *cells;
+    size_t mask;          // Capacity - 1 (capacity is a power of two)
+    char pad0[64];
+    atomic_size_t enqueue_pos;
+    char pad1[64];
+    atomic_size_t dequeue_pos;
+    char pad2[64];
+} WorkQueue;
+
+/**
+ * Columnar results store (see --results, --query)
+ */
+typedef struct {
+    const char *path;     // Store to append this run's results to (NULL: off)
+    const char *workload; // Key recorded for the input file
+    const char *query;    // Store to query instead of simulating (NULL: off)
+    ResultFilter filters[MAX_RESULT_FILTERS];
+    int filter_count;
+    int group_by;         // Column to group by (-1: one group)
+    int metric;           // Column to aggregate
+} ResultsOptions;
+
+/**
+ * Multi-level queue (see --mlq, --mlq-arbitration). Levels are listed
+ * highest priority first; classes not listed share an FCFS level below them
+ * (index level_count).
+ */
+typedef struct {
+    int level_count;
+    int classes[MAX_CLASSES];            // Workload class of each level
+    Algorithm policies[MAX_CLASSES + 1]; // FCFS, SJF or RR within each level
+    SimTime quanta[MAX_CLASSES + 1];     // RR quantum of each level (0 = -q)
+    SimTime slices[MAX_CLASSES + 1];     // Ticks each level leads per frame (time-slice arbitration)
+    bool time_slice;                     // Rotate the lead level instead of fixed priority
+    int level_of[MAX_CLASSES];           // Level of each class id
+} MlqOptions;
+
+/**
+ * Checkpointed runs and incremental re-runs (see --checkpoint, --resume)
+ */
+typedef struct {
+    const char *path;     // File to write checkpoints to (NULL: off)
+    SimTime interval;     // Simulated time between checkpoints
+    const char *resume;   // Checkpoints of a run of the workload before it was edited (NULL: off)
+} CheckpointOptions;
+
+/**
+ * Checkpoint file being written by a run
+ */
+typedef struct {
+    SimTime time;
+    long offset;          // Where the checkpoint starts in the file
+} CheckpointEntry;
+
+typedef struct {
+    FILE *file;
+    char *temp_path;      // Written here and renamed over the target once complete
+    SimTime interval;
+    SimTime last_time;    // Time of the last checkpoint written (-1: none yet)
+    SimTime next_time;    // When the next checkpoint is due
+    CheckpointEntry *entries; // Index written at the end of the file
+    int entry_count;
+    int entry_capacity;
+} CheckpointWriter;
+
+/**
+ * What a checkpoint keeps of a process: the fields a run changes
+ */
+typedef struct {
+    int32_t index;        // Position in the checkpointed workload
+    int32_t state;
+    int64_t remaining_time;
+    int64_t quantum_used;
+    int64_t start_time;
+    int64_t finish_time;
+    int64_t response_time;
+    int64_t waiting_time;
+    int64_t io_time;
+    int64_t lock_wait_time;
+} CheckpointRecord;
+
+/**
+ * Scheduling decision logs (see --record, --verify, --replay)
+ */
+typedef struct {
+    const char *record;   // Log to write this run's decisions to (NULL: off)
+    const char *verify;   // Log to compare this run's decisions with (NULL: off)
+    const char *replay;   // Log to replay instead of scheduling (NULL: off)
+} DecisionOptions;
+
+/**
+ * Optional simulator features enabled from the command line
+ */
+typedef struct {
+    SsdConfig ssd;        // Flash storage model
+    TraceOptions trace;   // Workload import
+    ClusterOptions cluster; // Multi-host simulation
+    PredictionOptions prediction; // Burst prediction
+    WhatIfOptions whatif; // What-if branching
+    LockProtocol lock_protocol; // Priority protocol for shared locks
+    WindowOptions window; // Time-series export
+    SweepOptions sweep;   // Lockstep configuration sweep
+    BandwidthOptions bandwidth; // Per-class CPU bandwidth limits
+    EnergyOptions energy; // Power model and policy
+    NumaOptions numa;     // NUMA nodes and placement
+    PreemptionOptions preemption; // SRTF preemption checks
+    ResultsOptions results; // Columnar results store
+    BatchOptions batch;   // Directory batch runs
+    CheckpointOptions checkpoint; // Checkpoints and incremental re-runs
+    DecisionOptions decisions; // Decision recording and replay
+    MlqOptions mlq;       // Multi-level queue levels and arbitration
+    bool tick_steps;      // Step one tick at a time even where events allow longer steps
+    bool validate;        // Run the workload as real processes and compare (see --validate)
+} SimOptions;
+
+/**
+ * Per-key exponential averages of observed bursts,
+ * tau(n+1) = alpha * t(n) + (1 - alpha) * tau(n), in an open-addressing table
+ */
+typedef struct {
+    PredictionMode mode;
+    double alpha;
+    SimTime initial_estimate;
+    int capacity;         // Table size (power of two)
+    int *keys;            // PID or class of each slot
+    double *estimates;    // Current tau of each slot
+    bool *used;           // Whether a slot holds a key
+    double total_abs_error; // Sum of |predicted - actual| over completed jobs
+    double total_rel_error; // Sum of |predicted - actual| / actual
+    int samples;          // Completed jobs that contributed to the errors
+} Predictor;
+
+/**
+ * Line reader over plain or gzip-compressed files
+ */
+typedef struct {
+#ifdef HAVE_ZLIB
+    gzFile gz;            // zlib reads plain files transparently too
+#else
+    FILE *file;
+#endif
+    long line_number;     // Lines consumed so far
+} TraceReader;
+
+/**
+ * Simple circular queue for RR scheduling
+ */
+typedef struct {
+    int *process_indices; // Array of process indices
+    int capacity;         // Maximum number of elements
+    int front;            // Index of front element
+    int rear;             // Index of rear element
+    int size;             // Current queue size
+} ReadyQueue;
+
+/**
+ * Decision log being written or compared by a run
+ */
+typedef struct {
+    FILE *file;
+    bool verify;          // Compare with an existing log instead of writing one
+    Process **occupant;   // Process each CPU ran after the previous step's dispatching
+    SimTime last_time;    // Time of the previous decision
+    long count;           // Decisions logged or compared
+    long mismatch;        // First decision that differs from the log (-1: none)
+    SimTime mismatch_time; // Time of that decision (-1: the log has more decisions)
+} DecisionLog;
+
+/**
+ * State of one simulated host, advanced one time unit at a time
+ */
+typedef struct {
+    Process *processes;   // Processes known to this host
+    int process_count;    // Number of processes (may grow while running)
+    int process_capacity; // Allocated size of processes
+    CPU *cpus;            // Processors
+    int cpu_count;        // Number of processors
+    Algorithm algorithm;  // Scheduling policy
+    SimTime time_quantum; // Quantum for RR
+    const SimOptions *options; // Optional features
+    ReadyQueue ready_queue_rr; // Ready queue for RR
+    int *arrived_indices; // Scratch buffer for handle_arrivals
+    Ssd ssd;              // Flash device (if options->ssd.enabled)
+    bool record_timeline; // Keep a per-tick timeline for display
+    int **timeline;       // timeline[t][cpu] = pid or -1
+    int timeline_capacity; // Allocated rows of timeline
+    SimTime current_time; // Next time unit to simulate
+    int completed_count;  // Processes finished so far
+    Predictor predictor;  // Burst predictor (if options->prediction.mode)
+    Process **running;    // Scratch: processes on CPUs before execution
+    Process **srtf_heap;  // Scratch: max-heap of running processes by remaining time
+    SimTime *saved_times; // Scratch: two values per process, kept by the one-tick adapter
+    SimTime *saved_cpu_times; // Scratch: busy and idle time per CPU, kept by the one-tick adapter
+    bool uses_locks;      // Whether any known process has critical sections
+    SimLock locks[MAX_LOCKS]; // Simulated mutexes
+    int blocked_count;    // Processes blocked on storage or locks, or throttled
+    bool uses_bandwidth;  // Whether any known process has a bandwidth limit
+    Bucket *buckets;      // Classes first (bucket id = class id), then per-process limits
+    int bucket_count;
+    RefillTimer *timers;  // Min-heap of refill times, at most one per bucket
+    int timer_count;
+    CpuPower *power;      // Per-CPU power state (if options->energy.policy)
+    NumaState *numa;      // NUMA model (if options->numa.nodes)
+    int online_cpus;      // CPUs the policy may use (a prefix of cpus)
+    int pressure_ticks;   // Consecutive ticks with more runnable processes than online idle cores
+    bool srtf_recheck;    // A process became runnable other than by arriving
+    PreemptionStats preemption; // SRTF check accounting
+    long arrived_count;   // Processes arrived so far
+    WindowStats window;   // Time-series export (if options->window.width)
+    bool event_steps;     // Advance from event to event rather than tick by tick
+    SimTime *arrival_times; // Arrival times in ascending order (event stepping)
+    int next_arrival;     // First entry of arrival_times still in the future
+    SimTime stop_time;    // Steps end here so the caller can act at this time (-1: none)
+    DecisionLog *decisions; // Decisions being recorded or verified (NULL: off)
+    long mlq_tickets;     // Next queued_at handed out by MLQ
+} Simulation;
+
+/**
+ * K configurations of one workload advanced together. Hot state is
+ * lane-interleaved (per process: field[i * lanes + k], per CPU slot:
+ * slot_field[c * lanes + k]) so the per-tick kernels touch K adjacent
+ * values at a time and vectorize across configurations.
+ */
+typedef struct {
+    const Process *processes; // Shared workload (static attributes only)
+    int process_count;
+    int lanes;            // Number of configurations (K)
+    Algorithm algorithm;  // Policy shared by all lanes
+    int cpu_counts[MAX_SWEEP_LANES]; // CPUs of each lane
+    int quanta[MAX_SWEEP_LANES];     // Quantum of each lane
+    int max_cpus;         // Largest cpu_counts entry
+    int *state;           // Per process, [i * lanes + k]
+    int *rank;            // Policy preference: -attained (LAS) or priority (PRIO)
+    int *remaining;       // Remaining burst (while not on a CPU)
+    int *start;
+    int *finish;
+    int *slot_process;    // Per CPU slot, [c * lanes + k]: process index or -1
+    int *slot_remaining;  // Remaining burst of the process on the slot
+    int *slot_quantum;    // Quantum used by the process on the slot
+    int *slot_rank;       // Rank of the process on the slot
+    int *lanes_done;      // Lanes in which each process has completed
+    long busy[MAX_SWEEP_LANES];      // Busy CPU ticks of each lane
+    long waiting[MAX_SWEEP_LANES];   // Total waiting time of each lane
+    int running[MAX_SWEEP_LANES];    // Occupied CPUs of each lane
+    int completed[MAX_SWEEP_LANES];  // Processes finished in each lane
+    int makespan[MAX_SWEEP_LANES];   // Finish time of each lane (-1 while running)
+    int waiting_rank[MAX_SWEEP_LANES]; // Best rank the last dispatch left waiting (INT_MIN: none)
+    int next_decision[MAX_SWEEP_LANES]; // First tick at which each lane may decide again
+    int *order;           // Process indices by arrival time (shared arrival processing)
+    int next_arrival;     // First entry of order that has not arrived
+    int *active;          // Arrived processes not yet completed in every lane, by arrival
+    int active_count;
+    bool retired;         // Some process completed in its last lane this tick
+    int current_time;
+} LaneBatch;
+
+/**
+ * Indexed binary min-heap of hosts keyed by jobs in system. Keys change by
+ * one at a time, so each update is a single sift in O(log H).
+ */
+typedef struct {
+    int *heap;            // Host ids, least loaded first
+    int *position;        // position[host] = index of host in heap
+    int *load;            // Jobs dispatched to a host and not yet completed
+    int size;             // Number of hosts
+} HostHeap;
+
+/**
+ * Routes each arriving job to a host. Every decision is O(1) or O(d):
+ * JSQ reads the heap minimum instead of scanning all hosts.
+ */
+typedef struct {
+    DispatchPolicy policy;
+    int host_count;
+    int choices;          // d for power-of-d-choices
+    int next_host;        // Round-robin cursor
+    unsigned int rng;     // xorshift state for randomized policies
+    HostHeap hosts;       // Per-host load
+} Dispatcher;
+
+/**
+ * Outcome of one what-if branch, sent from the child over a pipe
+ */
+typedef struct {
+    bool finished;        // All processes completed within the time limit
+    int completed;        // Processes completed
+    SimTime makespan;     // Time the last process finished
+    double avg_turnaround;
+    double avg_waiting;
+    double avg_response;
+    SimTime p99_turnaround;
+    double utilization;   // Mean CPU utilization in percent
+} WhatIfResult;
+
+/**
+ * Index entry of one chunk of a results store: where its columns start,
+ * how many rows it holds, and each column's range for pruning queries
+ */
+typedef struct {
+    int64_t offset;
+    int32_t rows;
+    int64_t min[NUM_RESULT_COLUMNS];
+    int64_t max[NUM_RESULT_COLUMNS];
+} ResultChunk;
+
+/**
+ * An open results store. Rows are buffered until a chunk is full; the
+ * key dictionary and the chunk index stay in memory and are rewritten
+ * after the last chunk when the store is closed.
+ */
+typedef struct {
+    FILE *file;
+    char **keys;          // Dictionary: keys[id] for encoded columns
+    int key_count;
+    int key_capacity;
+    ResultChunk *chunks;  // Index
+    int chunk_count;
+    int chunk_capacity;
+    int64_t *pending[NUM_RESULT_COLUMNS]; // Rows not yet written, by column
+    int pending_rows;
+    int64_t data_end;     // End of the last chunk (start of the footer)
+} ResultsStore;
+
+/************************* FUNCTION PROTOTYPES *************************/
+
+// Scheduling functions (scheduler.c), each called once per time unit
+void handle_arrivals(Process *processes, int process_count, int current_time, Algorithm algorithm, 
+                    int *arrived_indices, int *arrival_count);
+void handle_rr_quantum_expiry(Process *processes, CPU *cpus, int cpu_count, int time_quantum, 
+                             ReadyQueue *ready_queue, int current_time);
+void handle_srtf_preemption(Process *processes, int process_count, CPU *cpus, int cpu_count, int current_time);
+void assign_processes_to_idle_cpus(Process *processes, int process_count, CPU *cpus, int cpu_count, 
+                                 Algorithm algorithm, ReadyQueue *ready_queue, int current_time);
+void execute_processes(Process *processes, int process_count, CPU *cpus, int cpu_count, 
+                      int current_time, int *completed_count);
+void update_waiting_times(Process *processes, int process_count, int current_time);
+
+// File operations
+void init_process(Process *p, int pid, SimTime arrival, SimTime burst, int priority);
+void load_processes(const char *filename, Process **processes_ptr, int *count, bool quiet);
+void load_trace(const char *filename, const TraceOptions *trace, Process **processes_ptr, int *count,
+                bool quiet);
+bool trace_open(TraceReader *reader, const char *filename);
+bool trace_read_line(TraceReader *reader, char *line, int size);
+void trace_close(TraceReader *reader);
+
+// Scheduling functions
+void simulate(Process *processes, int process_count, int cpu_count, Algorithm algorithm, SimTime time_quantum,
+              const SimOptions *options);
+void sim_init(Simulation *sim, Process *processes, int process_count, int process_capacity, int cpu_count,
+              Algorithm algorithm, SimTime time_quantum, const SimOptions *options, bool record_timeline);
+void sim_add_process(Simulation *sim, const Process *p);
+bool sim_step(Simulation *sim);
+void sim_cleanup(Simulation *sim);
+SimTime sim_time_limit(const Process *processes, int process_count);
+bool sim_run_quietly(Simulation *sim);
+
+// Burst prediction
+void predictor_init(Predictor *pred, const PredictionOptions *options, int process_capacity);
+void predictor_reserve(Predictor *pred, int process_capacity);
+SimTime predictor_estimate(Predictor *pred, const Process *p);
+void predictor_learn(Predictor *pred, const Process *p);
+void predictor_cleanup(Predictor *pred);
+SimTime job_size_estimate(const Process *p);
+SimTime remaining_estimate(const Process *p);
+void print_prediction_report(const Predictor *pred, Process *predicted, Process *oracle, int process_count);
+
+// What-if branching
+void sim_switch_policy(Simulation *sim, Algorithm algorithm, SimTime time_quantum);
+void simulate_whatif(Process *processes, int process_count, int cpu_count, Algorithm algorithm,
+                     SimTime time_quantum, const SimOptions *options);
+
+// Kernel validation
+void simulate_validate(Process *processes, int process_count, int cpu_count, Algorithm algorithm,
+                       SimTime time_quantum, const SimOptions *options);
+
+// Lockstep sweeps
+void lanes_init(LaneBatch *b, const Process *processes, int process_count, Algorithm algorithm,
+                const int *cpu_counts, const int *quanta, int lanes);
+bool lanes_run(LaneBatch *b);
+void lanes_cleanup(LaneBatch *b);
+void simulate_sweep(Process *processes, int process_count, int cpu_count, Algorithm algorithm,
+                    SimTime time_quantum, const SimOptions *options);
+
+// Results store
+void results_open(ResultsStore *s, const char *path);
+int results_key(ResultsStore *s, const char *key);
+void results_append(ResultsStore *s, const int64_t *row);
+void results_append_process(ResultsStore *s, const int64_t *config, const Process *p, SimTime start,
+                            SimTime finish);
+void results_close(ResultsStore *s);
+void results_query(const ResultsOptions *options);
+int result_column_lookup(const char *name);
+
+// Work queue
+void work_queue_init(WorkQueue *q, size_t capacity);
+bool work_queue_push(WorkQueue *q, int value);
+bool work_queue_pop(WorkQueue *q, int *value);
+void work_queue_free(WorkQueue *q);
+void queue_bench(int max_threads);
+
+// Batch mode
+void simulate_batch(Algorithm algorithm, int cpu_count, SimTime time_quantum, const SimOptions *options);
+TraceFormat infer_trace_format(const char *filename, TraceFormat fallback);
+
+// Cluster simulation
+void simulate_cluster(Process *processes, int process_count, int cpu_count, Algorithm algorithm,
+                      SimTime time_quantum, const SimOptions *options);
+void dispatcher_init(Dispatcher *d, const ClusterOptions *cluster);
+int dispatcher_pick(Dispatcher *d);
+void dispatcher_adjust(Dispatcher *d, int host, int delta);
+void dispatcher_cleanup(Dispatcher *d);
+bool srtf_preemption_possible(Simulation *sim, int arrival_count);
+void print_preemption_stats(const Simulation *sim);
+void handle_las_scheduling(Process *processes, int process_count, CPU *cpus, int cpu_count, SimTime time_quantum,
+                           int arrival_count, SimTime current_time);
+int handle_io_completions(Process *processes, int process_count, SimTime current_time, Algorithm algorithm,
+                          ReadyQueue *ready_queue);
+int handle_io_requests(Process *processes, CPU *cpus, int cpu_count, Ssd *ssd, SimTime now);
+void handle_priority_scheduling(Process *processes, int process_count, CPU *cpus, int cpu_count,
+                                SimTime current_time);
+
+// Power and energy
+void energy_update_online(Simulation *sim);
+void energy_before_execute(Simulation *sim);
+void energy_after_execute(Simulation *sim);
+void print_energy_stats(const Simulation *sim, SimTime total_time);
+const char* energy_policy_name(EnergyPolicy policy);
+
+// NUMA model
+void numa_init(Simulation *sim);
+void numa_cleanup(Simulation *sim);
+void numa_place(Simulation *sim);
+void numa_before_execute(Simulation *sim);
+void numa_after_execute(Simulation *sim);
+void print_numa_stats(const Simulation *sim);
+const char* numa_policy_name(NumaPolicy policy);
+
+// CPU bandwidth control
+void bandwidth_register_process(Simulation *sim, Process *p);
+int handle_bandwidth_refills(Simulation *sim);
+int handle_throttled_arrivals(Simulation *sim, int *arrival_count);
+int handle_throttled_dispatch(Simulation *sim);
+int charge_bandwidth(Simulation *sim, SimTime elapsed);
+void print_bandwidth_stats(const Simulation *sim);
+bool parse_cpu_max(const char *spec, SimTime *quota, SimTime *period);
+
+// Multi-level queue
+bool parse_mlq_levels(const char *spec, MlqOptions *mlq);
+void handle_mlq_scheduling(Simulation *sim, SimTime current_time);
+void print_mlq_stats(const Simulation *sim);
+
+// Shared locks
+void lock_register_process(Simulation *sim, const Process *p);
+int handle_lock_acquires(Simulation *sim);
+int handle_lock_releases(Simulation *sim);
+void account_lock_waits(Simulation *sim, SimTime elapsed);
+void print_lock_stats(const Simulation *sim);
+
+// Checkpoints and incremental re-runs
+void checkpoint_read_config(const char *path, Algorithm *algorithm, int *cpu_count, SimTime *time_quantum,
+                            SimOptions *options);
+void checkpoint_check_support(const SimOptions *options, Algorithm algorithm, const Process *processes,
+                              int process_count);
+void checkpoint_open(CheckpointWriter *w, const char *path, const Simulation *sim, SimTime interval);
+void checkpoint_write(CheckpointWriter *w, Simulation *sim);
+void checkpoint_close(CheckpointWriter *w, const char *path);
+SimTime checkpoint_resume(Simulation *sim, const char *path, CheckpointWriter *w);
+SimTime workload_first_change(const Process *base, int base_count, const Process *edited, int edited_count);
+
+// Decision log
+void decision_log_open(DecisionLog *log, const char *path, bool verify, const Simulation *sim);
+void decision_log_step(DecisionLog *log, Simulation *sim);
+void decision_log_close(DecisionLog *log, const char *path);
+void simulate_replay(Process *processes, int process_count, const SimOptions *options);
+
+// Time-series metrics
+void window_open(WindowStats *w, const WindowOptions *options, int cpu_count);
+void window_record_response(WindowStats *w, SimTime response_time);
+void window_end_tick(WindowStats *w, SimTime current_time, SimTime elapsed, int queue_during, int queue_length);
+void window_close(WindowStats *w, SimTime end_time);
+
+// Flash storage model
+void ssd_init(Ssd *ssd, const SsdConfig *cfg);
+SimTime ssd_write(Ssd *ssd, int lpn, SimTime now);
+void ssd_cleanup(Ssd *ssd);
+void print_storage_stats(const Ssd *ssd, Process *processes, int process_count);
+
+// Output and visualization
+void print_results(Process *processes, int process_count, CPU *cpus, int cpu_count, int **timeline, SimTime total_time);
+void print_timeline(int **timeline, SimTime total_time, Process *processes, int process_count, int cpu_count);
+void print_process_stats(Process *processes, int process_count);
+void print_cpu_stats(CPU *cpus, int cpu_count);
+void print_average_stats(Process *processes, int process_count);
+void print_csv_output(Process *processes, int process_count, CPU *cpus, int cpu_count);
+void summarize_processes(const Process *processes, int process_count, double *avg_turnaround,
+                         double *avg_waiting, double *avg_response, SimTime *p99_turnaround);
+void print_cluster_results(Simulation *hosts, int host_count, const double *queue_area, const int *peak_load,
+                           SimTime total_time);
+
+// Queue operations
+void init_queue(ReadyQueue *q, int capacity);
+void free_queue(ReadyQueue *q);
+void grow_queue(ReadyQueue *q, int capacity);
+void enqueue(ReadyQueue *q, int process_idx);
+int dequeue(ReadyQueue *q);
+
+// Timeline management
+void init_timeline(int ***timeline_ptr, int capacity, int cpu_count);
+void expand_timeline(int ***timeline_ptr, int *capacity_ptr, int new_capacity, int cpu_count);
+void cleanup_timeline(int **timeline, int capacity);
+
+// Helper functions
+const char* get_color_for_pid(int pid);
+const char* algorithm_name(Algorithm algorithm);
+const char* dispatch_name(DispatchPolicy policy);
+const char* lock_protocol_name(LockProtocol protocol);
+unsigned int xorshift32(unsigned int *state);
+int class_lookup(const char *name);
+const char* class_name(int class_id);
+void parse_arguments(int argc, char *argv[], Algorithm *algorithm, int *cpu_count, 
+                    SimTime *time_quantum, char **input_file, SimOptions *options);
+void parse_ssd_spec(const char *spec, SsdConfig *cfg);
+void parse_csv_map(const char *spec, TraceOptions *trace);
+bool parse_algorithm(const char *name, Algorithm *algorithm);
+void parse_process_attributes(char *line, Process *p);
+SimTime percentile(SimTime *values, int count, double pct);
+int parse_int_list(const char *spec, int *values, int max_values);
+bool parse_result_filter(const char *spec, ResultFilter *filter);
+bool parse_time(const char *text, SimTime *value);
+bool parse_int(const char *text, int *value);
+
+#endif // SCHEDULER_H
@@ -0,0 +1,7582 @@
+/**
+ * CPU Scheduler Simulator
+ *
+ * Simulates multiple CPU scheduling algorithms:
+ * - First-Come, First-Served (FCFS)
+ * - Round Robin (RR)
+ * - Shortest Remaining Time First (SRTF)
+ * - Shortest Job First (SJF)
+ * - Least Attained Service / foreground-background (LAS)
+ * - Preemptive fixed priority (PRIO)
+ * - Multi-level queue of workload classes, each with its own policy (MLQ)
+ * 
+ * Features:
+ * - Multiple CPU support
+ * - Visual timeline of execution
+ * - Process and CPU statistics
+ * - CSV output for automated testing
+ * - Optional flash storage (SSD) model for I/O-bound processes
+ * - Streaming import of SWF and CSV cluster traces
+ * - Multi-host cluster simulation with pluggable dispatchers
+ * - Burst prediction by exponential averaging for size-based policies
+ * - Fork-based what-if branching of a running simulation
+ * - Shared locks with priority inheritance and priority ceiling protocols
+ * - Windowed time-series metrics export (CSV or binary)
+ * - Lockstep parameter sweeps over quantum and CPU count
+ * - CPU bandwidth limits (cgroup cpu.max style quota/period throttling)
+ * - DVFS, idle states and energy-aware policies with energy reporting
+ * - NUMA nodes with home-node placement, balancing and remote-access slowdown
+ * - Event-triggered SRTF preemption checks with optional hysteresis
+ * - Columnar binary results store with an indexed query mode
+ * - Validation against real Linux processes under the matching kernel policy
+ * - Batch runs over a directory of workloads on a pool of worker threads
+ *   fed by a lock-free work queue (see --queue-bench)
+ *
+ * This file is the simulator itself. The scheduling functions it calls
+ * live in scheduler.c (see ONE-TICK ADAPTER). Build both with make; add
+ * -DHAVE_ZLIB ... -lz to read gzip-compressed traces.
+ */
+
+#include "scheduler.h"
+
+/************************* CONSTANTS & DEFINITIONS *************************/
+
+const char *PROCESS_COLORS[] = {
+    COLOR_RED, COLOR_GREEN, COLOR_YELLOW, COLOR_BLUE,
+    COLOR_MAGENTA, COLOR_CYAN, COLOR_WHITE
+};
+#define NUM_PROCESS_COLORS (sizeof(PROCESS_COLORS) / sizeof(PROCESS_COLORS[0]))
+
+char CLASS_NAMES[MAX_CLASSES][MAX_CLASS_NAME] = { "default" };
+int CLASS_COUNT = 1;
+pthread_mutex_t CLASS_LOCK = PTHREAD_MUTEX_INITIALIZER;
+
+long long TICK_NS = 1000000;
+
+const char *RESULT_COLUMN_NAMES[NUM_RESULT_COLUMNS] = {
+    "workload", "algorithm", "cpus", "quantum", "pid", "arrival", "burst", "priority",
+    "start", "finish", "turnaround", "waiting", "response"
+};
+const char *ALGORITHM_KEYS[] = { "FCFS", "RR", "SRTF", "SJF", "LAS", "PRIO", "MLQ" };
+
+const FreqLevel FREQ_LEVELS[NUM_FREQ_LEVELS] = {
+    { 1200, 2.0 }, { 2000, 4.5 }, { 3000, 10.0 }
+};
+
+const IdleState IDLE_STATES[NUM_IDLE_STATES] = {
+    { "POLL", 1.5, 0, 0 }, { "C1", 0.8, 1, 2 }, { "C6", 0.1, 4, 20 }
+};
+
+/************************* QUEUE OPERATIONS *************************/
+
+/**
+ * Initialize a ready queue able to hold capacity process indices
+ */
+void init_queue(ReadyQueue *q, int capacity) {
+    q->process_indices = (int *)malloc(capacity * sizeof(int));
+    if (!q->process_indices) {
+        perror("Failed to allocate ready queue");
+        exit(EXIT_FAILURE);
+    }
+    q->capacity = capacity;
+    q->front = 0;
+    q->rear = -1;
+    q->size = 0;
+}
+
+/**
+ * Enlarge a ready queue to capacity entries, keeping its contents in order
+ */
+void grow_queue(ReadyQueue *q, int capacity) {
+    int *indices = (int *)malloc(capacity * sizeof(int));
+    if (!indices) {
+        perror("Failed to allocate ready queue");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < q->size; i++) indices[i] = q->process_indices[(q->front + i) % q->capacity];
+    free(q->process_indices);
+    q->process_indices = indices;
+    q->capacity = capacity;
+    q->front = 0;
+    q->rear = q->size - 1;
+}
+
+/**
+ * Add a process index to the ready queue
+ */
+void enqueue(ReadyQueue *q, int process_idx) {
+    if (q->size >= q->capacity) {
+        fprintf(stderr, "Error: Ready queue overflow!\n");
+        return;
+    }
+    q->rear = (q->rear + 1) % q->capacity;
+    q->process_indices[q->rear] = process_idx;
+    q->size++;
+}
+
+/**
+ * Remove and return the next process index from the ready queue
+ * Returns -1 if queue is empty
+ */
+int dequeue(ReadyQueue *q) {
+    if (q->size <= 0) return -1; // Queue empty
+    int process_idx = q->process_indices[q->front];
+    q->front = (q->front + 1) % q->capacity;
+    q->size--;
+    return process_idx;
+}
+
+/**
+ * Release the storage of a ready queue
+ */
+void free_queue(ReadyQueue *q) {
+    free(q->process_indices);
+    q->process_indices = NULL;
+    q->capacity = 0;
+}
+
+/************************* TIMELINE MANAGEMENT *************************/
+
+/**
+ * Initialize the simulation timeline data structure
+ */
+void init_timeline(int ***timeline_ptr, int capacity, int cpu_count) {
+    *timeline_ptr = (int **)malloc(capacity * sizeof(int *));
+    if (!(*timeline_ptr)) {
+        perror("Failed to allocate timeline");
+        exit(EXIT_FAILURE);
+    }
+    
+    for (int t = 0; t < capacity; t++) {
+        (*timeline_ptr)[t] = (int *)malloc(cpu_count * sizeof(int));
+        if (!(*timeline_ptr)[t]) {
+            perror("Failed to allocate timeline row");
+            // Clean up already allocated rows
+            for (int k = 0; k < t; k++) free((*timeline_ptr)[k]);
+            free(*timeline_ptr);
+            exit(EXIT_FAILURE);
+        }
+        for (int c = 0; c < cpu_count; c++) {
+            (*timeline_ptr)[t][c] = -1; // -1 indicates idle
+        }
+    }
+}
+
+/**
+ * Expand timeline capacity when needed
+ */
+void expand_timeline(int ***timeline_ptr, int *capacity_ptr, int new_capacity, int cpu_count) {
+    int **temp = (int **)realloc(*timeline_ptr, new_capacity * sizeof(int *));
+    if (!temp) {
+        perror("Failed to expand timeline");
+        exit(EXIT_FAILURE);
+    }
+    *timeline_ptr = temp;
+
+    for (int t = *capacity_ptr; t < new_capacity; t++) {
+        (*timeline_ptr)[t] = (int *)malloc(cpu_count * sizeof(int));
+        if (!(*timeline_ptr)[t]) {
+            perror("Failed to allocate new timeline row during expansion");
+            exit(EXIT_FAILURE);
+        }
+        for (int c = 0; c < cpu_count; c++) {
+            (*timeline_ptr)[t][c] = -1;
+        }
+    }
+    *capacity_ptr = new_capacity;
+}
+
+/**
+ * Clean up the timeline data structure
+ */
+void cleanup_timeline(int **timeline, int capacity) {
+    if (timeline) {
+        for (int t = 0; t < capacity; t++) {
+            free(timeline[t]);
+        }
+        free(timeline);
+    }
+}
+
+/************************* FLASH STORAGE MODEL *************************/
+
+/**
+ * Take an erased block off the free stack and make it the write frontier
+ */
+static void ssd_open_block(Ssd *ssd) {
+    if (ssd->free_count == 0) {
+        fprintf(stderr, "Error: SSD ran out of free blocks!\n");
+        exit(EXIT_FAILURE);
+    }
+    ssd->active_block = ssd->free_blocks[--ssd->free_count];
+}
+
+/**
+ * Write a logical page out of place: invalidate the old copy and append
+ * the new one to the active block
+ */
+static void ssd_program(Ssd *ssd, int lpn, SimTime now) {
+    int ppb = ssd->cfg.pages_per_block;
+
+    int old = ssd->l2p[lpn];
+    if (old != -1) {
+        ssd->blocks[old / ppb].valid_pages--;
+        ssd->p2l[old] = -1;
+    }
+
+    if (ssd->active_block == -1 || ssd->blocks[ssd->active_block].next_page == ppb) {
+        ssd_open_block(ssd);
+    }
+    FlashBlock *b = &ssd->blocks[ssd->active_block];
+    int ppn = ssd->active_block * ppb + b->next_page++;
+    ssd->l2p[lpn] = ppn;
+    ssd->p2l[ppn] = lpn;
+    b->valid_pages++;
+    b->last_write = now;
+    ssd->flash_writes++;
+}
+
+/**
+ * Pick the full block that GC should reclaim next, or -1 if none qualifies
+ */
+static int ssd_select_victim(const Ssd *ssd, SimTime now) {
+    int ppb = ssd->cfg.pages_per_block;
+    int victim = -1;
+    double best_score = -1.0;
+
+    for (int i = 0; i < ssd->cfg.blocks; i++) {
+        const FlashBlock *b = &ssd->blocks[i];
+        if (i == ssd->active_block || b->next_page < ppb || b->valid_pages == ppb) continue;
+
+        double score;
+        if (ssd->cfg.gc_policy == GC_GREEDY) {
+            score = ppb - b->valid_pages;
+        } else {
+            double u = (double)b->valid_pages / ppb;
+            double age = (double)(now - b->last_write + 1);
+            score = (1.0 - u) * age / (1.0 + u);
+        }
+        if (score > best_score) {
+            best_score = score;
+            victim = i;
+        }
+    }
+    return victim;
+}
+
+/**
+ * Reclaim one block: relocate its valid pages and erase it.
+ * Returns the ticks spent, or -1 if no block can be reclaimed.
+ */
+static int ssd_collect(Ssd *ssd, SimTime now) {
+    int victim = ssd_select_victim(ssd, now);
+    if (victim == -1) return -1;
+
+    int ppb = ssd->cfg.pages_per_block;
+    int cost = 0;
+    for (int ppn = victim * ppb; ppn < (victim + 1) * ppb; ppn++) {
+        if (ssd->p2l[ppn] != -1) {
+            ssd_program(ssd, ssd->p2l[ppn], now);
+            cost += ssd->cfg.read_latency + ssd->cfg.program_latency;
+        }
+    }
+
+    FlashBlock *b = &ssd->blocks[victim];
+    b->next_page = 0;
+    b->erase_count++;
+    ssd->free_blocks[ssd->free_count++] = victim;
+    ssd->gc_runs++;
+    return cost + ssd->cfg.erase_latency;
+}
+
+/**
+ * Build an empty device from its configuration and apply the prefill
+ */
+void ssd_init(Ssd *ssd, const SsdConfig *cfg) {
+    memset(ssd, 0, sizeof(*ssd));
+    ssd->cfg = *cfg;
+
+    int physical_pages = cfg->blocks * cfg->pages_per_block;
+    ssd->logical_pages = (int)((int64_t)physical_pages * (100 - cfg->op_percent) / 100);
+    // GC needs at least its free-block reserve plus the active block to make progress
+    int max_logical = (cfg->blocks - cfg->gc_free_blocks - 1) * cfg->pages_per_block;
+    if (ssd->logical_pages > max_logical) ssd->logical_pages = max_logical;
+    if (ssd->logical_pages <= 0) {
+        fprintf(stderr, "Error: SSD too small for its over-provisioning and GC reserve\n");
+        exit(EXIT_FAILURE);
+    }
+
+    ssd->l2p = (int *)malloc(ssd->logical_pages * sizeof(int));
+    ssd->p2l = (int *)malloc(physical_pages * sizeof(int));
+    ssd->blocks = (FlashBlock *)calloc(cfg->blocks, sizeof(FlashBlock));
+    ssd->free_blocks = (int *)malloc(cfg->blocks * sizeof(int));
+    if (!ssd->l2p || !ssd->p2l || !ssd->blocks || !ssd->free_blocks) {
+        perror("Failed to allocate SSD");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < ssd->logical_pages; i++) ssd->l2p[i] = -1;
+    for (int i = 0; i < physical_pages; i++) ssd->p2l[i] = -1;
+    for (int i = cfg->blocks - 1; i >= 0; i--) ssd->free_blocks[ssd->free_count++] = i;
+    ssd->active_block = -1;
+    ssd->rng = 2463534242u;
+
+    // Age the device so GC is active from the start, then forget the setup traffic
+    int prefill = (int)((long)ssd->logical_pages * cfg->prefill_percent / 100);
+    for (int lpn = 0; lpn < prefill; lpn++) {
+        ssd_program(ssd, lpn, 0);
+    }
+    ssd->flash_writes = 0;
+}
+
+/**
+ * Submit a one-page write at time now. GC runs in the foreground when the
+ * free pool is low, so its cost lands on this request and on everyone queued
+ * behind it. Returns the completion time.
+ */
+SimTime ssd_write(Ssd *ssd, int lpn, SimTime now) {
+    SimTime start = (now > ssd->busy_until) ? now : ssd->busy_until;
+    int cost = 0;
+
+    while (ssd->free_count < ssd->cfg.gc_free_blocks) {
+        int gc_cost = ssd_collect(ssd, start);
+        if (gc_cost < 0) break;
+        cost += gc_cost;
+    }
+    ssd_program(ssd, lpn, start);
+    cost += ssd->cfg.program_latency;
+    ssd->host_writes++;
+
+    ssd->busy_until = start + cost;
+
+    if (ssd->latency_count >= ssd->latency_capacity) {
+        int new_capacity = ssd->latency_capacity ? ssd->latency_capacity * 2 : 256;
+        SimTime *temp = (SimTime *)realloc(ssd->latencies, new_capacity * sizeof(SimTime));
+        if (!temp) {
+            perror("Failed to grow SSD latency log");
+            exit(EXIT_FAILURE);
+        }
+        ssd->latencies = temp;
+        ssd->latency_capacity = new_capacity;
+    }
+    ssd->latencies[ssd->latency_count++] = ssd->busy_until - now;
+
+    return ssd->busy_until;
+}
+
+/**
+ * Release all memory owned by the device
+ */
+void ssd_cleanup(Ssd *ssd) {
+    free(ssd->l2p);
+    free(ssd->p2l);
+    free(ssd->blocks);
+    free(ssd->free_blocks);
+    free(ssd->latencies);
+}
+
+/************************* HELPER FUNCTIONS *************************/
+
+/**
+ * Get a color code for a process ID for colorized output
+ */
+const char* get_color_for_pid(int pid) {
+    if (pid < 0) return COLOR_RESET; // Idle
+    return PROCESS_COLORS[pid % NUM_PROCESS_COLORS];
+}
+
+/**
+ * Get the algorithm name as a string
+ */
+const char* algorithm_name(Algorithm algorithm) {
+    switch (algorithm) {
+        case FCFS: return "First-Come, First-Served";
+        case RR:   return "Round Robin";
+        case SRTF: return "Shortest Remaining Time First";
+        case SJF:  return "Shortest Job First";
+        case LAS:  return "Least Attained Service";
+        case PRIO: return "Preemptive Priority";
+        case MLQ:  return "Multi-Level Queue";
+        default:   return "Unknown Algorithm";
+    }
+}
+
+/**
+ * Comparison function for sorting times in ascending order with qsort
+ */
+static int compare_times_ascending(const void *a, const void *b) {
+    SimTime x = *(const SimTime *)a, y = *(const SimTime *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Return the pct-th percentile (0-100) of values using nearest rank.
+ * Sorts values in place. Returns -1 for an empty array.
+ */
+SimTime percentile(SimTime *values, int count, double pct) {
+    if (count <= 0) return -1;
+    qsort(values, count, sizeof(SimTime), compare_times_ascending);
+    int rank = (int)(pct / 100.0 * count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return values[rank - 1];
+}
+
+/**
+ * Parse a whole decimal number that fits in an int, with nothing after it
+ */
+bool parse_int(const char *text, int *value) {
+    char *end;
+    errno = 0;
+    long amount = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || amount < INT_MIN || amount > INT_MAX) return false;
+    *value = (int)amount;
+    return true;
+}
+
+/**
+ * Parse a time: a tick count, or a number with an ns/us/ms/s suffix that is
+ * converted to ticks of TICK_NS (rounding up, so a nonzero time stays nonzero)
+ */
+bool parse_time(const char *text, SimTime *value) {
+    static const struct { const char *suffix; long long ns; } UNITS[] = {
+        { "ns", 1LL }, { "us", 1000LL }, { "ms", 1000000LL }, { "s", 1000000000LL }
+    };
+    char *end;
+    errno = 0;
+    long long amount = strtoll(text, &end, 10);
+    if (end == text || errno == ERANGE || amount < 0) return false;
+    if (*end == '\0') {
+        *value = amount;
+        return true;
+    }
+    for (size_t u = 0; u < sizeof(UNITS) / sizeof(UNITS[0]); u++) {
+        if (strcmp(end, UNITS[u].suffix) != 0) continue;
+        if (amount > LLONG_MAX / UNITS[u].ns) return false;
+        long long ns = amount * UNITS[u].ns;
+        *value = ns / TICK_NS + (ns % TICK_NS != 0);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Parse a bandwidth limit of the form QUOTA/PERIOD (both positive times)
+ */
+bool parse_cpu_max(const char *spec, SimTime *quota, SimTime *period) {
+    char buffer[MAX_LINE_LENGTH];
+    strncpy(buffer, spec, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+    char *slash = strchr(buffer, '/');
+    if (!slash) return false;
+    *slash = '\0';
+
+    SimTime q, p;
+    if (!parse_time(buffer, &q) || !parse_time(slash + 1, &p) || q <= 0 || p <= 0) return false;
+    *quota = q;
+    *period = p;
+    return true;
+}
+
+/**
+ * Parse multi-level queue levels of the form CLASS=POLICY[:QUANTUM][@SLICE],
+ * highest priority first, appending them to mlq. POLICY is RR, FCFS or SJF;
+ * a quantum applies to RR only.
+ */
+bool parse_mlq_levels(const char *spec, MlqOptions *mlq) {
+    char buffer[MAX_LINE_LENGTH];
+    strncpy(buffer, spec, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+
+    for (char *item = strtok(buffer, ","); item; item = strtok(NULL, ",")) {
+        char *policy = strchr(item, '=');
+        if (!policy || mlq->level_count == MAX_CLASSES) return false;
+        *policy++ = '\0';
+        char *slice = strchr(policy, '@');
+        if (slice) *slice++ = '\0';
+        char *quantum = strchr(policy, ':');
+        if (quantum) *quantum++ = '\0';
+
+        int level = mlq->level_count;
+        if (strcmp(policy, "RR") == 0) mlq->policies[level] = RR;
+        else if (strcmp(policy, "FCFS") == 0 && !quantum) mlq->policies[level] = FCFS;
+        else if (strcmp(policy, "SJF") == 0 && !quantum) mlq->policies[level] = SJF;
+        else return false;
+        mlq->quanta[level] = 0;
+        if (quantum && (!parse_time(quantum, &mlq->quanta[level]) || mlq->quanta[level] <= 0)) return false;
+        mlq->slices[level] = DEFAULT_MLQ_SLICE;
+        if (slice && (!parse_time(slice, &mlq->slices[level]) || mlq->slices[level] <= 0)) return false;
+
+        int class_id = class_lookup(item);
+        for (int l = 0; l < level; l++) {
+            if (mlq->classes[l] == class_id) return false;
+        }
+        mlq->classes[level] = class_id;
+        mlq->level_count++;
+    }
+    return true;
+}
+
+/**
+ * Parse a comma-separated list of positive integers into values.
+ * Returns the number of values; exits on a malformed or overlong list.
+ */
+int parse_int_list(const char *spec, int *values, int max_values) {
+    char buffer[MAX_LINE_LENGTH];
+    strncpy(buffer, spec, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+
+    int count = 0;
+    for (char *item = strtok(buffer, ","); item; item = strtok(NULL, ",")) {
+        int value;
+        if (!parse_int(item, &value) || value <= 0 || count == max_values) {
+            fprintf(stderr, "Error: Invalid list '%s' (at most %d positive values)\n", spec, max_values);
+            exit(EXIT_FAILURE);
+        }
+        values[count++] = value;
+    }
+    return count;
+}
+
+/**
+ * Parse a query filter such as "algorithm=RR" or "cpus>=4"
+ */
+bool parse_result_filter(const char *spec, ResultFilter *filter) {
+    static const struct { const char *text; FilterOp op; } OPS[] = {
+        { "!=", FILTER_NE }, { "<=", FILTER_LE }, { ">=", FILTER_GE },
+        { "=", FILTER_EQ }, { "<", FILTER_LT }, { ">", FILTER_GT }
+    };
+    size_t split = strcspn(spec, "!<>=");
+    if (split == 0 || split >= MAX_LINE_LENGTH || spec[split] == '\0') return false;
+
+    char name[MAX_LINE_LENGTH];
+    memcpy(name, spec, split);
+    name[split] = '\0';
+    filter->column = result_column_lookup(name);
+    if (filter->column < 0) return false;
+
+    for (size_t o = 0; o < sizeof(OPS) / sizeof(OPS[0]); o++) {
+        size_t length = strlen(OPS[o].text);
+        if (strncmp(spec + split, OPS[o].text, length) == 0) {
+            filter->op = OPS[o].op;
+            filter->value = spec + split + length;
+            return *filter->value != '\0';
+        }
+    }
+    return false;
+}
+
+/**
+ * Parse a flash device specification of the form key=value[,key=value...]
+ *
+ * Keys: blocks, ppb (pages per block), op (over-provisioning %),
+ *       prefill (% of logical space), gcfree (free-block watermark),
+ *       gc (greedy|cb), read, prog, erase (latencies in ticks).
+ * "default" selects the defaults.
+ */
+void parse_ssd_spec(const char *spec, SsdConfig *cfg) {
+    cfg->enabled = true;
+    if (strcmp(spec, "default") == 0) return;
+
+    char buffer[MAX_LINE_LENGTH];
+    strncpy(buffer, spec, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+
+    for (char *item = strtok(buffer, ","); item; item = strtok(NULL, ",")) {
+        char *value = strchr(item, '=');
+        if (!value) {
+            fprintf(stderr, "Error: Bad SSD option '%s' (expected key=value)\n", item);
+            exit(EXIT_FAILURE);
+        }
+        *value++ = '\0';
+        if (strcmp(item, "gc") == 0) {
+            if (strcmp(value, "greedy") == 0) cfg->gc_policy = GC_GREEDY;
+            else if (strcmp(value, "cb") == 0) cfg->gc_policy = GC_COST_BENEFIT;
+            else {
+                fprintf(stderr, "Error: Unknown GC policy '%s' (use greedy or cb)\n", value);
+                exit(EXIT_FAILURE);
+            }
+            continue;
+        }
+
+        int n;
+        if (!parse_int(value, &n)) {
+            fprintf(stderr, "Error: Bad SSD value '%s' for %s (expected a whole number)\n", value, item);
+            exit(EXIT_FAILURE);
+        }
+        if (strcmp(item, "blocks") == 0) cfg->blocks = n;
+        else if (strcmp(item, "ppb") == 0) cfg->pages_per_block = n;
+        else if (strcmp(item, "op") == 0) cfg->op_percent = n;
+        else if (strcmp(item, "prefill") == 0) cfg->prefill_percent = n;
+        else if (strcmp(item, "gcfree") == 0) cfg->gc_free_blocks = n;
+        else if (strcmp(item, "read") == 0) cfg->read_latency = n;
+        else if (strcmp(item, "prog") == 0) cfg->program_latency = n;
+        else if (strcmp(item, "erase") == 0) cfg->erase_latency = n;
+        else {
+            fprintf(stderr, "Error: Unknown SSD option '%s'\n", item);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (cfg->blocks < 4 || cfg->pages_per_block < 1 || cfg->op_percent < 0 || cfg->op_percent > 90 ||
+        cfg->prefill_percent < 0 || cfg->prefill_percent > 100 || cfg->gc_free_blocks < 1 ||
+        cfg->read_latency < 0 || cfg->program_latency < 0 || cfg->erase_latency < 0 ||
+        (int64_t)cfg->blocks * cfg->pages_per_block > INT_MAX) {
+        fprintf(stderr, "Error: Invalid SSD configuration '%s'\n", spec);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Parse a CSV column mapping of the form field=column[,field=column...]
+ *
+ * Fields: pid, arrival, burst, priority (1-based column numbers);
+ *         sep (separator character, "tab" for \\t), skip (header lines).
+ * arrival and burst are required; without pid, records are numbered from 1.
+ */
+void parse_csv_map(const char *spec, TraceOptions *trace) {
+    char buffer[MAX_LINE_LENGTH];
+    strncpy(buffer, spec, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+
+    trace->format = FORMAT_CSV;
+    for (char *item = strtok(buffer, ","); item; item = strtok(NULL, ",")) {
+        char *value = strchr(item, '=');
+        if (!value) {
+            fprintf(stderr, "Error: Bad CSV mapping '%s' (expected field=column)\n", item);
+            exit(EXIT_FAILURE);
+        }
+        *value++ = '\0';
+        if (strcmp(item, "sep") == 0) {
+            trace->separator = (strcmp(value, "tab") == 0) ? '\t' : value[0];
+        } else if (strcmp(item, "skip") == 0) {
+            if (!parse_int(value, &trace->skip_lines) || trace->skip_lines < 0) {
+                fprintf(stderr, "Error: Bad CSV skip count '%s' (expected a whole number)\n", value);
+                exit(EXIT_FAILURE);
+            }
+        } else {
+            int *column = NULL;
+            if (strcmp(item, "pid") == 0) column = &trace->pid_column;
+            else if (strcmp(item, "arrival") == 0) column = &trace->arrival_column;
+            else if (strcmp(item, "burst") == 0) column = &trace->burst_column;
+            else if (strcmp(item, "priority") == 0) column = &trace->priority_column;
+            else {
+                fprintf(stderr, "Error: Unknown CSV field '%s'\n", item);
+                exit(EXIT_FAILURE);
+            }
+            if (!parse_int(value, column) || *column < 1) {
+                fprintf(stderr, "Error: Bad CSV column '%s' for %s (expected a column number from 1)\n", value, item);
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+}
+
+/**
+ * Print command line usage
+ */
+static void print_usage(const char *program) {
+    fprintf(stderr, "Usage: %s -f <file> [-a <FCFS|RR|SRTF|SJF|LAS|PRIO|MLQ>] [-c <cpus>] [-q <quantum>]\n", program);
+    fprintf(stderr, "          [--ssd <default|key=value,...>]\n");
+    fprintf(stderr, "          [--format <native|swf|csv>] [--csv-map <field=column,...>] [--time-scale <n>]\n");
+    fprintf(stderr, "          [--hosts <n>] [--dispatch <rr|random|jsq|pod>] [--choices <d>] [--seed <n>]\n");
+    fprintf(stderr, "          [--predict <pid|class>] [--alpha <0..1>] [--initial-estimate <n>]\n");
+    fprintf(stderr, "          [--whatif <time> --alt <ALGO[:quantum]> [--alt ...]]\n");
+    fprintf(stderr, "          [--lock-protocol <none|inherit|ceiling>]\n");
+    fprintf(stderr, "          [--window <ticks> [--window-file <path>] [--window-format <csv|binary>]]\n");
+    fprintf(stderr, "          [--sweep-quanta <q1,q2,...>] [--sweep-cpus <c1,c2,...>] [--sweep-bench]\n");
+    fprintf(stderr, "          [--cpu-max <class>=<quota>/<period> ...]\n");
+    fprintf(stderr, "          [--mlq <class>=<RR[:quantum]|FCFS|SJF>[@<slice>],...] "
+                    "[--mlq-arbitration <priority|slice>]\n");
+    fprintf(stderr, "          [--energy <performance|powersave|ondemand|race|consolidate>] [--tick-ms <ms>]\n");
+    fprintf(stderr, "          [--numa <nodes> [--numa-penalty <factor>] [--numa-policy <oblivious|local|balance>]]\n");
+    fprintf(stderr, "          [--preempt-threshold <ticks>] [--preempt-stats] [--results <file>]\n");
+    fprintf(stderr, "          [--resolution <ns|us|ms|s>] [--step <event|tick>]\n");
+    fprintf(stderr, "          [--checkpoint <file> [--checkpoint-every <time>]] [--record <log>] [--verify <log>]\n");
+    fprintf(stderr, "          [--validate]   (run the workload as real Linux processes and compare)\n");
+    fprintf(stderr, "       Times may be ticks or carry a unit: 250us, 3ms, 2s\n");
+    fprintf(stderr, "       %s -f <edited file> --resume <checkpoints> [--checkpoint <file>]\n", program);
+    fprintf(stderr, "          (checkpoints do not cover --ssd, --predict, --window, --energy, --numa, --hosts,\n");
+    fprintf(stderr, "           --whatif, sweeps, --batch, MLQ, --cpu-max, or lock= and cpu.max= workloads)\n");
+    fprintf(stderr, "       %s -f <file> --replay <log>\n", program);
+    fprintf(stderr, "       %s --batch <dir|glob> [--workers <n>] [-a ...] [-c ...] [-q ...] [--results <file>]\n",
+            program);
+    fprintf(stderr, "       %s --queue-bench [--workers <max threads>]\n", program);
+    fprintf(stderr, "       %s --query <file> [--where <column><op><value> ...] [--group-by <column>]\n", program);
+    fprintf(stderr, "          [--metric <column>]   (op: = != < <= > >=)\n");
+}
+
+/**
+ * Get the dispatch policy name as a string
+ */
+const char* dispatch_name(DispatchPolicy policy) {
+    switch (policy) {
+        case DISPATCH_ROUND_ROBIN: return "Round Robin";
+        case DISPATCH_RANDOM:      return "Random";
+        case DISPATCH_JSQ:         return "Join-Shortest-Queue";
+        case DISPATCH_POWER_OF_D:  return "Power-of-d-Choices";
+        default:                   return "Unknown Dispatcher";
+    }
+}
+
+/**
+ * Get the energy policy name as a string
+ */
+const char* energy_policy_name(EnergyPolicy policy) {
+    switch (policy) {
+        case ENERGY_PERFORMANCE: return "performance";
+        case ENERGY_POWERSAVE:   return "powersave";
+        case ENERGY_ONDEMAND:    return "ondemand";
+        case ENERGY_RACE:        return "race-to-idle";
+        case ENERGY_CONSOLIDATE: return "consolidate";
+        default:                 return "off";
+    }
+}
+
+/**
+ * Get the NUMA placement policy name as a string
+ */
+const char* numa_policy_name(NumaPolicy policy) {
+    switch (policy) {
+        case NUMA_LOCAL:   return "local";
+        case NUMA_BALANCE: return "balancing";
+        default:           return "oblivious";
+    }
+}
+
+/**
+ * Get the lock protocol name as a string
+ */
+const char* lock_protocol_name(LockProtocol protocol) {
+    switch (protocol) {
+        case LOCK_PROTOCOL_INHERIT: return "priority inheritance";
+        case LOCK_PROTOCOL_CEILING: return "priority ceiling";
+        default:                    return "no protocol";
+    }
+}
+
+/**
+ * Advance a xorshift32 generator and return the next value (state must be non-zero)
+ */
+unsigned int xorshift32(unsigned int *state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/**
+ * Return the id of a workload class, registering the name on first use
+ */
+int class_lookup(const char *name) {
+    pthread_mutex_lock(&CLASS_LOCK);
+    for (int i = 0; i < CLASS_COUNT; i++) {
+        if (strcmp(CLASS_NAMES[i], name) == 0) {
+            pthread_mutex_unlock(&CLASS_LOCK);
+            return i;
+        }
+    }
+    if (CLASS_COUNT == MAX_CLASSES) {
+        fprintf(stderr, "Error: Too many workload classes (max %d)\n", MAX_CLASSES);
+        exit(EXIT_FAILURE);
+    }
+    strncpy(CLASS_NAMES[CLASS_COUNT], name, MAX_CLASS_NAME - 1);
+    CLASS_NAMES[CLASS_COUNT][MAX_CLASS_NAME - 1] = '\0';
+    int id = CLASS_COUNT++;
+    pthread_mutex_unlock(&CLASS_LOCK);
+    return id;
+}
+
+/**
+ * Get the name of a workload class
+ */
+const char* class_name(int class_id) {
+    if (class_id < 0 || class_id >= CLASS_COUNT) return "unknown";
+    return CLASS_NAMES[class_id];
+}
+
+/**
+ * Map an algorithm name to its identifier. Returns false (leaving
+ * algorithm untouched) if the name is not recognized.
+ */
+bool parse_algorithm(const char *name, Algorithm *algorithm) {
+    if (strcmp(name, "FCFS") == 0) *algorithm = FCFS;
+    else if (strcmp(name, "RR") == 0) *algorithm = RR;
+    else if (strcmp(name, "SRTF") == 0) *algorithm = SRTF;
+    else if (strcmp(name, "SJF") == 0) *algorithm = SJF;
+    else if (strcmp(name, "LAS") == 0) *algorithm = LAS;
+    else if (strcmp(name, "PRIO") == 0) *algorithm = PRIO;
+    else if (strcmp(name, "MLQ") == 0) *algorithm = MLQ;
+    else return false;
+    return true;
+}
+
+/**
+ * Parse command line arguments
+ */
+void parse_arguments(int argc, char *argv[], Algorithm *algorithm, int *cpu_count, 
+                    SimTime *time_quantum, char **input_file, SimOptions *options) {
+    options->ssd = (SsdConfig){
+        .enabled = false,
+        .blocks = SSD_DEFAULT_BLOCKS,
+        .pages_per_block = SSD_DEFAULT_PAGES_PER_BLOCK,
+        .op_percent = SSD_DEFAULT_OP_PERCENT,
+        .prefill_percent = SSD_DEFAULT_PREFILL_PERCENT,
+        .gc_free_blocks = SSD_DEFAULT_GC_FREE_BLOCKS,
+        .gc_policy = GC_GREEDY,
+        .read_latency = SSD_DEFAULT_READ_LATENCY,
+        .program_latency = SSD_DEFAULT_PROGRAM_LATENCY,
+        .erase_latency = SSD_DEFAULT_ERASE_LATENCY
+    };
+    options->trace = (TraceOptions){
+        .format = FORMAT_NATIVE,
+        .pid_column = 0,
+        .arrival_column = 0,
+        .burst_column = 0,
+        .priority_column = 0,
+        .separator = ',',
+        .skip_lines = 0,
+        .time_scale = 1
+    };
+    options->cluster = (ClusterOptions){
+        .hosts = 1,
+        .dispatch = DISPATCH_ROUND_ROBIN,
+        .choices = DEFAULT_DISPATCH_CHOICES,
+        .seed = DEFAULT_SEED
+    };
+    options->prediction = (PredictionOptions){
+        .mode = PREDICT_NONE,
+        .alpha = DEFAULT_PREDICTION_ALPHA,
+        .initial_estimate = DEFAULT_INITIAL_ESTIMATE
+    };
+    options->lock_protocol = LOCK_PROTOCOL_NONE;
+    options->window.width = 0;
+    options->window.path = NULL;
+    options->window.binary = false;
+    options->sweep.quantum_count = 0;
+    options->sweep.cpu_value_count = 0;
+    options->sweep.bench = false;
+    memset(&options->bandwidth, 0, sizeof(options->bandwidth));
+    options->energy.policy = ENERGY_OFF;
+    options->energy.tick_ms = DEFAULT_TICK_MS;
+    options->numa.nodes = 0;
+    options->numa.penalty = DEFAULT_NUMA_PENALTY;
+    options->numa.policy = NUMA_OBLIVIOUS;
+    options->preemption.threshold = 0;
+    options->preemption.report = false;
+    memset(&options->results, 0, sizeof(options->results));
+    options->results.group_by = -1;
+    options->results.metric = RESULT_TURNAROUND;
+    options->batch.path = NULL;
+    options->batch.queue_bench = false;
+    options->batch.workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (options->batch.workers < 1) options->batch.workers = 1;
+    options->whatif.branch_time = -1;
+    options->whatif.branch_count = 0;
+    options->tick_steps = false;
+    options->validate = false;
+    options->checkpoint.path = NULL;
+    options->checkpoint.interval = DEFAULT_CHECKPOINT_INTERVAL;
+    options->checkpoint.resume = NULL;
+    memset(&options->decisions, 0, sizeof(options->decisions));
+    memset(&options->mlq, 0, sizeof(options->mlq));
+    bool format_given = false, tick_ms_given = false;
+
+    // The tick length must be known before any time with a unit is converted
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--resolution") != 0) continue;
+        const char *unit = argv[i + 1];
+        if (strcmp(unit, "ns") == 0) TICK_NS = 1LL;
+        else if (strcmp(unit, "us") == 0) TICK_NS = 1000LL;
+        else if (strcmp(unit, "ms") == 0) TICK_NS = 1000000LL;
+        else if (strcmp(unit, "s") == 0) TICK_NS = 1000000000LL;
+        else {
+            print_usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            parse_algorithm(argv[++i], algorithm);
+            // Default is FCFS
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            *cpu_count = atoi(argv[++i]);
+            if (*cpu_count <= 0) *cpu_count = 1; // Ensure at least 1 CPU
+        } else if (strcmp(argv[i], "-q") == 0 && i + 1 < argc) {
+            if (!parse_time(argv[++i], time_quantum) || *time_quantum <= 0) *time_quantum = DEFAULT_TIME_QUANTUM;
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            *input_file = argv[++i];
+        } else if (strcmp(argv[i], "--ssd") == 0 && i + 1 < argc) {
+            parse_ssd_spec(argv[++i], &options->ssd);
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "native") == 0) options->trace.format = FORMAT_NATIVE;
+            else if (strcmp(argv[i], "swf") == 0) options->trace.format = FORMAT_SWF;
+            else if (strcmp(argv[i], "csv") == 0) options->trace.format = FORMAT_CSV;
+            else {
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            format_given = true;
+        } else if (strcmp(argv[i], "--csv-map") == 0 && i + 1 < argc) {
+            parse_csv_map(argv[++i], &options->trace);
+            format_given = true;
+        } else if (strcmp(argv[i], "--time-scale") == 0 && i + 1 < argc) {
+            if (!parse_int(argv[++i], &options->trace.time_scale) || options->trace.time_scale < 1) {
+                fprintf(stderr, "Error: --time-scale must be a positive whole number\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--hosts") == 0 && i + 1 < argc) {
+            if (!parse_int(argv[++i], &options->cluster.hosts) || options->cluster.hosts < 1) {
+                fprintf(stderr, "Error: --hosts must be a positive number of hosts\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--dispatch") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "rr") == 0) options->cluster.dispatch = DISPATCH_ROUND_ROBIN;
+            else if (strcmp(argv[i], "random") == 0) options->cluster.dispatch = DISPATCH_RANDOM;
+            else if (strcmp(argv[i], "jsq") == 0) options->cluster.dispatch = DISPATCH_JSQ;
+            else if (strcmp(argv[i], "pod") == 0) options->cluster.dispatch = DISPATCH_POWER_OF_D;
+            else {
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--choices") == 0 && i + 1 < argc) {
+            if (!parse_int(argv[++i], &options->cluster.choices) || options->cluster.choices < 1) {
+                fprintf(stderr, "Error: --choices must be a positive number of hosts\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options->cluster.seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+            if (options->cluster.seed == 0) options->cluster.seed = DEFAULT_SEED;
+        } else if (strcmp(argv[i], "--predict") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "pid") == 0) options->prediction.mode = PREDICT_PID;
+            else if (strcmp(argv[i], "class") == 0) options->prediction.mode = PREDICT_CLASS;
+            else {
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--alpha") == 0 && i + 1 < argc) {
+            options->prediction.alpha = atof(argv[++i]);
+            if (options->prediction.alpha < 0.0 || options->prediction.alpha > 1.0) {
+                fprintf(stderr, "Error: --alpha must be between 0 and 1\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--initial-estimate") == 0 && i + 1 < argc) {
+            if (!parse_time(argv[++i], &options->prediction.initial_estimate) ||
+                options->prediction.initial_estimate <= 0) {
+                fprintf(stderr, "Error: --initial-estimate must be a positive time\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--lock-protocol") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "none") == 0) options->lock_protocol = LOCK_PROTOCOL_NONE;
+            else if (strcmp(argv[i], "inherit") == 0) options->lock_protocol = LOCK_PROTOCOL_INHERIT;
+            else if (strcmp(argv[i], "ceiling") == 0) options->lock_protocol = LOCK_PROTOCOL_CEILING;
+            else {
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--window") == 0 && i + 1 < argc) {
+            if (!parse_time(argv[++i], &options->window.width) || options->window.width <= 0) {
+                fprintf(stderr, "Error: --window must be a positive number of ticks\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--window-file") == 0 && i + 1 < argc) {
+            options->window.path = argv[++i];
+        } else if (strcmp(argv[i], "--window-format") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "csv") == 0) options->window.binary = false;
+            else if (strcmp(argv[i], "binary") == 0) options->window.binary = true;
+            else {
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--sweep-quanta") == 0 && i + 1 < argc) {
+            options->sweep.quantum_count = parse_int_list(argv[++i], options->sweep.quanta, MAX_SWEEP_LANES);
+        } else if (strcmp(argv[i], "--sweep-cpus") == 0 && i + 1 < argc) {
+            options->sweep.cpu_value_count = parse_int_list(argv[++i], options->sweep.cpus, MAX_SWEEP_LANES);
+        } else if (strcmp(argv[i], "--cpu-max") == 0 && i + 1 < argc) {
+            char spec[MAX_LINE_LENGTH];
+            strncpy(spec, argv[++i], sizeof(spec) - 1);
+            spec[sizeof(spec) - 1] = '\0';
+            char *limit = strchr(spec, '=');
+            SimTime quota, period;
+            if (!limit || (*limit++ = '\0', !parse_cpu_max(limit, &quota, &period))) {
+                fprintf(stderr, "Error: --cpu-max expects <class>=<quota>/<period>\n");
+                exit(EXIT_FAILURE);
+            }
+            int class_id = class_lookup(spec);
+            options->bandwidth.quota[class_id] = quota;
+            options->bandwidth.period[class_id] = period;
+        } else if (strcmp(argv[i], "--mlq") == 0 && i + 1 < argc) {
+            if (!parse_mlq_levels(argv[++i], &options->mlq)) {
+                fprintf(stderr, "Error: --mlq expects <class>=<RR[:quantum]|FCFS|SJF>[@<slice>],... "
+                                "naming each class once\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--mlq-arbitration") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "priority") == 0) options->mlq.time_slice = false;
+            else if (strcmp(argv[i], "slice") == 0) options->mlq.time_slice = true;
+            else {
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--energy") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "performance") == 0) options->energy.policy = ENERGY_PERFORMANCE;
+            else if (strcmp(argv[i], "powersave") == 0) options->energy.policy = ENERGY_POWERSAVE;
+            else if (strcmp(argv[i], "ondemand") == 0) options->energy.policy = ENERGY_ONDEMAND;
+            else if (strcmp(argv[i], "race") == 0) options->energy.policy = ENERGY_RACE;
+            else if (strcmp(argv[i], "consolidate") == 0) options->energy.policy = ENERGY_CONSOLIDATE;
+            else {
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--numa") == 0 && i + 1 < argc) {
+            if (!parse_int(argv[++i], &options->numa.nodes) || options->numa.nodes < 1) {
+                fprintf(stderr, "Error: --numa must be a positive number of nodes\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--numa-penalty") == 0 && i + 1 < argc) {
+            options->numa.penalty = atof(argv[++i]);
+            if (options->numa.penalty < 1.0 || options->numa.penalty > MAX_NUMA_PENALTY) {
+                fprintf(stderr, "Error: --numa-penalty must be between 1 and %.0f\n", MAX_NUMA_PENALTY);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--numa-policy") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "oblivious") == 0) options->numa.policy = NUMA_OBLIVIOUS;
+            else if (strcmp(argv[i], "local") == 0) options->numa.policy = NUMA_LOCAL;
+            else if (strcmp(argv[i], "balance") == 0) options->numa.policy = NUMA_BALANCE;
+            else {
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--tick-ms") == 0 && i + 1 < argc) {
+            options->energy.tick_ms = atof(argv[++i]);
+            if (options->energy.tick_ms <= 0.0) options->energy.tick_ms = DEFAULT_TICK_MS;
+            tick_ms_given = true;
+        } else if (strcmp(argv[i], "--resolution") == 0 && i + 1 < argc) {
+            i++; // Applied before the other options
+        } else if (strcmp(argv[i], "--step") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "event") == 0) options->tick_steps = false;
+            else if (strcmp(argv[i], "tick") == 0) options->tick_steps = true;
+            else {
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--validate") == 0) {
+            options->validate = true;
+        } else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+            options->checkpoint.path = argv[++i];
+        } else if (strcmp(argv[i], "--checkpoint-every") == 0 && i + 1 < argc) {
+            if (!parse_time(argv[++i], &options->checkpoint.interval) || options->checkpoint.interval <= 0) {
+                fprintf(stderr, "Error: --checkpoint-every must be a positive time\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--resume") == 0 && i + 1 < argc) {
+            options->checkpoint.resume = argv[++i];
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            options->decisions.record = argv[++i];
+        } else if (strcmp(argv[i], "--verify") == 0 && i + 1 < argc) {
+            options->decisions.verify = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            options->decisions.replay = argv[++i];
+        } else if (strcmp(argv[i], "--preempt-threshold") == 0 && i + 1 < argc) {
+            if (!parse_time(argv[++i], &options->preemption.threshold)) {
+                fprintf(stderr, "Error: --preempt-threshold must be a non-negative time\n");
+                exit(EXIT_FAILURE);
+            }
+            options->preemption.report = true;
+        } else if (strcmp(argv[i], "--preempt-stats") == 0) {
+            options->preemption.report = true;
+        } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            options->batch.path = argv[++i];
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            if (!parse_int(argv[++i], &options->batch.workers) || options->batch.workers < 1) {
+                fprintf(stderr, "Error: --workers must be a positive number of threads\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--queue-bench") == 0) {
+            options->batch.queue_bench = true;
+        } else if (strcmp(argv[i], "--results") == 0 && i + 1 < argc) {
+            options->results.path = argv[++i];
+        } else if (strcmp(argv[i], "--query") == 0 && i + 1 < argc) {
+            options->results.query = argv[++i];
+        } else if (strcmp(argv[i], "--where") == 0 && i + 1 < argc) {
+            if (options->results.filter_count == MAX_RESULT_FILTERS) {
+                fprintf(stderr, "Error: At most %d --where filters\n", MAX_RESULT_FILTERS);
+                exit(EXIT_FAILURE);
+            }
+            if (!parse_result_filter(argv[++i], &options->results.filters[options->results.filter_count++])) {
+                fprintf(stderr, "Error: --where expects <column><op><value>, e.g. cpus>=4\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if ((strcmp(argv[i], "--group-by") == 0 || strcmp(argv[i], "--metric") == 0) && i + 1 < argc) {
+            int column = result_column_lookup(argv[i + 1]);
+            if (column < 0) {
+                fprintf(stderr, "Error: Unknown results column '%s'\n", argv[i + 1]);
+                exit(EXIT_FAILURE);
+            }
+            if (strcmp(argv[i], "--group-by") == 0) options->results.group_by = column;
+            else options->results.metric = column;
+            i++;
+        } else if (strcmp(argv[i], "--sweep-bench") == 0) {
+            options->sweep.bench = true;
+        } else if (strcmp(argv[i], "--whatif") == 0 && i + 1 < argc) {
+            if (!parse_time(argv[++i], &options->whatif.branch_time)) {
+                fprintf(stderr, "Error: --whatif must be a non-negative time\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--alt") == 0 && i + 1 < argc) {
+            WhatIfOptions *w = &options->whatif;
+            if (w->branch_count == MAX_WHATIF_BRANCHES) {
+                fprintf(stderr, "Error: At most %d --alt branches\n", MAX_WHATIF_BRANCHES);
+                exit(EXIT_FAILURE);
+            }
+            char name[MAX_LINE_LENGTH];
+            strncpy(name, argv[++i], sizeof(name) - 1);
+            name[sizeof(name) - 1] = '\0';
+            char *quantum = strchr(name, ':');
+            if (quantum) *quantum++ = '\0';
+            if (!parse_algorithm(name, &w->algorithms[w->branch_count])) {
+                fprintf(stderr, "Error: Unknown algorithm '%s' in --alt\n", name);
+                exit(EXIT_FAILURE);
+            }
+            w->quanta[w->branch_count] = 0;
+            if (quantum && (!parse_time(quantum, &w->quanta[w->branch_count]) || w->quanta[w->branch_count] <= 0)) {
+                fprintf(stderr, "Error: Bad quantum '%s' in --alt (expected a positive time)\n", quantum);
+                exit(EXIT_FAILURE);
+            }
+            w->branch_count++;
+        } else {
+            print_usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Query mode reads a results store and simulates nothing, as does the queue benchmark
+    if (options->results.query || options->batch.queue_bench) return;
+
+    // The power model's tick follows the resolution unless given explicitly
+    if (!tick_ms_given) options->energy.tick_ms = (double)TICK_NS / 1e6;
+
+    if (!(*input_file) && !options->batch.path) {
+        fprintf(stderr, "Error: Input file required. Use -f <filename> or --batch <dir>\n");
+        exit(EXIT_FAILURE);
+    }
+    options->results.workload = *input_file;
+    options->batch.format_given = format_given;
+
+    // Alternatives without a quantum inherit -q
+    for (int b = 0; b < options->whatif.branch_count; b++) {
+        if (options->whatif.quanta[b] <= 0) options->whatif.quanta[b] = *time_quantum;
+    }
+    if ((options->whatif.branch_time >= 0) != (options->whatif.branch_count > 0)) {
+        fprintf(stderr, "Error: --whatif and --alt must be used together\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Multi-level queues default to interactive RR above batch FCFS
+    MlqOptions *mlq = &options->mlq;
+    bool uses_mlq = *algorithm == MLQ;
+    for (int b = 0; b < options->whatif.branch_count; b++) uses_mlq |= options->whatif.algorithms[b] == MLQ;
+    if (uses_mlq && mlq->level_count == 0) parse_mlq_levels("interactive=RR,batch=FCFS", mlq);
+    if (!uses_mlq && (mlq->level_count > 0 || mlq->time_slice)) {
+        fprintf(stderr, "Error: --mlq and --mlq-arbitration apply to -a MLQ only\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int l = 0; l < mlq->level_count; l++) {
+        if (mlq->quanta[l] <= 0) mlq->quanta[l] = *time_quantum;
+    }
+    mlq->policies[mlq->level_count] = FCFS;
+    mlq->slices[mlq->level_count] = 0; // Unlisted classes never lead
+    for (int c = 0; c < MAX_CLASSES; c++) mlq->level_of[c] = mlq->level_count;
+    for (int l = 0; l < mlq->level_count; l++) mlq->level_of[mlq->classes[l]] = l;
+
+    // Sweeps run every combination of the listed quanta and CPU counts
+    SweepOptions *sweep = &options->sweep;
+    if (sweep->quantum_count > 0 || sweep->cpu_value_count > 0 || sweep->bench) {
+        if (*time_quantum > INT_MAX) {
+            fprintf(stderr, "Error: Sweeps support quanta up to %d ticks\n", INT_MAX);
+            exit(EXIT_FAILURE);
+        }
+        if (*algorithm != LAS && *algorithm != PRIO) {
+            fprintf(stderr, "Error: Sweeps support the LAS and PRIO policies\n");
+            exit(EXIT_FAILURE);
+        }
+        // PRIO never looks at the quantum, so every lane of a quantum sweep would be the same run
+        if (*algorithm == PRIO && sweep->quantum_count > 0) {
+            fprintf(stderr, "Error: PRIO ignores the quantum; --sweep-quanta applies to LAS only\n");
+            exit(EXIT_FAILURE);
+        }
+        if (sweep->quantum_count == 0) sweep->quanta[sweep->quantum_count++] = (int)*time_quantum;
+        if (sweep->cpu_value_count == 0) sweep->cpus[sweep->cpu_value_count++] = *cpu_count;
+        if (sweep->quantum_count * sweep->cpu_value_count > MAX_SWEEP_LANES) {
+            fprintf(stderr, "Error: A sweep runs at most %d configurations\n", MAX_SWEEP_LANES);
+            exit(EXIT_FAILURE);
+        }
+        if (options->ssd.enabled || options->cluster.hosts > 1 || options->whatif.branch_count > 0 ||
+            options->window.width > 0) {
+            fprintf(stderr, "Error: Sweeps cannot be combined with --ssd, --hosts, --whatif or --window\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (options->energy.policy != ENERGY_OFF &&
+        (options->cluster.hosts > 1 || options->whatif.branch_count > 0 || sweep->quantum_count > 0)) {
+        fprintf(stderr, "Error: --energy applies to single-host runs only\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Both models hold back processes around execute_processes, and sweeps never call it
+    if (options->numa.nodes > 0 && (options->energy.policy != ENERGY_OFF || sweep->quantum_count > 0)) {
+        fprintf(stderr, "Error: --numa cannot be combined with --energy or sweeps\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (options->batch.path && (options->cluster.hosts > 1 || options->whatif.branch_count > 0 ||
+                                sweep->quantum_count > 0 || options->window.width > 0 ||
+                                options->checkpoint.path || options->checkpoint.resume)) {
+        fprintf(stderr, "Error: --batch cannot be combined with --hosts, --whatif, sweeps, --window, "
+                        "--checkpoint or --resume\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (options->results.path && (options->cluster.hosts > 1 || options->whatif.branch_count > 0)) {
+        fprintf(stderr, "Error: --results applies to single-host runs and sweeps only\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Decisions are logged by single-host runs; a replay schedules nothing itself
+    const DecisionOptions *decisions = &options->decisions;
+    if ((decisions->record || decisions->verify || decisions->replay) &&
+        (options->cluster.hosts > 1 || options->whatif.branch_count > 0 || sweep->quantum_count > 0 ||
+         options->batch.path)) {
+        fprintf(stderr, "Error: --record, --verify and --replay apply to single-host runs only\n");
+        exit(EXIT_FAILURE);
+    }
+    if (decisions->record && decisions->verify) {
+        fprintf(stderr, "Error: --record and --verify cannot be used together\n");
+        exit(EXIT_FAILURE);
+    }
+    if (decisions->replay && (decisions->record || decisions->verify || options->ssd.enabled ||
+                              options->energy.policy != ENERGY_OFF || options->numa.nodes > 0 ||
+                              options->window.width > 0 ||
+                              options->prediction.mode != PREDICT_NONE || options->results.path ||
+                              options->checkpoint.path || options->checkpoint.resume)) {
+        fprintf(stderr, "Error: --replay only regenerates the schedule and its basic metrics\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Validation compares plain CPU-bound runs only
+    if (options->validate &&
+        (options->cluster.hosts > 1 || options->whatif.branch_count > 0 || sweep->quantum_count > 0 ||
+         options->batch.path || decisions->record || decisions->verify || decisions->replay ||
+         options->checkpoint.path || options->checkpoint.resume || options->ssd.enabled ||
+         options->energy.policy != ENERGY_OFF || options->numa.nodes > 0)) {
+        fprintf(stderr, "Error: --validate cannot be combined with --hosts, --whatif, sweeps, --batch, --record, "
+                        "--verify, --replay, --checkpoint, --resume, --ssd, --energy or --numa\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (options->window.width > 0) {
+        if (options->cluster.hosts > 1 || options->whatif.branch_count > 0) {
+            fprintf(stderr, "Error: --window applies to single-host runs only\n");
+            exit(EXIT_FAILURE);
+        }
+        if (!options->window.path) options->window.path = options->window.binary ? "windows.bin" : "windows.csv";
+    }
+
+    // Infer the trace format from the file name unless it was given
+    if (!format_given && *input_file) {
+        options->trace.format = infer_trace_format(*input_file, options->trace.format);
+    }
+    if (options->trace.format == FORMAT_CSV &&
+        (options->trace.arrival_column <= 0 || options->trace.burst_column <= 0)) {
+        fprintf(stderr, "Error: CSV input needs --csv-map with arrival and burst columns\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Guess a workload file's format from its extension, looking past a
+ * trailing .gz (so "run.csv.d/jobs.txt" stays a plain workload)
+ */
+TraceFormat infer_trace_format(const char *filename, TraceFormat fallback) {
+    size_t length = strlen(filename);
+    if (length >= 3 && strcmp(filename + length - 3, ".gz") == 0) length -= 3;
+    if (length < 4) return fallback;
+    if (strncmp(filename + length - 4, ".swf", 4) == 0) return FORMAT_SWF;
+    if (strncmp(filename + length - 4, ".csv", 4) == 0) return FORMAT_CSV;
+    return fallback;
+}
+
+/************************* PROCESS LOADING *************************/
+
+/**
+ * Initialize a process record before the simulation starts
+ */
+void init_process(Process *p, int pid, SimTime arrival, SimTime burst, int priority) {
+    p->pid = pid;
+    p->arrival_time = arrival;
+    p->burst_time = burst;
+    p->priority = priority;
+    p->remaining_time = burst;
+    p->state = WAITING;
+    p->start_time = -1;
+    p->finish_time = -1;
+    p->waiting_time = 0;
+    p->quantum_used = 0;
+    p->response_time = -1;
+    p->io_interval = 0;
+    p->io_pages = DEFAULT_IO_PAGES;
+    p->io_wake_time = -1;
+    p->io_time = 0;
+    p->class_id = 0;
+    p->predicted_burst = -1;
+    p->base_priority = priority;
+    p->lock_use_count = 0;
+    p->locks_held = 0;
+    p->blocked_on = -1;
+    p->lock_wait_time = 0;
+    p->inversion_time = 0;
+    p->bw_quota = 0;
+    p->bw_period = 0;
+    p->bucket = -1;
+    p->throttle_start = 0;
+    p->throttled_time = 0;
+    p->queued_at = 0;
+    p->home_node = -1;
+    p->numa_credit = 0.0;
+    p->remote_streak = 0;
+    p->local_time = 0;
+    p->remote_time = 0;
+}
+
+/**
+ * Apply optional key=value attributes that follow the numeric columns
+ *
+ * Supported keys:
+ *   io=N     issue a one-page write after every N ticks of CPU time
+ *   pages=N  size of the logical working set those writes go to
+ *   class=S  workload class name (used by --predict class, --cpu-max and --mlq)
+ *   lock=L:A:R  hold lock L from A to R ticks of CPU time (repeatable)
+ *   cpu.max=Q/P  limit the process to Q ticks of CPU time every P ticks
+ *   node=N   NUMA node holding the process's memory (see --numa)
+ *
+ * Times may carry a unit suffix (see parse_time).
+ */
+void parse_process_attributes(char *line, Process *p) {
+    char *save;
+    for (char *token = strtok_r(line, " \t\r\n", &save); token; token = strtok_r(NULL, " \t\r\n", &save)) {
+        char *value = strchr(token, '=');
+        if (!value) continue; // Positional column
+        *value++ = '\0';
+
+        if (strcmp(token, "io") == 0) {
+            if (!parse_time(value, &p->io_interval)) p->io_interval = 0;
+        } else if (strcmp(token, "pages") == 0) {
+            p->io_pages = atoi(value);
+            if (p->io_pages <= 0) p->io_pages = DEFAULT_IO_PAGES;
+        } else if (strcmp(token, "class") == 0) {
+            p->class_id = class_lookup(value);
+        } else if (strcmp(token, "lock") == 0) {
+            LockUse use;
+            char acquire[MAX_LINE_LENGTH], release[MAX_LINE_LENGTH];
+            if (sscanf(value, "%d:%255[^:]:%255s", &use.lock, acquire, release) != 3 ||
+                !parse_time(acquire, &use.acquire_at) || !parse_time(release, &use.release_at) ||
+                use.lock < 0 || use.lock >= MAX_LOCKS ||
+                use.release_at <= use.acquire_at || use.release_at > p->burst_time) {
+                fprintf(stderr, "Warning: Ignoring invalid lock=%s for PID %d\n", value, p->pid);
+            } else if (p->lock_use_count == MAX_PROCESS_LOCKS) {
+                fprintf(stderr, "Warning: PID %d uses more than %d locks\n", p->pid, MAX_PROCESS_LOCKS);
+            } else {
+                p->lock_uses[p->lock_use_count++] = use;
+            }
+        } else if (strcmp(token, "cpu.max") == 0) {
+            if (!parse_cpu_max(value, &p->bw_quota, &p->bw_period)) {
+                fprintf(stderr, "Warning: Ignoring invalid cpu.max=%s for PID %d\n", value, p->pid);
+            }
+        } else if (strcmp(token, "node") == 0) {
+            char *end;
+            long node = strtol(value, &end, 10);
+            if (end == value || *end != '\0' || node < 0 || node > INT_MAX) {
+                fprintf(stderr, "Warning: Ignoring invalid node=%s for PID %d\n", value, p->pid);
+            } else {
+                p->home_node = (int)node;
+            }
+        } else {
+            fprintf(stderr, "Warning: Ignoring unknown attribute '%s' for PID %d\n", token, p->pid);
+        }
+    }
+}
+
+/**
+ * Read the positional columns of a workload line. Returns how many of
+ * PID, arrival, burst and priority were present, like sscanf.
+ */
+static int parse_native_record(const char *line, int *pid, SimTime *arrival, SimTime *burst, int *priority) {
+    char buffer[MAX_LINE_LENGTH];
+    strncpy(buffer, line, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+
+    char *save, *end;
+    char *token = strtok_r(buffer, " \t\r\n", &save);
+    if (!token) return 0;
+    *pid = (int)strtol(token, &end, 10);
+    if (end == token) return 0;
+    token = strtok_r(NULL, " \t\r\n", &save);
+    if (!token || !parse_time(token, arrival)) return 1;
+    token = strtok_r(NULL, " \t\r\n", &save);
+    if (!token || !parse_time(token, burst)) return 2;
+    token = strtok_r(NULL, " \t\r\n", &save);
+    if (!token) return 3;
+    *priority = (int)strtol(token, &end, 10);
+    return (end == token) ? 3 : 4;
+}
+
+/**
+ * Load processes from a file
+ * 
+ * Expected format:
+ * <PID> <arrival_time> <burst_time> [priority] [key=value ...]
+ * 
+ * Times are ticks, or carry a unit suffix such as 250us or 3ms (see
+ * parse_time). Lines starting with # are treated as comments. quiet
+ * suppresses the progress messages (batch workers load many files at once).
+ */
+void load_processes(const char *filename, Process **processes_ptr, int *count, bool quiet) {
+    FILE *file = fopen(filename, "r");
+    if (!file) {
+        perror("Error opening process file");
+        exit(EXIT_FAILURE);
+    }
+
+    // Count valid lines first
+    int process_count = 0;
+    char line[MAX_LINE_LENGTH];
+    while (fgets(line, sizeof(line), file)) {
+        if (line[0] != '#' && line[0] != '\n' && strspn(line, " \t\n\r") != strlen(line)) {
+            int pid, priority;
+            SimTime arrival, burst;
+            if (parse_native_record(line, &pid, &arrival, &burst, &priority) >= 3) {
+                process_count++;
+            }
+        }
+    }
+
+    if (process_count == 0) {
+        *processes_ptr = NULL;
+        *count = 0;
+        fclose(file);
+        if (!quiet) printf("Warning: No valid processes found in %s\n", filename);
+        return;
+    }
+
+    // Allocate memory
+    *processes_ptr = (Process *)malloc(process_count * sizeof(Process));
+    if (!(*processes_ptr)) {
+        perror("Memory allocation failed for processes");
+        fclose(file);
+        exit(EXIT_FAILURE);
+    }
+
+    // Read process data
+    rewind(file);
+    int i = 0;
+    while (fgets(line, sizeof(line), file) && i < process_count) {
+        if (line[0] == '#' || line[0] == '\n' || strspn(line, " \t\n\r") == strlen(line)) continue;
+
+        int pid, priority = 0; // Default priority
+        SimTime arrival, burst;
+        int items_read = parse_native_record(line, &pid, &arrival, &burst, &priority);
+
+        if (items_read >= 3) { // Need at least PID, arrival, burst
+            Process *p = &(*processes_ptr)[i];
+            init_process(p, pid, arrival, burst, (items_read == 4) ? priority : 0);
+            parse_process_attributes(line, p);
+            i++;
+        }
+    }
+    fclose(file);
+
+    *count = i; // Actual number of processes successfully read
+    if (!quiet) printf("Loaded %d processes from %s\n", *count, filename);
+}
+
+/************************* TRACE IMPORT *************************/
+
+/**
+ * Open a trace for reading. Gzip input is decompressed on the fly when the
+ * simulator is built with zlib.
+ */
+bool trace_open(TraceReader *reader, const char *filename) {
+    reader->line_number = 0;
+#ifdef HAVE_ZLIB
+    reader->gz = gzopen(filename, "rb");
+    if (!reader->gz) return false;
+    gzbuffer(reader->gz, 1 << 16);
+#else
+    reader->file = fopen(filename, "r");
+    if (!reader->file) return false;
+    int b0 = fgetc(reader->file), b1 = fgetc(reader->file);
+    if (b0 == 0x1f && b1 == 0x8b) {
+        fprintf(stderr, "Error: %s is gzip-compressed; rebuild with -DHAVE_ZLIB and -lz\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    rewind(reader->file);
+#endif
+    return true;
+}
+
+/**
+ * Read the next line into line. Overlong lines are truncated and the rest
+ * is discarded. Returns false at end of input.
+ */
+bool trace_read_line(TraceReader *reader, char *line, int size) {
+#ifdef HAVE_ZLIB
+    if (!gzgets(reader->gz, line, size)) return false;
+#else
+    if (!fgets(line, size, reader->file)) return false;
+#endif
+    reader->line_number++;
+
+    size_t len = strlen(line);
+    if (len == (size_t)size - 1 && line[len - 1] != '\n') {
+        char rest[MAX_LINE_LENGTH];
+#ifdef HAVE_ZLIB
+        while (gzgets(reader->gz, rest, sizeof(rest)) && rest[strlen(rest) - 1] != '\n');
+#else
+        while (fgets(rest, sizeof(rest), reader->file) && rest[strlen(rest) - 1] != '\n');
+#endif
+    }
+    return true;
+}
+
+/**
+ * Close a trace reader
+ */
+void trace_close(TraceReader *reader) {
+#ifdef HAVE_ZLIB
+    gzclose(reader->gz);
+#else
+    fclose(reader->file);
+#endif
+}
+
+/**
+ * Parse a numeric field; SWF and CSV exports often write times as floats
+ */
+static bool parse_number(const char *text, double *value) {
+    char *end;
+    *value = strtod(text, &end);
+    if (end == text) return false;
+    while (*end == ' ' || *end == '\t' || *end == '\r' || *end == '\n' || *end == '"') end++;
+    return *end == '\0';
+}
+
+/**
+ * Convert one SWF record into a process. Returns false for comment lines and
+ * for jobs without a usable run time (cancelled or failed before starting).
+ *
+ * Fields used (1-based): 1 job number, 2 submit time, 4 run time, 15 queue.
+ * Processor counts are ignored: each job is simulated as a single process.
+ */
+static bool parse_swf_record(char *line, Process *p) {
+    if (line[0] == ';') return false; // Header comment
+
+    double fields[18];
+    int n = 0;
+    char *save;
+    for (char *token = strtok_r(line, " \t\r\n", &save); token && n < 18;
+         token = strtok_r(NULL, " \t\r\n", &save)) {
+        if (!parse_number(token, &fields[n])) return false;
+        n++;
+    }
+    if (n < 4 || fields[1] < 0 || fields[3] <= 0) return false;
+
+    int queue = (n >= 15 && fields[14] >= 0) ? (int)fields[14] : 0;
+    init_process(p, (int)fields[0], llround(fields[1]), llround(fields[3]), queue);
+    return true;
+}
+
+/**
+ * Convert one delimited record into a process using the column mapping.
+ * Returns false for records whose mapped fields are missing or not numeric
+ * (such as a header line). Quoted separators are not supported.
+ */
+static bool parse_csv_record(char *line, const TraceOptions *trace, long ordinal, Process *p) {
+    int wanted = trace->pid_column;
+    if (trace->arrival_column > wanted) wanted = trace->arrival_column;
+    if (trace->burst_column > wanted) wanted = trace->burst_column;
+    if (trace->priority_column > wanted) wanted = trace->priority_column;
+
+    double pid = (double)ordinal, arrival = 0, burst = 0, priority = 0;
+    bool have_arrival = false, have_burst = false;
+
+    char *field = line;
+    for (int column = 1; field && column <= wanted; column++) {
+        char *next = strchr(field, trace->separator);
+        if (next) *next++ = '\0';
+        while (*field == ' ' || *field == '"') field++;
+
+        double value;
+        bool numeric = parse_number(field, &value);
+        if (column == trace->pid_column) {
+            if (!numeric) return false;
+            pid = value;
+        }
+        if (column == trace->arrival_column) {
+            have_arrival = numeric;
+            arrival = value;
+        }
+        if (column == trace->burst_column) {
+            have_burst = numeric;
+            burst = value;
+        }
+        if (column == trace->priority_column && numeric) priority = value;
+        field = next;
+    }
+    if (!have_arrival || !have_burst || arrival < 0 || burst <= 0) return false;
+
+    init_process(p, (int)pid, llround(arrival), llround(burst), (int)priority);
+    return true;
+}
+
+/**
+ * Stream a SWF or CSV trace into a process array. Records are converted as
+ * they are read and the array grows geometrically, so the file is read once
+ * and never held in memory. quiet suppresses the progress messages.
+ */
+void load_trace(const char *filename, const TraceOptions *trace, Process **processes_ptr, int *count,
+                bool quiet) {
+    TraceReader reader;
+    if (!trace_open(&reader, filename)) {
+        perror("Error opening trace file");
+        exit(EXIT_FAILURE);
+    }
+
+    int capacity = INITIAL_TRACE_CAPACITY;
+    Process *processes = (Process *)malloc(capacity * sizeof(Process));
+    if (!processes) {
+        perror("Memory allocation failed for processes");
+        exit(EXIT_FAILURE);
+    }
+
+    int n = 0;
+    long skipped = 0;
+    char line[TRACE_LINE_LENGTH];
+    while (trace_read_line(&reader, line, sizeof(line))) {
+        if (strspn(line, " \t\n\r") == strlen(line)) continue;
+
+        bool ok;
+        if (trace->format == FORMAT_SWF) {
+            ok = parse_swf_record(line, &processes[n]);
+            if (!ok && line[0] == ';') continue; // Comments are not skipped records
+        } else {
+            if (reader.line_number <= trace->skip_lines || line[0] == '#') continue;
+            ok = parse_csv_record(line, trace, n + 1, &processes[n]);
+        }
+        if (!ok) {
+            skipped++;
+            continue;
+        }
+
+        Process *p = &processes[n];
+        if (trace->time_scale > 1) {
+            p->arrival_time /= trace->time_scale;
+            p->burst_time = (p->burst_time + trace->time_scale - 1) / trace->time_scale;
+            p->remaining_time = p->burst_time;
+        }
+
+        if (++n == capacity) {
+            if (capacity > INT_MAX / 2) {
+                fprintf(stderr, "Error: Trace has too many records\n");
+                exit(EXIT_FAILURE);
+            }
+            capacity *= 2;
+            Process *temp = (Process *)realloc(processes, capacity * sizeof(Process));
+            if (!temp) {
+                perror("Memory allocation failed for processes");
+                exit(EXIT_FAILURE);
+            }
+            processes = temp;
+        }
+    }
+    trace_close(&reader);
+
+    if (n == 0) {
+        free(processes);
+        processes = NULL;
+        if (!quiet) printf("Warning: No valid processes found in %s\n", filename);
+    }
+    *processes_ptr = processes;
+    *count = n;
+    if (n > 0 && !quiet) printf("Loaded %d processes from %s (%ld records skipped)\n", n, filename, skipped);
+}
+
+/************************* BURST PREDICTION *************************/
+
+/**
+ * Find the table slot for key, or the empty slot where it would go
+ */
+static int predictor_slot(const Predictor *pred, int key) {
+    int slot = (int)(((unsigned int)key * 2654435761u) & (unsigned int)(pred->capacity - 1));
+    while (pred->used[slot] && pred->keys[slot] != key) {
+        slot = (slot + 1) & (pred->capacity - 1);
+    }
+    return slot;
+}
+
+/**
+ * History key of a process under the configured mode
+ */
+static int predictor_key(const Predictor *pred, const Process *p) {
+    return (pred->mode == PREDICT_CLASS) ? p->class_id : p->pid;
+}
+
+/**
+ * Create an empty predictor able to track up to process_capacity keys
+ */
+void predictor_init(Predictor *pred, const PredictionOptions *options, int process_capacity) {
+    memset(pred, 0, sizeof(*pred));
+    pred->mode = options->mode;
+    pred->alpha = options->alpha;
+    pred->initial_estimate = options->initial_estimate;
+
+    pred->capacity = 16;
+    while (pred->capacity < 2 * process_capacity) pred->capacity *= 2;
+    pred->keys = (int *)malloc(pred->capacity * sizeof(int));
+    pred->estimates = (double *)malloc(pred->capacity * sizeof(double));
+    pred->used = (bool *)calloc(pred->capacity, sizeof(bool));
+    if (!pred->keys || !pred->estimates || !pred->used) {
+        perror("Failed to allocate predictor");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Make room for the keys of up to process_capacity processes, rehashing
+ * the known keys into a larger table if needed
+ */
+void predictor_reserve(Predictor *pred, int process_capacity) {
+    if (pred->capacity >= 2 * process_capacity) return;
+    Predictor old = *pred;
+    while (pred->capacity < 2 * process_capacity) pred->capacity *= 2;
+    pred->keys = (int *)malloc(pred->capacity * sizeof(int));
+    pred->estimates = (double *)malloc(pred->capacity * sizeof(double));
+    pred->used = (bool *)calloc(pred->capacity, sizeof(bool));
+    if (!pred->keys || !pred->estimates || !pred->used) {
+        perror("Failed to allocate predictor");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < old.capacity; i++) {
+        if (!old.used[i]) continue;
+        int slot = predictor_slot(pred, old.keys[i]);
+        pred->used[slot] = true;
+        pred->keys[slot] = old.keys[i];
+        pred->estimates[slot] = old.estimates[i];
+    }
+    predictor_cleanup(&old);
+}
+
+/**
+ * Predict the burst of an arriving process from the history of its key
+ */
+SimTime predictor_estimate(Predictor *pred, const Process *p) {
+    int slot = predictor_slot(pred, predictor_key(pred, p));
+    if (!pred->used[slot]) return pred->initial_estimate;
+    SimTime estimate = llround(pred->estimates[slot]);
+    return estimate > 0 ? estimate : 1;
+}
+
+/**
+ * Fold the burst of a completed process into the history of its key
+ */
+void predictor_learn(Predictor *pred, const Process *p) {
+    int key = predictor_key(pred, p);
+    int slot = predictor_slot(pred, key);
+    if (!pred->used[slot]) {
+        pred->used[slot] = true;
+        pred->keys[slot] = key;
+        pred->estimates[slot] = pred->initial_estimate;
+    }
+    pred->estimates[slot] = pred->alpha * (double)p->burst_time + (1.0 - pred->alpha) * pred->estimates[slot];
+
+    if (p->predicted_burst >= 0 && p->burst_time > 0) {
+        double error = fabs((double)p->predicted_burst - (double)p->burst_time);
+        pred->total_abs_error += error;
+        pred->total_rel_error += error / (double)p->burst_time;
+        pred->samples++;
+    }
+}
+
+/**
+ * Release predictor storage
+ */
+void predictor_cleanup(Predictor *pred) {
+    free(pred->keys);
+    free(pred->estimates);
+    free(pred->used);
+}
+
+/**
+ * Job size as the scheduling policy may see it: the prediction when one
+ * was made (--predict), otherwise the true burst time
+ */
+SimTime job_size_estimate(const Process *p) {
+    return p->predicted_burst >= 0 ? p->predicted_burst : p->burst_time;
+}
+
+/**
+ * Remaining time as the scheduling policy may see it. A job that outlives
+ * its prediction is assumed to be about to finish.
+ */
+SimTime remaining_estimate(const Process *p) {
+    if (p->predicted_burst < 0) return p->remaining_time;
+    SimTime remaining = p->predicted_burst - (p->burst_time - p->remaining_time);
+    return remaining > 0 ? remaining : 1;
+}
+
+/************************* SIMULATION COMPONENTS *************************/
+
+/**
+ * Least Attained Service (foreground-background) scheduling.
+ *
+ * The waiting process with the least CPU time so far runs next. A running
+ * process can be displaced when a new process arrives or once it has used
+ * a full quantum, and only by a process with strictly less attained service,
+ * so equal jobs share the CPUs in quantum-sized turns.
+ */
+void handle_las_scheduling(Process *processes, int process_count, CPU *cpus, int cpu_count, SimTime time_quantum,
+                           int arrival_count, SimTime current_time) {
+    for (;;) {
+        // Least attained waiting process, earliest arrival first on ties
+        Process *best = NULL;
+        for (int i = 0; i < process_count; i++) {
+            Process *p = &processes[i];
+            if (p->state != WAITING || p->arrival_time > current_time) continue;
+            SimTime attained = p->burst_time - p->remaining_time;
+            if (!best || attained < best->burst_time - best->remaining_time ||
+                (attained == best->burst_time - best->remaining_time && p->arrival_time < best->arrival_time)) {
+                best = p;
+            }
+        }
+        if (!best) return;
+
+        // Prefer an idle CPU, otherwise the preemptible process with the most attained service
+        int target = -1;
+        for (int c = 0; c < cpu_count && target == -1; c++) {
+            if (!cpus[c].current_process) target = c;
+        }
+        if (target == -1) {
+            int victim = -1;
+            SimTime victim_attained = -1;
+            for (int c = 0; c < cpu_count; c++) {
+                Process *r = cpus[c].current_process;
+                if (arrival_count == 0 && r->quantum_used < time_quantum) continue;
+                SimTime attained = r->burst_time - r->remaining_time;
+                if (attained > victim_attained) {
+                    victim = c;
+                    victim_attained = attained;
+                }
+            }
+            if (victim == -1 || best->burst_time - best->remaining_time >= victim_attained) return;
+
+            Process *r = cpus[victim].current_process;
+            r->state = WAITING;
+            r->quantum_used = 0;
+            target = victim;
+        }
+
+        best->state = RUNNING;
+        best->quantum_used = 0;
+        if (best->start_time == -1) {
+            best->start_time = current_time;
+            best->response_time = current_time - best->arrival_time;
+        }
+        cpus[target].current_process = best;
+    }
+}
+
+/**
+ * Preemptive fixed-priority scheduling.
+ *
+ * The waiting process with the highest (possibly inherited) priority runs
+ * next, displacing the lowest-priority running process if that one has a
+ * strictly lower priority. Ties go to the earlier arrival.
+ */
+void handle_priority_scheduling(Process *processes, int process_count, CPU *cpus, int cpu_count,
+                                SimTime current_time) {
+    for (;;) {
+        Process *best = NULL;
+        for (int i = 0; i < process_count; i++) {
+            Process *p = &processes[i];
+            if (p->state != WAITING || p->arrival_time > current_time) continue;
+            if (!best || p->priority > best->priority ||
+                (p->priority == best->priority && p->arrival_time < best->arrival_time)) {
+                best = p;
+            }
+        }
+        if (!best) return;
+
+        // Prefer an idle CPU, otherwise the lowest-priority running process
+        int target = -1;
+        for (int c = 0; c < cpu_count && target == -1; c++) {
+            if (!cpus[c].current_process) target = c;
+        }
+        if (target == -1) {
+            int victim = 0;
+            for (int c = 1; c < cpu_count; c++) {
+                if (cpus[c].current_process->priority < cpus[victim].current_process->priority) victim = c;
+            }
+            if (best->priority <= cpus[victim].current_process->priority) return;
+
+            Process *r = cpus[victim].current_process;
+            r->state = WAITING;
+            r->quantum_used = 0;
+            target = victim;
+        }
+
+        best->state = RUNNING;
+        best->quantum_used = 0;
+        if (best->start_time == -1) {
+            best->start_time = current_time;
+            best->response_time = current_time - best->arrival_time;
+        }
+        cpus[target].current_process = best;
+    }
+}
+
+/**
+ * Decide whether this tick's arrivals can preempt anything, so SRTF only
+ * runs its full check when needed. Running processes' remaining times only
+ * shrink, so a preemption can only become necessary when a process becomes
+ * runnable. Each arrival, shortest first, is compared against a max-heap of
+ * the running processes' remaining times; an arrival that beats the top
+ * displaces it (it is popped). With a hysteresis threshold T the top's
+ * remaining time counts as T less, as in tick_srtf_preemption; an arrival
+ * that only beats it without that is suppressed. With idle CPUs the check
+ * is always run, since it may leave a preemption for the next tick (see
+ * sim_step).
+ */
+bool srtf_preemption_possible(Simulation *sim, int arrival_count) {
+    if (sim->srtf_recheck) return true;
+    if (arrival_count == 0) return false;
+
+    SimTime threshold = sim->options->preemption.threshold;
+    Process **heap = sim->srtf_heap;
+    int size = 0, idle = 0;
+    for (int c = 0; c < sim->online_cpus; c++) {
+        Process *r = sim->cpus[c].current_process;
+        if (!r) {
+            idle++;
+            continue;
+        }
+        // Sift up by remaining time, lower priority first on ties
+        int i = size++;
+        while (i > 0) {
+            Process *parent = heap[(i - 1) / 2];
+            SimTime diff = remaining_estimate(r) - remaining_estimate(parent);
+            if (diff < 0 || (diff == 0 && r->priority >= parent->priority)) break;
+            heap[i] = parent;
+            i = (i - 1) / 2;
+        }
+        heap[i] = r;
+    }
+    if (idle > 0) return true;
+
+    // Arrivals in ascending remaining time (there are usually very few)
+    int *arrivals = sim->arrived_indices;
+    for (int a = 1; a < arrival_count; a++) {
+        int v = arrivals[a], b = a - 1;
+        while (b >= 0 && remaining_estimate(&sim->processes[arrivals[b]]) > remaining_estimate(&sim->processes[v])) {
+            arrivals[b + 1] = arrivals[b];
+            b--;
+        }
+        arrivals[b + 1] = v;
+    }
+
+    bool possible = false;
+    for (int a = 0; a < arrival_count && size > 0; a++) {
+        const Process *p = &sim->processes[arrivals[a]];
+        const Process *top = heap[0];
+        SimTime advantage = remaining_estimate(top) - remaining_estimate(p);
+        bool shorter = advantage > 0 || (advantage == 0 && p->priority > top->priority);
+        advantage -= threshold;
+        if (advantage < 0 || (advantage == 0 && p->priority <= top->priority)) {
+            if (shorter && threshold > 0) sim->preemption.suppressed++;
+            break;
+        }
+        possible = true;
+
+        // The arrival takes the top's CPU; the next arrival faces the next largest
+        Process *last = heap[--size];
+        int i = 0;
+        for (;;) {
+            int child = 2 * i + 1;
+            if (child >= size) break;
+            if (child + 1 < size) {
+                SimTime diff = remaining_estimate(heap[child + 1]) - remaining_estimate(heap[child]);
+                if (diff > 0 || (diff == 0 && heap[child + 1]->priority < heap[child]->priority)) child++;
+            }
+            SimTime diff = remaining_estimate(heap[child]) - remaining_estimate(last);
+            if (diff < 0 || (diff == 0 && heap[child]->priority >= last->priority)) break;
+            heap[i] = heap[child];
+            i = child;
+        }
+        if (size > 0) heap[i] = last;
+    }
+    return possible;
+}
+
+/**
+ * Wake processes whose storage writes have completed.
+ * Returns how many processes were woken.
+ */
+int handle_io_completions(Process *processes, int process_count, SimTime current_time, Algorithm algorithm,
+                          ReadyQueue *ready_queue) {
+    int woken = 0;
+    for (int i = 0; i < process_count; i++) {
+        Process *p = &processes[i];
+        if (p->state != BLOCKED || p->io_wake_time < 0 || p->io_wake_time > current_time) continue;
+
+        p->io_wake_time = -1;
+        if (algorithm == RR) {
+            p->state = READY;
+            enqueue(ready_queue, i);
+        } else {
+            p->state = WAITING;
+        }
+        woken++;
+    }
+    return woken;
+}
+
+/**
+ * Issue a page write for every running process that has reached the end of
+ * its current CPU interval, and block it until the device completes the write.
+ * Returns how many processes were blocked.
+ */
+int handle_io_requests(Process *processes, CPU *cpus, int cpu_count, Ssd *ssd, SimTime now) {
+    (void)processes;
+    int blocked = 0;
+    for (int c = 0; c < cpu_count; c++) {
+        Process *p = cpus[c].current_process;
+        if (!p || p->state != RUNNING || p->io_interval <= 0 || p->remaining_time <= 0) continue;
+
+        SimTime cpu_used = p->burst_time - p->remaining_time;
+        if (cpu_used == 0 || cpu_used % p->io_interval != 0) continue;
+
+        // Each process writes within its own region of the logical address space
+        int span = p->io_pages < ssd->logical_pages ? p->io_pages : ssd->logical_pages;
+        int base = (int)(((unsigned int)p->pid * 2654435761u) % (unsigned int)ssd->logical_pages);
+        int lpn = (base + (int)(xorshift32(&ssd->rng) % (unsigned int)span)) % ssd->logical_pages;
+
+        // The request is submitted once this step's execution has finished (now)
+        p->io_wake_time = ssd_write(ssd, lpn, now);
+        p->io_time += p->io_wake_time - now;
+        p->state = BLOCKED;
+        p->quantum_used = 0;
+        cpus[c].current_process = NULL;
+        blocked++;
+    }
+    return blocked;
+}
+
+/************************* MULTI-LEVEL QUEUE *************************/
+
+/**
+ * Level leading at time now under time-slice arbitration: frames of the
+ * listed levels' slices repeat, and each level leads during its own slice.
+ * Returns -1 under fixed-priority arbitration. If until_change is given it
+ * receives the time left until the lead moves on (SIMTIME_MAX if never).
+ */
+static int mlq_lead_level(const MlqOptions *mlq, SimTime now, SimTime *until_change) {
+    if (until_change) *until_change = SIMTIME_MAX;
+    if (!mlq->time_slice) return -1;
+
+    SimTime frame = 0;
+    for (int l = 0; l < mlq->level_count; l++) frame += mlq->slices[l];
+    SimTime offset = now % frame;
+    for (int l = 0; l < mlq->level_count; l++) {
+        if (offset < mlq->slices[l]) {
+            if (until_change) *until_change = mlq->slices[l] - offset;
+            return l;
+        }
+        offset -= mlq->slices[l];
+    }
+    return -1;
+}
+
+/**
+ * Rank of a process's level between classes (lower is served first)
+ */
+static int mlq_rank(const MlqOptions *mlq, int lead, const Process *p) {
+    int level = mlq->level_of[p->class_id];
+    return level == lead ? -1 : level;
+}
+
+/**
+ * Whether a should run before b, both waiting at the same level: in
+ * arrival order (FCFS), by job size (SJF) or in queueing order (RR)
+ */
+static bool mlq_before(const MlqOptions *mlq, const Process *a, const Process *b) {
+    switch (mlq->policies[mlq->level_of[a->class_id]]) {
+        case SJF:
+            if (job_size_estimate(a) != job_size_estimate(b)) return job_size_estimate(a) < job_size_estimate(b);
+            break;
+        case RR:
+            if (a->queued_at != b->queued_at) return a->queued_at < b->queued_at;
+            break;
+        default:
+            break;
+    }
+    return a->arrival_time < b->arrival_time;
+}
+
+/**
+ * The waiting process to run next, from the best-ranked level, or from
+ * the given level only (level >= 0). NULL if there is none.
+ */
+static Process *mlq_next(Simulation *sim, int lead, int level, SimTime current_time) {
+    const MlqOptions *mlq = &sim->options->mlq;
+    Process *best = NULL;
+    int best_rank = INT_MAX;
+    for (int i = 0; i < sim->process_count; i++) {
+        Process *p = &sim->processes[i];
+        if (p->state != WAITING || p->arrival_time > current_time) continue;
+        if (level >= 0 && mlq->level_of[p->class_id] != level) continue;
+        int rank = mlq_rank(mlq, lead, p);
+        if (!best || rank < best_rank || (rank == best_rank && mlq_before(mlq, p, best))) {
+            best = p;
+            best_rank = rank;
+        }
+    }
+    return best;
+}
+
+/**
+ * Multi-level queue scheduling.
+ *
+ * Each workload class is a level with its own policy. Between levels,
+ * fixed-priority arbitration always serves the higher level first, while
+ * time-slice arbitration lets each level lead for its slice of a repeating
+ * frame, the others following in priority order; either way CPUs a level
+ * leaves idle go to the next. A waiting process displaces the running
+ * process of the lowest level below its own, which keeps its place in its
+ * level's queue. Within RR levels a process that has used its quantum goes
+ * to the back of the queue once another process of its level is waiting.
+ */
+void handle_mlq_scheduling(Simulation *sim, SimTime current_time) {
+    const MlqOptions *mlq = &sim->options->mlq;
+    CPU *cpus = sim->cpus;
+    int cpu_count = sim->online_cpus;
+    int lead = mlq_lead_level(mlq, current_time, NULL);
+    long fresh = sim->mlq_tickets; // Processes rotated from here on wait for the next call
+
+    for (;;) {
+        for (;;) {
+            Process *best = mlq_next(sim, lead, -1, current_time);
+            if (!best) break;
+
+            // Prefer an idle CPU, otherwise the lowest-ranked process, the one furthest into its quantum
+            int target = -1;
+            for (int c = 0; c < cpu_count && target == -1; c++) {
+                if (!cpus[c].current_process) target = c;
+            }
+            if (target == -1) {
+                int victim = 0;
+                for (int c = 1; c < cpu_count; c++) {
+                    const Process *r = cpus[c].current_process, *v = cpus[victim].current_process;
+                    int rank = mlq_rank(mlq, lead, r), victim_rank = mlq_rank(mlq, lead, v);
+                    if (rank > victim_rank || (rank == victim_rank && r->quantum_used > v->quantum_used)) victim = c;
+                }
+                Process *r = cpus[victim].current_process;
+                if (mlq_rank(mlq, lead, best) >= mlq_rank(mlq, lead, r)) break;
+                r->state = WAITING;
+                r->quantum_used = 0;
+                target = victim;
+            }
+
+            best->state = RUNNING;
+            best->quantum_used = 0;
+            if (best->start_time == -1) {
+                best->start_time = current_time;
+                best->response_time = current_time - best->arrival_time;
+            }
+            cpus[target].current_process = best;
+        }
+
+        // Rotate the RR process furthest past its quantum behind a process of its level that
+        // was already waiting, then dispatch again; each waiting process relieves one
+        int rotate = -1;
+        for (int c = 0; c < cpu_count; c++) {
+            Process *r = cpus[c].current_process;
+            if (!r) continue;
+            int level = mlq->level_of[r->class_id];
+            if (mlq->policies[level] != RR || r->quantum_used < mlq->quanta[level]) continue;
+            if (rotate != -1 && r->quantum_used <= cpus[rotate].current_process->quantum_used) continue;
+            const Process *peer = mlq_next(sim, lead, level, current_time);
+            if (peer && peer->queued_at < fresh) rotate = c;
+        }
+        if (rotate == -1) return;
+        Process *r = cpus[rotate].current_process;
+        r->state = WAITING;
+        r->quantum_used = 0;
+        r->queued_at = sim->mlq_tickets++;
+        cpus[rotate].current_process = NULL;
+    }
+}
+
+/************************* POWER AND ENERGY *************************/
+
+/**
+ * Consolidation: unpark a core once runnable processes have outnumbered
+ * the idle online cores for UNPARK_PRESSURE_TICKS, and park the highest
+ * online core once it has been idle for PARK_IDLE_TICKS. Parked cores are
+ * power-gated. Other policies keep every core online.
+ */
+void energy_update_online(Simulation *sim) {
+    if (sim->options->energy.policy != ENERGY_CONSOLIDATE) return;
+
+    int busy = 0, idle_online = 0;
+    for (int c = 0; c < sim->cpu_count; c++) {
+        if (sim->cpus[c].current_process) busy++;
+        else if (c < sim->online_cpus) idle_online++;
+    }
+    long runnable = sim->arrived_count - sim->completed_count - busy - sim->blocked_count;
+
+    if (runnable > idle_online) {
+        if (++sim->pressure_ticks >= UNPARK_PRESSURE_TICKS && sim->online_cpus < sim->cpu_count) {
+            sim->online_cpus++;
+            sim->pressure_ticks = 0;
+        }
+    } else if (sim->online_cpus > 1) {
+        sim->pressure_ticks = 0;
+        int top = sim->online_cpus - 1;
+        if (!sim->cpus[top].current_process && sim->power[top].idle_ticks >= PARK_IDLE_TICKS) sim->online_cpus--;
+    }
+}
+
+/**
+ * Pick each CPU's frequency and idle state for this tick and charge its
+ * energy. A CPU that cannot make progress this tick (still waking, or not
+ * enough work credit at a low frequency) has its process held back from
+ * execute_processes until energy_after_execute.
+ */
+void energy_before_execute(Simulation *sim) {
+    EnergyPolicy policy = sim->options->energy.policy;
+    double seconds = sim->options->energy.tick_ms / 1000.0;
+    int deepest = policy == ENERGY_PERFORMANCE ? 1 : NUM_IDLE_STATES - 1;
+    int top_mhz = FREQ_LEVELS[NUM_FREQ_LEVELS - 1].mhz;
+
+    for (int c = 0; c < sim->cpu_count; c++) {
+        CpuPower *pw = &sim->power[c];
+        Process *p = sim->cpus[c].current_process;
+        pw->stalled = NULL;
+        pw->utilization = 0.7 * pw->utilization + 0.3 * (p != NULL);
+
+        if (!p && c >= sim->online_cpus) {
+            pw->parked = true;
+            pw->idle_state = -1;
+            pw->parked_ticks++;
+            continue;
+        }
+        if (!p) {
+            // Idle governor: deepest allowed state the idle period qualifies for
+            int state = 0;
+            while (state < deepest && IDLE_STATES[state + 1].target_residency <= pw->idle_ticks) state++;
+            if (pw->parked) pw->idle_ticks = 0;
+            pw->parked = false;
+            pw->idle_state = state;
+            pw->idle_ticks++;
+            pw->state_ticks[state]++;
+            pw->joules += IDLE_STATES[state].watts * seconds;
+            continue;
+        }
+
+        if (pw->parked) {
+            pw->parked = false;
+            pw->unparks++;
+            pw->waking = PARK_EXIT_LATENCY;
+            pw->idle_ticks = 0;
+        } else if (pw->idle_state >= 0) {
+            pw->wakeups[pw->idle_state]++;
+            pw->waking = IDLE_STATES[pw->idle_state].exit_latency;
+            pw->idle_state = -1;
+            pw->idle_ticks = 0;
+        }
+
+        switch (policy) {
+            case ENERGY_POWERSAVE:
+                pw->level = 0;
+                break;
+            case ENERGY_ONDEMAND:
+                pw->level = pw->utilization >= 0.8 ? NUM_FREQ_LEVELS - 1 :
+                            pw->utilization >= 0.4 ? NUM_FREQ_LEVELS / 2 : 0;
+                break;
+            default:
+                pw->level = NUM_FREQ_LEVELS - 1;
+                break;
+        }
+        pw->level_ticks[pw->level]++;
+        pw->joules += FREQ_LEVELS[pw->level].active_watts * seconds;
+
+        bool progress;
+        if (pw->waking > 0) {
+            pw->waking--;
+            pw->wake_ticks++;
+            progress = false;
+        } else {
+            pw->credit += (double)FREQ_LEVELS[pw->level].mhz / top_mhz;
+            progress = pw->credit >= 1.0 - 1e-9;
+            if (progress) pw->credit -= 1.0;
+        }
+        if (!progress) {
+            pw->stalled = p;
+            sim->cpus[c].current_process = NULL;
+        }
+    }
+}
+
+/**
+ * Put back the processes held back this tick; their CPUs were busy, not idle
+ */
+void energy_after_execute(Simulation *sim) {
+    for (int c = 0; c < sim->cpu_count; c++) {
+        CpuPower *pw = &sim->power[c];
+        if (!pw->stalled) continue;
+        sim->cpus[c].current_process = pw->stalled;
+        sim->cpus[c].idle_time--;
+        sim->cpus[c].busy_time++;
+        pw->stalled = NULL;
+    }
+}
+
+/************************* NUMA MODEL *************************/
+
+/**
+ * Set up the NUMA model: CPUs are split into equal contiguous blocks, one
+ * per node. Exits if a process's node= lies outside the machine.
+ */
+void numa_init(Simulation *sim) {
+    const NumaOptions *options = &sim->options->numa;
+    if (options->nodes > sim->cpu_count) {
+        fprintf(stderr, "Error: --numa %d needs at least as many CPUs (-c %d)\n", options->nodes, sim->cpu_count);
+        exit(EXIT_FAILURE);
+    }
+    NumaState *numa = (NumaState *)calloc(1, sizeof(NumaState));
+    if (!numa) {
+        perror("Failed to allocate NUMA state");
+        exit(EXIT_FAILURE);
+    }
+    numa->cpu_node = (int *)malloc(sim->cpu_count * sizeof(int));
+    numa->stalled = (Process **)calloc(sim->cpu_count, sizeof(Process *));
+    numa->local_ticks = (long *)calloc(options->nodes, sizeof(long));
+    numa->remote_ticks = (long *)calloc(options->nodes, sizeof(long));
+    if (!numa->cpu_node || !numa->stalled || !numa->local_ticks || !numa->remote_ticks) {
+        perror("Failed to allocate NUMA state");
+        exit(EXIT_FAILURE);
+    }
+    for (int c = 0; c < sim->cpu_count; c++) numa->cpu_node[c] = (int)((long)c * options->nodes / sim->cpu_count);
+    for (int i = 0; i < sim->process_count; i++) {
+        if (sim->processes[i].home_node >= options->nodes) {
+            fprintf(stderr, "Error: PID %d has home node %d, but there are only %d NUMA node(s)\n",
+                    sim->processes[i].pid, sim->processes[i].home_node, options->nodes);
+            exit(EXIT_FAILURE);
+        }
+    }
+    sim->numa = numa;
+}
+
+/**
+ * Release the NUMA model of a simulation
+ */
+void numa_cleanup(Simulation *sim) {
+    if (!sim->numa) return;
+    free(sim->numa->cpu_node);
+    free(sim->numa->stalled);
+    free(sim->numa->local_ticks);
+    free(sim->numa->remote_ticks);
+    free(sim->numa);
+    sim->numa = NULL;
+}
+
+/**
+ * Find an online CPU on node that is idle (home < 0) or runs a process
+ * whose home node is home. Returns -1 if there is none.
+ */
+static int numa_find_cpu(const Simulation *sim, int node, int home) {
+    for (int c = 0; c < sim->online_cpus; c++) {
+        if (sim->numa->cpu_node[c] != node) continue;
+        const Process *q = sim->cpus[c].current_process;
+        if (home < 0 ? !q : q && q->home_node == home) return c;
+    }
+    return -1;
+}
+
+/**
+ * Runs after the policy has dispatched. A process without a home node
+ * gets the node it first runs on (first touch). Under the local and
+ * balance policies, a process running off its home node then moves to an
+ * idle CPU there, or trades CPUs with a process there whose home is the
+ * node it is on, so both run locally.
+ */
+void numa_place(Simulation *sim) {
+    NumaState *numa = sim->numa;
+    CPU *cpus = sim->cpus;
+    for (int c = 0; c < sim->online_cpus; c++) {
+        Process *p = cpus[c].current_process;
+        if (p && p->home_node < 0) p->home_node = numa->cpu_node[c];
+    }
+    if (sim->options->numa.policy == NUMA_OBLIVIOUS) return;
+
+    for (int c = 0; c < sim->online_cpus; c++) {
+        Process *p = cpus[c].current_process;
+        if (!p || p->home_node == numa->cpu_node[c]) continue;
+
+        int d = numa_find_cpu(sim, p->home_node, -1);
+        if (d >= 0) {
+            cpus[d].current_process = p;
+            cpus[c].current_process = NULL;
+            numa->migrations++;
+            continue;
+        }
+        d = numa_find_cpu(sim, p->home_node, numa->cpu_node[c]);
+        if (d >= 0) {
+            cpus[c].current_process = cpus[d].current_process;
+            cpus[d].current_process = p;
+            numa->migrations += 2;
+        }
+    }
+}
+
+/**
+ * Charge this tick's CPU time as local or remote, and slow down remote
+ * execution: a process off its home node completes 1/penalty of a tick's
+ * work per tick, so it is held back from execute_processes on ticks where
+ * it has not accumulated a whole tick of work. Under the balance policy a
+ * process that has run remotely for NUMA_MIGRATE_TICKS consecutive ticks
+ * has its memory moved to the node it runs on, stalling it for
+ * NUMA_MIGRATE_COST ticks.
+ */
+void numa_before_execute(Simulation *sim) {
+    NumaState *numa = sim->numa;
+    const NumaOptions *options = &sim->options->numa;
+    for (int c = 0; c < sim->cpu_count; c++) {
+        Process *p = sim->cpus[c].current_process;
+        numa->stalled[c] = NULL;
+        if (!p) continue;
+
+        int node = numa->cpu_node[c];
+        bool remote = p->home_node != node;
+        if (remote) {
+            p->remote_time++;
+            numa->remote_ticks[node]++;
+        } else {
+            p->local_time++;
+            numa->local_ticks[node]++;
+        }
+
+        if (remote && options->policy == NUMA_BALANCE && ++p->remote_streak >= NUMA_MIGRATE_TICKS) {
+            p->home_node = node;
+            p->numa_credit -= NUMA_MIGRATE_COST;
+            numa->memory_migrations++;
+        }
+        if (!remote || p->home_node == node) p->remote_streak = 0;
+
+        p->numa_credit += remote ? 1.0 / options->penalty : 1.0;
+        if (p->numa_credit >= 1.0 - 1e-9) {
+            p->numa_credit -= 1.0;
+        } else {
+            numa->stalled[c] = p;
+            sim->cpus[c].current_process = NULL;
+        }
+    }
+}
+
+/**
+ * Put back the processes held back this tick; their CPUs were busy, not idle
+ */
+void numa_after_execute(Simulation *sim) {
+    NumaState *numa = sim->numa;
+    for (int c = 0; c < sim->cpu_count; c++) {
+        if (!numa->stalled[c]) continue;
+        sim->cpus[c].current_process = numa->stalled[c];
+        sim->cpus[c].idle_time--;
+        sim->cpus[c].busy_time++;
+        numa->stalled[c] = NULL;
+    }
+}
+
+/************************* CPU BANDWIDTH CONTROL *************************/
+
+static void timer_push(Simulation *sim, SimTime time, int bucket) {
+    int i = sim->timer_count++;
+    while (i > 0 && sim->timers[(i - 1) / 2].time > time) {
+        sim->timers[i] = sim->timers[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    sim->timers[i].time = time;
+    sim->timers[i].bucket = bucket;
+}
+
+static RefillTimer timer_pop(Simulation *sim) {
+    RefillTimer top = sim->timers[0];
+    RefillTimer last = sim->timers[--sim->timer_count];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= sim->timer_count) break;
+        if (child + 1 < sim->timer_count && sim->timers[child + 1].time < sim->timers[child].time) child++;
+        if (sim->timers[child].time >= last.time) break;
+        sim->timers[i] = sim->timers[child];
+        i = child;
+    }
+    if (sim->timer_count > 0) sim->timers[i] = last;
+    return top;
+}
+
+/**
+ * Charge a process to its own bandwidth bucket (cpu.max=) or to its
+ * class's (--cpu-max), creating the bucket tables on first use
+ */
+void bandwidth_register_process(Simulation *sim, Process *p) {
+    const BandwidthOptions *limits = &sim->options->bandwidth;
+    if (p->bw_quota == 0 && limits->quota[p->class_id] == 0) return;
+
+    if (!sim->uses_bandwidth) {
+        int capacity = MAX_CLASSES + (sim->process_capacity > 0 ? sim->process_capacity : 1);
+        sim->buckets = (Bucket *)calloc(capacity, sizeof(Bucket));
+        sim->timers = (RefillTimer *)malloc(capacity * sizeof(RefillTimer));
+        if (!sim->buckets || !sim->timers) {
+            perror("Failed to allocate bandwidth buckets");
+            exit(EXIT_FAILURE);
+        }
+        for (int c = 0; c < MAX_CLASSES; c++) {
+            sim->buckets[c].quota = limits->quota[c];
+            sim->buckets[c].period = limits->period[c];
+            sim->buckets[c].owner_pid = -1;
+        }
+        sim->bucket_count = MAX_CLASSES;
+        sim->uses_bandwidth = true;
+    }
+
+    if (p->bw_quota > 0) {
+        Bucket *own = &sim->buckets[sim->bucket_count];
+        own->quota = p->bw_quota;
+        own->period = p->bw_period;
+        own->owner_pid = p->pid;
+        p->bucket = sim->bucket_count++;
+    } else {
+        p->bucket = p->class_id;
+    }
+
+    Bucket *b = &sim->buckets[p->bucket];
+    if (b->member_count == b->member_capacity) {
+        b->member_capacity = b->member_capacity ? 2 * b->member_capacity : 8;
+        b->members = (int *)realloc(b->members, b->member_capacity * sizeof(int));
+        if (!b->members) {
+            perror("Failed to allocate bandwidth group");
+            exit(EXIT_FAILURE);
+        }
+    }
+    b->members[b->member_count++] = (int)(p - sim->processes);
+}
+
+/**
+ * Take a runnable process off its CPU or out of the ready structures
+ */
+static void throttle_process(Simulation *sim, Process *p, SimTime since) {
+    if (p->state == RUNNING) {
+        for (int c = 0; c < sim->cpu_count; c++) {
+            if (sim->cpus[c].current_process == p) sim->cpus[c].current_process = NULL;
+        }
+        p->quantum_used = 0;
+    }
+    p->state = THROTTLED;
+    p->throttle_start = since;
+}
+
+/**
+ * Drop processes that are no longer READY from the RR queue
+ */
+static void purge_ready_queue(Simulation *sim) {
+    int size = sim->ready_queue_rr.size;
+    for (int n = 0; n < size; n++) {
+        int index = dequeue(&sim->ready_queue_rr);
+        if (sim->processes[index].state == READY) enqueue(&sim->ready_queue_rr, index);
+    }
+}
+
+/**
+ * Refill the buckets whose period ended, returning their throttled members
+ * to the ready structures. Only buckets with a pending timer are touched.
+ * Returns how many processes were released.
+ */
+int handle_bandwidth_refills(Simulation *sim) {
+    int released = 0;
+    while (sim->timer_count > 0 && sim->timers[0].time <= sim->current_time) {
+        Bucket *b = &sim->buckets[timer_pop(sim).bucket];
+        b->used = 0;
+        b->refill_pending = false;
+        if (!b->throttled) continue;
+
+        b->throttled = false;
+        for (int m = 0; m < b->member_count; m++) {
+            Process *p = &sim->processes[b->members[m]];
+            if (p->state != THROTTLED) continue;
+            p->throttled_time += sim->current_time - p->throttle_start;
+            if (sim->algorithm == RR) {
+                p->state = READY;
+                enqueue(&sim->ready_queue_rr, b->members[m]);
+            } else {
+                p->state = WAITING;
+            }
+            released++;
+        }
+    }
+    return released;
+}
+
+/**
+ * Hold back this tick's arrivals whose group is out of bandwidth, removing
+ * them from arrived_indices. Returns how many were throttled.
+ */
+int handle_throttled_arrivals(Simulation *sim, int *arrival_count) {
+    int kept = 0, throttled = 0;
+    for (int a = 0; a < *arrival_count; a++) {
+        Process *p = &sim->processes[sim->arrived_indices[a]];
+        if (p->bucket >= 0 && sim->buckets[p->bucket].throttled) {
+            throttle_process(sim, p, sim->current_time);
+            throttled++;
+        } else {
+            sim->arrived_indices[kept++] = sim->arrived_indices[a];
+        }
+    }
+    *arrival_count = kept;
+    return throttled;
+}
+
+/**
+ * Send back processes that were dispatched although their group is out of
+ * bandwidth (woken from I/O or a lock mid-period). Returns how many.
+ */
+int handle_throttled_dispatch(Simulation *sim) {
+    int throttled = 0;
+    for (int c = 0; c < sim->cpu_count; c++) {
+        Process *p = sim->cpus[c].current_process;
+        if (p && p->bucket >= 0 && sim->buckets[p->bucket].throttled) {
+            throttle_process(sim, p, sim->current_time);
+            throttled++;
+        }
+    }
+    return throttled;
+}
+
+/**
+ * Charge this step's CPU time to the buckets of the processes that ran.
+ * A bucket's first charge in a period arms its refill timer; a bucket that
+ * reaches its quota throttles all its runnable members until the refill.
+ * Steps never cross a period boundary or a quota exhaustion (see
+ * sim_next_event), so the charge lands in the step's last tick.
+ * Returns how many processes were throttled.
+ */
+int charge_bandwidth(Simulation *sim, SimTime elapsed) {
+    int throttled = 0;
+    SimTime t = sim->current_time + elapsed - 1;
+    bool purge = false;
+    for (int c = 0; c < sim->cpu_count; c++) {
+        Process *p = sim->running[c];
+        if (!p || p->bucket < 0) continue;
+
+        Bucket *b = &sim->buckets[p->bucket];
+        b->used += elapsed;
+        if (!b->refill_pending) {
+            timer_push(sim, (t / b->period + 1) * b->period, p->bucket);
+            b->refill_pending = true;
+        }
+        if (b->throttled || b->used < b->quota) continue;
+
+        b->throttled = true;
+        b->throttle_count++;
+        for (int m = 0; m < b->member_count; m++) {
+            Process *q = &sim->processes[b->members[m]];
+            bool runnable = q->state == RUNNING || q->state == READY ||
+                            (q->state == WAITING && q->arrival_time <= t);
+            if (!runnable) continue;
+            if (q->state == READY) purge = true;
+            throttle_process(sim, q, t + 1);
+            throttled++;
+        }
+    }
+    if (purge) purge_ready_queue(sim);
+    return throttled;
+}
+
+/************************* SHARED LOCKS *************************/
+
+/**
+ * Make a process's critical sections known to the lock table: raise the
+ * ceilings of the locks it uses and allocate wait queues on first use
+ */
+void lock_register_process(Simulation *sim, const Process *p) {
+    if (p->lock_use_count == 0) return;
+
+    if (!sim->uses_locks) {
+        int capacity = sim->process_capacity > 0 ? sim->process_capacity : 1;
+        for (int l = 0; l < MAX_LOCKS; l++) {
+            sim->locks[l].ceiling = INT_MIN;
+            sim->locks[l].waiters = (int *)malloc(capacity * sizeof(int));
+            if (!sim->locks[l].waiters) {
+                perror("Failed to allocate lock wait queue");
+                exit(EXIT_FAILURE);
+            }
+        }
+        sim->uses_locks = true;
+    }
+    for (int u = 0; u < p->lock_use_count; u++) {
+        SimLock *lock = &sim->locks[p->lock_uses[u].lock];
+        if (p->base_priority > lock->ceiling) lock->ceiling = p->base_priority;
+    }
+}
+
+/**
+ * Recompute the effective priority of every process involved with a lock.
+ * Owners start from their base priority and are raised to the ceilings of
+ * the locks they hold (ceiling protocol) or to the priority of their
+ * waiters (inheritance); boosts propagate along chains of blocked owners.
+ */
+static void lock_refresh_priorities(Simulation *sim) {
+    LockProtocol protocol = sim->options->lock_protocol;
+    for (int l = 0; l < MAX_LOCKS; l++) {
+        SimLock *lock = &sim->locks[l];
+        if (lock->owner) lock->owner->priority = lock->owner->base_priority;
+        for (int w = 0; w < lock->waiter_count; w++) {
+            Process *waiter = &sim->processes[lock->waiters[w]];
+            waiter->priority = waiter->base_priority;
+        }
+    }
+    if (protocol == LOCK_PROTOCOL_NONE) return;
+
+    // Priorities only rise, so this settles within one pass per link in the longest chain
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (int l = 0; l < MAX_LOCKS; l++) {
+            SimLock *lock = &sim->locks[l];
+            if (!lock->owner) continue;
+
+            int boost = protocol == LOCK_PROTOCOL_CEILING ? lock->ceiling : INT_MIN;
+            if (protocol == LOCK_PROTOCOL_INHERIT) {
+                for (int w = 0; w < lock->waiter_count; w++) {
+                    int waiter_priority = sim->processes[lock->waiters[w]].priority;
+                    if (waiter_priority > boost) boost = waiter_priority;
+                }
+            }
+            if (boost > lock->owner->priority) {
+                lock->owner->priority = boost;
+                changed = true;
+            }
+        }
+    }
+}
+
+/**
+ * Take the locks that processes about to run reach at their current point
+ * in the burst. A process that finds its lock held is blocked in the lock's
+ * wait queue and loses its CPU. Returns how many processes were blocked, so
+ * the caller can fill the freed CPUs again.
+ */
+int handle_lock_acquires(Simulation *sim) {
+    int blocked = 0;
+    bool changed = false;
+    for (int c = 0; c < sim->cpu_count; c++) {
+        Process *p = sim->cpus[c].current_process;
+        if (!p) continue;
+
+        SimTime attained = p->burst_time - p->remaining_time;
+        for (int u = 0; u < p->lock_use_count; u++) {
+            const LockUse *use = &p->lock_uses[u];
+            if (use->acquire_at != attained || (p->locks_held & (1 << u))) continue;
+
+            SimLock *lock = &sim->locks[use->lock];
+            if (!lock->owner) {
+                lock->owner = p;
+                lock->acquisitions++;
+                p->locks_held |= 1 << u;
+                changed = true;
+                continue;
+            }
+
+            lock->contended++;
+            lock->waiters[lock->waiter_count++] = (int)(p - sim->processes);
+            p->blocked_on = use->lock;
+            p->io_wake_time = -1;
+            p->state = BLOCKED;
+            p->quantum_used = 0;
+            sim->cpus[c].current_process = NULL;
+            blocked++;
+            changed = true;
+            break;
+        }
+    }
+    if (changed) lock_refresh_priorities(sim);
+    return blocked;
+}
+
+/**
+ * Release the locks of processes that just ran past the end of a critical
+ * section (or completed) and hand each one to its highest-priority waiter.
+ * Returns how many waiters were woken.
+ */
+int handle_lock_releases(Simulation *sim) {
+    int woken = 0;
+    bool changed = false;
+    for (int c = 0; c < sim->cpu_count; c++) {
+        Process *p = sim->running[c];
+        if (!p || !p->locks_held) continue;
+
+        SimTime attained = p->burst_time - p->remaining_time;
+        for (int u = 0; u < p->lock_use_count; u++) {
+            if (!(p->locks_held & (1 << u))) continue;
+            if (p->state != COMPLETED && attained < p->lock_uses[u].release_at) continue;
+
+            SimLock *lock = &sim->locks[p->lock_uses[u].lock];
+            p->locks_held &= ~(1 << u);
+            p->priority = p->base_priority; // Re-raised below if it still holds another lock
+            lock->owner = NULL;
+            changed = true;
+            if (lock->waiter_count == 0) continue;
+
+            // Highest priority waiter, first come first served on ties
+            int best = 0;
+            for (int w = 1; w < lock->waiter_count; w++) {
+                if (sim->processes[lock->waiters[w]].priority > sim->processes[lock->waiters[best]].priority) {
+                    best = w;
+                }
+            }
+            int index = lock->waiters[best];
+            memmove(&lock->waiters[best], &lock->waiters[best + 1],
+                    (lock->waiter_count - best - 1) * sizeof(int));
+            lock->waiter_count--;
+
+            Process *next = &sim->processes[index];
+            SimTime next_attained = next->burst_time - next->remaining_time;
+            for (int v = 0; v < next->lock_use_count; v++) {
+                if (next->lock_uses[v].lock == lock - sim->locks &&
+                    next->lock_uses[v].acquire_at == next_attained && !(next->locks_held & (1 << v))) {
+                    next->locks_held |= 1 << v;
+                    break;
+                }
+            }
+            lock->owner = next;
+            lock->acquisitions++;
+            next->blocked_on = -1;
+            if (sim->algorithm == RR) {
+                next->state = READY;
+                enqueue(&sim->ready_queue_rr, index);
+            } else {
+                next->state = WAITING;
+            }
+            woken++;
+        }
+    }
+    if (changed) lock_refresh_priorities(sim);
+    return woken;
+}
+
+/**
+ * Charge a step of elapsed time units of lock waiting to every blocked
+ * process, and of priority inversion to those stuck behind a lower-priority owner
+ */
+void account_lock_waits(Simulation *sim, SimTime elapsed) {
+    for (int l = 0; l < MAX_LOCKS; l++) {
+        SimLock *lock = &sim->locks[l];
+        for (int w = 0; w < lock->waiter_count; w++) {
+            Process *waiter = &sim->processes[lock->waiters[w]];
+            waiter->lock_wait_time += elapsed;
+            if (lock->owner->base_priority < waiter->base_priority) waiter->inversion_time += elapsed;
+        }
+    }
+}
+
+/************************* TIME-SERIES METRICS *************************/
+
+/**
+ * Histogram bucket of a response time: exact below WINDOW_EXACT_BUCKETS,
+ * then WINDOW_SUB_BUCKETS per power of two (at most 12.5% relative error)
+ */
+static int window_bucket(SimTime value) {
+    if (value < WINDOW_EXACT_BUCKETS) return value < 0 ? 0 : (int)value;
+    int exponent = 0;
+    while ((value >> exponent) >= 2 * WINDOW_SUB_BUCKETS) exponent++;
+    return WINDOW_EXACT_BUCKETS + (exponent - 3) * WINDOW_SUB_BUCKETS + (int)((value >> exponent) - WINDOW_SUB_BUCKETS);
+}
+
+/**
+ * Smallest response time that falls into a bucket
+ */
+static SimTime window_bucket_value(int bucket) {
+    if (bucket < WINDOW_EXACT_BUCKETS) return bucket;
+    int exponent = (bucket - WINDOW_EXACT_BUCKETS) / WINDOW_SUB_BUCKETS + 3;
+    int sub = (bucket - WINDOW_EXACT_BUCKETS) % WINDOW_SUB_BUCKETS;
+    return (SimTime)(WINDOW_SUB_BUCKETS + sub) << exponent;
+}
+
+/**
+ * Nearest-rank percentile of the window's response histogram (-1 if empty)
+ */
+static SimTime window_percentile(const WindowStats *w, double pct) {
+    if (w->response_count == 0) return -1;
+    int rank = (int)(pct / 100.0 * w->response_count + 0.999999);
+    if (rank < 1) rank = 1;
+    int seen = 0;
+    for (int b = 0; b < WINDOW_RESPONSE_BUCKETS; b++) {
+        seen += w->responses[b];
+        if (seen >= rank) return window_bucket_value(b);
+    }
+    return window_bucket_value(WINDOW_RESPONSE_BUCKETS - 1);
+}
+
+/**
+ * Start a time-series file: a CSV header, or for binary output the magic
+ * "SCHEDWIN", then version and CPU count as int32 and window width as int64
+ */
+void window_open(WindowStats *w, const WindowOptions *options, int cpu_count) {
+    memset(w, 0, sizeof(*w));
+    w->out = fopen(options->path, options->binary ? "wb" : "w");
+    if (!w->out) {
+        perror("Error opening window output file");
+        exit(EXIT_FAILURE);
+    }
+    w->binary = options->binary;
+    w->width = options->width;
+    w->cpu_count = cpu_count;
+    w->cpu_busy = (long *)calloc(cpu_count, sizeof(long));
+    if (!w->cpu_busy) {
+        perror("Failed to allocate window counters");
+        exit(EXIT_FAILURE);
+    }
+
+    if (w->binary) {
+        int32_t header[2] = {2, cpu_count};
+        int64_t width = options->width;
+        fwrite("SCHEDWIN", 1, 8, w->out);
+        fwrite(header, sizeof(int32_t), 2, w->out);
+        fwrite(&width, sizeof(int64_t), 1, w->out);
+    } else {
+        fprintf(w->out, "Start,End,Arrivals,Completions,Preemptions,AvgRunQueue,PeakRunQueue,P50Response,P99Response");
+        for (int c = 0; c < cpu_count; c++) fprintf(w->out, ",CPU%d_Util%%", c);
+        fprintf(w->out, "\n");
+    }
+}
+
+/**
+ * Count the response time of a job that completed in the current window
+ */
+void window_record_response(WindowStats *w, SimTime response_time) {
+    w->responses[window_bucket(response_time)]++;
+    w->response_count++;
+}
+
+/**
+ * Write the row for ticks [w->start, end) and reset the counters.
+ * Binary rows are int64 start, end, int32 arrivals, completions,
+ * preemptions, float average run queue, int32 peak, int64 p50, p99, then
+ * one float utilization per CPU.
+ */
+static void window_flush(WindowStats *w, SimTime end) {
+    SimTime ticks = end - w->start;
+    if (ticks <= 0) return;
+
+    double avg_queue = (double)w->queue_area / (double)ticks;
+    SimTime p50 = window_percentile(w, 50.0);
+    SimTime p99 = window_percentile(w, 99.0);
+
+    if (w->binary) {
+        int64_t range[2] = {w->start, end};
+        int32_t counts[3] = {(int32_t)w->arrivals, (int32_t)w->completions, (int32_t)w->preemptions};
+        float queue = (float)avg_queue;
+        int32_t peak = w->queue_peak;
+        int64_t tail[2] = {p50, p99};
+        fwrite(range, sizeof(int64_t), 2, w->out);
+        fwrite(counts, sizeof(int32_t), 3, w->out);
+        fwrite(&queue, sizeof(float), 1, w->out);
+        fwrite(&peak, sizeof(int32_t), 1, w->out);
+        fwrite(tail, sizeof(int64_t), 2, w->out);
+        for (int c = 0; c < w->cpu_count; c++) {
+            float utilization = (float)(100.0 * (double)w->cpu_busy[c] / (double)ticks);
+            fwrite(&utilization, sizeof(float), 1, w->out);
+        }
+    } else {
+        fprintf(w->out, "%lld,%lld,%ld,%ld,%ld,%.2f,%d,", w->start, end, w->arrivals, w->completions,
+                w->preemptions, avg_queue, w->queue_peak);
+        if (p50 >= 0) fprintf(w->out, "%lld,%lld", p50, p99);
+        else fprintf(w->out, ",");
+        for (int c = 0; c < w->cpu_count; c++) {
+            fprintf(w->out, ",%.2f", 100.0 * (double)w->cpu_busy[c] / (double)ticks);
+        }
+        fprintf(w->out, "\n");
+    }
+
+    w->start = end;
+    memset(w->cpu_busy, 0, w->cpu_count * sizeof(long));
+    w->arrivals = w->completions = w->preemptions = 0;
+    w->queue_area = 0;
+    w->queue_peak = 0;
+    memset(w->responses, 0, sizeof(w->responses));
+    w->response_count = 0;
+}
+
+/**
+ * Close out the step of elapsed ticks from current_time: queue_during
+ * runnable processes waited for a CPU at the end of each tick but the last,
+ * which ended with queue_length. Emits a row when the window is full (steps
+ * never cross a window boundary).
+ */
+void window_end_tick(WindowStats *w, SimTime current_time, SimTime elapsed, int queue_during, int queue_length) {
+    w->queue_area += queue_during * (elapsed - 1) + queue_length;
+    if (elapsed > 1 && queue_during > w->queue_peak) w->queue_peak = queue_during;
+    if (queue_length > w->queue_peak) w->queue_peak = queue_length;
+    SimTime end = current_time + elapsed;
+    if (end - w->start >= w->width) window_flush(w, end);
+}
+
+/**
+ * Emit the final partial window and close the file
+ */
+void window_close(WindowStats *w, SimTime end_time) {
+    window_flush(w, end_time);
+    fclose(w->out);
+    free(w->cpu_busy);
+    w->out = NULL;
+}
+
+/************************* CHECKPOINTS *************************/
+
+/*
+ * A checkpoint file lets an edited workload be re-simulated from the last
+ * point before the edits can matter instead of from zero. Layout (host byte
+ * order, tied to the build that wrote it through sizeof(Process)):
+ *
+ *   "SCHEDCKP", int32 version (2), sizeof(Process), algorithm, CPU count,
+ *   process count; int64 quantum, preemption threshold, interval, TICK_NS
+ *   the workload as loaded: Process[process count]
+ *   checkpoints: int64 time, int64 changes size, int64 state size, then
+ *     changes: int32 record count, then a CheckpointRecord for every process
+ *       that finished since the last checkpoint;
+ *       int32 timeline rows since the last checkpoint (-1: timeline dropped),
+ *       then a pid (or -1) per CPU for each row
+ *     state: int64 arrived count; int32 completed count, blocked count,
+ *       SRTF recheck; PreemptionStats;
+ *       per CPU: int64 idle time, int64 busy time, int32 process (-1: idle);
+ *       int32 RR queue length, then the process of each entry;
+ *       int32 record count, then a CheckpointRecord for every arrived
+ *       process still unfinished
+ *   footer: int32 checkpoint count, then per checkpoint int64 time and
+ *     int64 offset; int64 footer offset, "SCHEDIDX"
+ *
+ * Processes are identified by their index in the stored workload, and
+ * records hold only the fields a run changes. A process is untouched until
+ * it arrives, so the state at a checkpoint taken no later than the first
+ * arrival an edit touches is also the state of the edited workload at that
+ * time. Resuming needs that checkpoint's state and the changes of every
+ * checkpoint up to it, and no other state section.
+ */
+
+typedef struct {
+    int pid;
+    int index;
+} PidIndex;
+
+static int compare_pid_index(const void *a, const void *b) {
+    const PidIndex *x = (const PidIndex *)a, *y = (const PidIndex *)b;
+    if (x->pid != y->pid) return x->pid < y->pid ? -1 : 1;
+    return x->index - y->index;
+}
+
+/**
+ * Processes sorted by PID, for matching them up across workloads
+ */
+static PidIndex *pid_index_build(const Process *processes, int count, bool *duplicates) {
+    PidIndex *map = (PidIndex *)malloc((count > 0 ? count : 1) * sizeof(PidIndex));
+    if (!map) {
+        perror("Failed to allocate PID index");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < count; i++) map[i] = (PidIndex){processes[i].pid, i};
+    qsort(map, count, sizeof(PidIndex), compare_pid_index);
+    *duplicates = false;
+    for (int i = 1; i < count; i++) {
+        if (map[i].pid == map[i - 1].pid) *duplicates = true;
+    }
+    return map;
+}
+
+/**
+ * Index of the process with this PID; -1 if there is none
+ */
+static int pid_index_find(const PidIndex *map, int count, int pid) {
+    int lo = 0, hi = count - 1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (map[mid].pid == pid) return map[mid].index;
+        if (map[mid].pid < pid) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return -1;
+}
+
+/**
+ * Whether two process records describe the same job
+ */
+static bool same_definition(const Process *a, const Process *b) {
+    if (a->pid != b->pid || a->arrival_time != b->arrival_time || a->burst_time != b->burst_time ||
+        a->priority != b->priority || a->io_interval != b->io_interval || a->io_pages != b->io_pages ||
+        a->class_id != b->class_id || a->bw_quota != b->bw_quota || a->bw_period != b->bw_period ||
+        a->lock_use_count != b->lock_use_count || a->home_node != b->home_node) {
+        return false;
+    }
+    for (int u = 0; u < a->lock_use_count; u++) {
+        const LockUse *x = &a->lock_uses[u], *y = &b->lock_uses[u];
+        if (x->lock != y->lock || x->acquire_at != y->acquire_at || x->release_at != y->release_at) return false;
+    }
+    return true;
+}
+
+/**
+ * Earliest time at which the edited workload can be scheduled differently
+ * from the base one: the first arrival of a process that was added,
+ * removed or changed. SIMTIME_MAX if nothing changed; 0 if the processes
+ * cannot be matched up (duplicate PIDs, or reordered lines, which would
+ * change how ties are broken).
+ */
+SimTime workload_first_change(const Process *base, int base_count, const Process *edited, int edited_count) {
+    bool base_duplicates, edited_duplicates;
+    PidIndex *base_map = pid_index_build(base, base_count, &base_duplicates);
+    PidIndex *edited_map = pid_index_build(edited, edited_count, &edited_duplicates);
+    SimTime first = SIMTIME_MAX;
+    if (base_duplicates || edited_duplicates) first = 0;
+
+    int last_base_index = -1;
+    for (int i = 0; i < edited_count && first > 0; i++) {
+        const Process *p = &edited[i];
+        int b = pid_index_find(base_map, base_count, p->pid);
+        if (b == -1) {
+            if (p->arrival_time < first) first = p->arrival_time;
+            continue;
+        }
+        if (b < last_base_index) first = 0;
+        last_base_index = b;
+        if (!same_definition(p, &base[b])) {
+            SimTime t = p->arrival_time < base[b].arrival_time ? p->arrival_time : base[b].arrival_time;
+            if (t < first) first = t;
+        }
+    }
+    for (int i = 0; i < base_count && first > 0; i++) {
+        if (pid_index_find(edited_map, edited_count, base[i].pid) == -1 && base[i].arrival_time < first) {
+            first = base[i].arrival_time;
+        }
+    }
+
+    free(base_map);
+    free(edited_map);
+    return first;
+}
+
+static void checkpoint_read(FILE *file, void *data, size_t size, const char *path) {
+    if (fread(data, 1, size, file) != size) {
+        fprintf(stderr, "Error: %s is not a valid checkpoint file\n", path);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void checkpoint_put(CheckpointWriter *w, const void *data, size_t size) {
+    if (fwrite(data, 1, size, w->file) != size) {
+        perror("Error writing checkpoint file");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Read the next size bytes of a checkpoint section
+ */
+static void checkpoint_take(char **cursor, const char *end, void *data, size_t size, const char *path) {
+    if ((size_t)(end - *cursor) < size) {
+        fprintf(stderr, "Error: %s has a truncated checkpoint\n", path);
+        exit(EXIT_FAILURE);
+    }
+    memcpy(data, *cursor, size);
+    *cursor += size;
+}
+
+/**
+ * Turn a process index read from a checkpoint into the index of the same
+ * process in the resumed workload, rewriting it in place at 'at' so the
+ * section can be copied on
+ */
+static int checkpoint_rekey(char *at, int32_t index, const int *remap, int base_count, const char *path) {
+    if (index < 0 || index >= base_count || remap[index] == -1) {
+        fprintf(stderr, "Error: %s does not match the workload\n", path);
+        exit(EXIT_FAILURE);
+    }
+    index = remap[index];
+    memcpy(at, &index, sizeof(index));
+    return index;
+}
+
+static void checkpoint_put_process(CheckpointWriter *w, int index, const Process *p) {
+    CheckpointRecord r = {index, p->state, p->remaining_time, p->quantum_used, p->start_time, p->finish_time,
+                          p->response_time, p->waiting_time, p->io_time, p->lock_wait_time};
+    checkpoint_put(w, &r, sizeof(r));
+}
+
+/**
+ * Restore the process records of a checkpoint section, rekeying them
+ */
+static void checkpoint_take_processes(Simulation *sim, char **cursor, const char *end, const int *remap,
+                                      int base_count, bool apply, const char *path) {
+    int32_t records;
+    checkpoint_take(cursor, end, &records, sizeof(records), path);
+    for (int r = 0; r < records; r++) {
+        CheckpointRecord record;
+        char *at = *cursor;
+        checkpoint_take(cursor, end, &record, sizeof(record), path);
+        int i = checkpoint_rekey(at, record.index, remap, base_count, path);
+        if (!apply) continue;
+        Process *p = &sim->processes[i];
+        p->state = (ProcessState)record.state;
+        p->remaining_time = record.remaining_time;
+        p->quantum_used = record.quantum_used;
+        p->start_time = record.start_time;
+        p->finish_time = record.finish_time;
+        p->response_time = record.response_time;
+        p->waiting_time = record.waiting_time;
+        p->io_time = record.io_time;
+        p->lock_wait_time = record.lock_wait_time;
+    }
+}
+
+/**
+ * Open a checkpoint file and read its header
+ */
+static FILE *checkpoint_open_header(const char *path, int32_t *header, int64_t *config) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        perror("Error opening checkpoint file");
+        exit(EXIT_FAILURE);
+    }
+    char magic[8];
+    checkpoint_read(file, magic, sizeof(magic), path);
+    checkpoint_read(file, header, 5 * sizeof(int32_t), path);
+    checkpoint_read(file, config, 4 * sizeof(int64_t), path);
+    if (memcmp(magic, "SCHEDCKP", 8) != 0 || header[0] != 2 || header[1] != (int32_t)sizeof(Process)) {
+        fprintf(stderr, "Error: %s is not a version 2 checkpoint file from this build\n", path);
+        exit(EXIT_FAILURE);
+    }
+    return file;
+}
+
+/**
+ * Take the configuration of the run that wrote a checkpoint file; a resumed
+ * run must match it exactly
+ */
+void checkpoint_read_config(const char *path, Algorithm *algorithm, int *cpu_count, SimTime *time_quantum,
+                            SimOptions *options) {
+    int32_t header[5];
+    int64_t config[4];
+    fclose(checkpoint_open_header(path, header, config));
+    *algorithm = (Algorithm)header[2];
+    *cpu_count = header[3];
+    *time_quantum = config[0];
+    options->preemption.threshold = config[1];
+    if (config[1] > 0) options->preemption.report = true; // As --preempt-threshold implies
+    options->checkpoint.interval = config[2];
+    TICK_NS = config[3];
+}
+
+/**
+ * Refuse a checkpointed or resumed run that uses anything beyond the core
+ * scheduler state a checkpoint holds. Called once the workload is loaded and
+ * before anything is simulated.
+ */
+void checkpoint_check_support(const SimOptions *options, Algorithm algorithm, const Process *processes,
+                              int process_count) {
+    if (!options->checkpoint.path && !options->checkpoint.resume) return;
+
+    bool cpu_max = false;
+    for (int c = 0; c < MAX_CLASSES; c++) cpu_max |= options->bandwidth.quota[c] > 0;
+    if (options->ssd.enabled || options->prediction.mode != PREDICT_NONE || options->window.width > 0 ||
+        options->energy.policy != ENERGY_OFF || options->numa.nodes > 0 || options->cluster.hosts > 1 ||
+        options->whatif.branch_count > 0 || options->sweep.quantum_count > 0 || algorithm == MLQ || cpu_max) {
+        fprintf(stderr, "Error: --checkpoint and --resume cannot be combined with --ssd, --predict, --window, "
+                        "--energy, --numa, --hosts, --whatif, sweeps, MLQ or --cpu-max\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < process_count; i++) {
+        if (processes[i].lock_use_count > 0 || processes[i].bw_quota > 0) {
+            fprintf(stderr, "Error: Checkpoints do not cover lock= or cpu.max= workloads (PID %d)\n",
+                    processes[i].pid);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+/**
+ * Start a checkpoint file for a simulation that has not run yet
+ */
+void checkpoint_open(CheckpointWriter *w, const char *path, const Simulation *sim, SimTime interval) {
+    w->temp_path = (char *)malloc(strlen(path) + 5);
+    if (!w->temp_path) {
+        perror("Failed to allocate checkpoint path");
+        exit(EXIT_FAILURE);
+    }
+    sprintf(w->temp_path, "%s.tmp", path);
+    w->file = fopen(w->temp_path, "wb");
+    if (!w->file) {
+        perror("Error opening checkpoint file");
+        exit(EXIT_FAILURE);
+    }
+    w->interval = interval;
+    w->last_time = -1;
+    w->next_time = 0;
+    w->entries = NULL;
+    w->entry_count = w->entry_capacity = 0;
+
+    int32_t header[5] = {2, (int32_t)sizeof(Process), sim->algorithm, sim->cpu_count, sim->process_count};
+    int64_t config[4] = {sim->time_quantum, sim->options->preemption.threshold, interval, TICK_NS};
+    checkpoint_put(w, "SCHEDCKP", 8);
+    checkpoint_put(w, header, sizeof(header));
+    checkpoint_put(w, config, sizeof(config));
+    checkpoint_put(w, sim->processes, sim->process_count * sizeof(Process));
+}
+
+/**
+ * Add the checkpoint starting at the current end of the file to the index
+ */
+static void checkpoint_index_add(CheckpointWriter *w, SimTime time) {
+    if (w->entry_count == w->entry_capacity) {
+        w->entry_capacity = w->entry_capacity > 0 ? w->entry_capacity * 2 : 64;
+        w->entries = (CheckpointEntry *)realloc(w->entries, w->entry_capacity * sizeof(CheckpointEntry));
+        if (!w->entries) {
+            perror("Failed to grow checkpoint index");
+            exit(EXIT_FAILURE);
+        }
+    }
+    w->entries[w->entry_count++] = (CheckpointEntry){time, ftell(w->file)};
+}
+
+/**
+ * Append a checkpoint of the simulation at its current time, and make its
+ * steps stop at the next one
+ */
+void checkpoint_write(CheckpointWriter *w, Simulation *sim) {
+    SimTime now = sim->current_time;
+    checkpoint_index_add(w, now);
+    long start = w->entries[w->entry_count - 1].offset;
+    int64_t head[3] = {now, 0, 0};
+    checkpoint_put(w, head, sizeof(head));
+
+    // Changes: processes finished since the last checkpoint, and the timeline rows since then
+    int32_t records = 0;
+    for (int i = 0; i < sim->process_count; i++) {
+        const Process *p = &sim->processes[i];
+        if (p->arrival_time < now && p->finish_time != -1 && p->finish_time > w->last_time) records++;
+    }
+    checkpoint_put(w, &records, sizeof(records));
+    for (int i = 0; i < sim->process_count; i++) {
+        const Process *p = &sim->processes[i];
+        if (p->arrival_time < now && p->finish_time != -1 && p->finish_time > w->last_time) {
+            checkpoint_put_process(w, i, p);
+        }
+    }
+    SimTime from = w->last_time > 0 ? w->last_time : 0;
+    int32_t rows = sim->record_timeline ? (int32_t)(now - from) : -1;
+    checkpoint_put(w, &rows, sizeof(rows));
+    for (SimTime t = from; t < from + (rows > 0 ? rows : 0); t++) {
+        checkpoint_put(w, sim->timeline[t], sim->cpu_count * sizeof(int));
+    }
+    long middle = ftell(w->file);
+
+    // State: everything else a run needs to go on from here
+    int64_t arrived = sim->arrived_count;
+    int32_t counters[3] = {sim->completed_count, sim->blocked_count, sim->srtf_recheck};
+    checkpoint_put(w, &arrived, sizeof(arrived));
+    checkpoint_put(w, counters, sizeof(counters));
+    checkpoint_put(w, &sim->preemption, sizeof(sim->preemption));
+    for (int c = 0; c < sim->cpu_count; c++) {
+        const CPU *cpu = &sim->cpus[c];
+        int64_t times[2] = {cpu->idle_time, cpu->busy_time};
+        int32_t index = cpu->current_process ? (int32_t)(cpu->current_process - sim->processes) : -1;
+        checkpoint_put(w, times, sizeof(times));
+        checkpoint_put(w, &index, sizeof(index));
+    }
+    const ReadyQueue *q = &sim->ready_queue_rr;
+    int32_t length = q->size;
+    checkpoint_put(w, &length, sizeof(length));
+    for (int j = 0; j < q->size; j++) {
+        int32_t index = q->process_indices[(q->front + j) % q->capacity];
+        checkpoint_put(w, &index, sizeof(index));
+    }
+    records = 0;
+    for (int i = 0; i < sim->process_count; i++) {
+        const Process *p = &sim->processes[i];
+        if (p->arrival_time < now && p->finish_time == -1) records++;
+    }
+    checkpoint_put(w, &records, sizeof(records));
+    for (int i = 0; i < sim->process_count; i++) {
+        const Process *p = &sim->processes[i];
+        if (p->arrival_time < now && p->finish_time == -1) checkpoint_put_process(w, i, p);
+    }
+
+    // Fill in the section sizes
+    long end = ftell(w->file);
+    head[1] = middle - start - (long)sizeof(head);
+    head[2] = end - middle;
+    fseek(w->file, start, SEEK_SET);
+    checkpoint_put(w, head, sizeof(head));
+    fseek(w->file, end, SEEK_SET);
+
+    w->last_time = now;
+    w->next_time = now + w->interval;
+    sim->stop_time = w->next_time;
+}
+
+/**
+ * Write the checkpoint index, finish the file and move it into place
+ */
+void checkpoint_close(CheckpointWriter *w, const char *path) {
+    int64_t footer = ftell(w->file);
+    int32_t count = w->entry_count;
+    checkpoint_put(w, &count, sizeof(count));
+    for (int e = 0; e < w->entry_count; e++) {
+        int64_t entry[2] = {w->entries[e].time, w->entries[e].offset};
+        checkpoint_put(w, entry, sizeof(entry));
+    }
+    checkpoint_put(w, &footer, sizeof(footer));
+    checkpoint_put(w, "SCHEDIDX", 8);
+    if (fclose(w->file) != 0 || rename(w->temp_path, path) != 0) {
+        perror("Error writing checkpoint file");
+        exit(EXIT_FAILURE);
+    }
+    free(w->temp_path);
+    free(w->entries);
+    w->file = NULL;
+}
+
+/**
+ * Apply the changes section of a checkpoint: finished processes and the
+ * timeline rows from 'from' on
+ */
+static void checkpoint_apply_changes(Simulation *sim, char *section, size_t size, const int *remap, int base_count,
+                                     SimTime from, const char *path) {
+    char *cursor = section, *end = section + size;
+    checkpoint_take_processes(sim, &cursor, end, remap, base_count, true, path);
+
+    int32_t rows;
+    checkpoint_take(&cursor, end, &rows, sizeof(rows), path);
+    if (rows < 0 || !sim->record_timeline) {
+        sim->record_timeline = false;
+        return;
+    }
+    while (from + rows > sim->timeline_capacity) {
+        expand_timeline(&sim->timeline, &sim->timeline_capacity, sim->timeline_capacity * 2, sim->cpu_count);
+    }
+    for (SimTime t = from; t < from + rows; t++) {
+        checkpoint_take(&cursor, end, sim->timeline[t], sim->cpu_count * sizeof(int), path);
+    }
+}
+
+/**
+ * Apply the state section of a checkpoint, or with apply unset only rekey
+ * it for copying
+ */
+static void checkpoint_apply_state(Simulation *sim, char *section, size_t size, const int *remap, int base_count,
+                                   bool apply, const char *path) {
+    char *cursor = section, *end = section + size;
+    int64_t arrived;
+    int32_t counters[3];
+    PreemptionStats preemption;
+    checkpoint_take(&cursor, end, &arrived, sizeof(arrived), path);
+    checkpoint_take(&cursor, end, counters, sizeof(counters), path);
+    checkpoint_take(&cursor, end, &preemption, sizeof(preemption), path);
+    if (apply) {
+        sim->preemption = preemption;
+        sim->preemption.visits_avoided = sim->preemption.skipped * sim->process_count; // Sized to this workload
+        sim->arrived_count = arrived;
+        sim->completed_count = counters[0];
+        sim->blocked_count = counters[1];
+        sim->srtf_recheck = counters[2] != 0;
+    }
+
+    for (int c = 0; c < sim->cpu_count; c++) {
+        int64_t times[2];
+        int32_t index;
+        checkpoint_take(&cursor, end, times, sizeof(times), path);
+        char *at = cursor;
+        checkpoint_take(&cursor, end, &index, sizeof(index), path);
+        if (index != -1) index = checkpoint_rekey(at, index, remap, base_count, path);
+        if (apply) {
+            sim->cpus[c].idle_time = times[0];
+            sim->cpus[c].busy_time = times[1];
+            sim->cpus[c].current_process = index != -1 ? &sim->processes[index] : NULL;
+        }
+    }
+
+    if (apply) {
+        while (dequeue(&sim->ready_queue_rr) != -1);
+    }
+    int32_t length;
+    checkpoint_take(&cursor, end, &length, sizeof(length), path);
+    for (int j = 0; j < length; j++) {
+        int32_t index;
+        char *at = cursor;
+        checkpoint_take(&cursor, end, &index, sizeof(index), path);
+        index = checkpoint_rekey(at, index, remap, base_count, path);
+        if (apply) enqueue(&sim->ready_queue_rr, index);
+    }
+
+    checkpoint_take_processes(sim, &cursor, end, remap, base_count, apply, path);
+}
+
+/**
+ * Restore a simulation of an edited workload (not yet run) from the last
+ * checkpoint before the edits can matter. Its state comes from that
+ * checkpoint alone; the earlier ones only contribute their changes
+ * sections, which the footer index lets it seek to. The checkpoints up to
+ * that point are also copied to w, if given. Returns the time resumed from.
+ */
+SimTime checkpoint_resume(Simulation *sim, const char *path, CheckpointWriter *w) {
+    int32_t header[5];
+    int64_t config[4];
+    FILE *file = checkpoint_open_header(path, header, config);
+    int base_count = header[4];
+    Process *base = (Process *)malloc((base_count > 0 ? base_count : 1) * sizeof(Process));
+    int *remap = (int *)malloc((base_count > 0 ? base_count : 1) * sizeof(int));
+    if (!base || !remap) {
+        perror("Failed to allocate checkpointed workload");
+        exit(EXIT_FAILURE);
+    }
+    checkpoint_read(file, base, base_count * sizeof(Process), path);
+    SimTime first_change = workload_first_change(base, base_count, sim->processes, sim->process_count);
+
+    // Records are keyed by position in the checkpointed workload
+    bool duplicates;
+    PidIndex *map = pid_index_build(sim->processes, sim->process_count, &duplicates);
+    for (int i = 0; i < base_count; i++) remap[i] = pid_index_find(map, sim->process_count, base[i].pid);
+    free(map);
+    free(base);
+
+    // The index at the end lists where each checkpoint starts
+    char magic[8];
+    int64_t footer;
+    int32_t count = -1;
+    if (fseek(file, -(long)(sizeof(footer) + sizeof(magic)), SEEK_END) == 0 &&
+        fread(&footer, sizeof(footer), 1, file) == 1 && fread(magic, sizeof(magic), 1, file) == 1 &&
+        memcmp(magic, "SCHEDIDX", 8) == 0 && fseek(file, (long)footer, SEEK_SET) == 0) {
+        checkpoint_read(file, &count, sizeof(count), path);
+    }
+    if (count < 0) {
+        fprintf(stderr, "Error: %s is not a valid checkpoint file\n", path);
+        exit(EXIT_FAILURE);
+    }
+    int64_t (*index)[2] = (int64_t (*)[2])malloc((count > 0 ? count : 1) * sizeof(*index));
+    if (!index) {
+        perror("Failed to allocate checkpoint index");
+        exit(EXIT_FAILURE);
+    }
+    checkpoint_read(file, index, count * sizeof(*index), path);
+    int last = -1;
+    while (last + 1 < count && index[last + 1][0] <= first_change) last++;
+
+    SimTime resumed = 0;
+    char *buffer = NULL;
+    size_t buffer_capacity = 0;
+    for (int e = 0; e <= last; e++) {
+        int64_t head[3];
+        fseek(file, (long)index[e][1], SEEK_SET);
+        checkpoint_read(file, head, sizeof(head), path);
+        // Only a copy or the checkpoint resumed from needs the state section
+        bool whole = w || e == last;
+        size_t size = (size_t)head[1] + (whole ? (size_t)head[2] : 0);
+        if (size > buffer_capacity) {
+            buffer_capacity = size;
+            buffer = (char *)realloc(buffer, buffer_capacity);
+            if (!buffer) {
+                perror("Failed to allocate checkpoint buffer");
+                exit(EXIT_FAILURE);
+            }
+        }
+        checkpoint_read(file, buffer, size, path);
+        checkpoint_apply_changes(sim, buffer, (size_t)head[1], remap, base_count, resumed, path);
+        if (whole) checkpoint_apply_state(sim, buffer + head[1], (size_t)head[2], remap, base_count, e == last, path);
+        resumed = head[0];
+        if (w) {
+            checkpoint_index_add(w, resumed);
+            checkpoint_put(w, head, sizeof(head));
+            checkpoint_put(w, buffer, size);
+            w->last_time = resumed;
+        }
+    }
+    fclose(file);
+    free(buffer);
+    free(index);
+    free(remap);
+
+    if (!sim->record_timeline) {
+        cleanup_timeline(sim->timeline, sim->timeline_capacity);
+        sim->timeline = NULL;
+        sim->timeline_capacity = 0;
+    }
+    sim->current_time = resumed;
+    if (w) {
+        w->next_time = resumed + w->interval;
+        sim->stop_time = w->next_time;
+    }
+
+    if (first_change == SIMTIME_MAX) printf("Resuming from the checkpoint at time %lld (no changes)\n", resumed);
+    else printf("Resuming from the checkpoint at time %lld (first change at time %lld)\n", resumed, first_change);
+    return resumed;
+}
+
+/************************* DECISION LOG *************************/
+
+/*
+ * A decision log records every change of the process a CPU runs, other
+ * than a CPU falling idle because its process completed (which follows
+ * from the workload). Layout:
+ *
+ *   "SCHEDDEC", then varints: version (1), flags, CPU count, process count
+ *   per decision, varints: time since the previous decision, CPU, and the
+ *   index of the process in the workload plus one (0: the CPU goes idle)
+ *
+ * Varints are little-endian base-128: seven bits per byte, high bit set on
+ * all but the last byte. A replay needs no policy: it moves processes on
+ * and off CPUs as logged and runs the clock to the next decision or
+ * completion.
+ */
+
+#define DECISION_LOG_UNREPLAYABLE 1 // Storage, lock, bandwidth, energy or NUMA modelling changed execution
+
+static void varint_put(FILE *file, uint64_t value) {
+    unsigned char bytes[10];
+    int n = 0;
+    do {
+        bytes[n] = value & 0x7f;
+        value >>= 7;
+        if (value) bytes[n] |= 0x80;
+        n++;
+    } while (value);
+    if (fwrite(bytes, 1, n, file) != (size_t)n) {
+        perror("Error writing decision log");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Read one varint; false at the end of the file
+ */
+static bool varint_get(FILE *file, uint64_t *value, const char *path) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = fgetc(file);
+        if (byte == EOF) {
+            if (shift == 0) return false;
+            break;
+        }
+        *value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    fprintf(stderr, "Error: %s is not a valid decision log\n", path);
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * Read a decision log header; returns the open file
+ */
+static FILE *decision_log_read_header(const char *path, uint64_t *header) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        perror("Error opening decision log");
+        exit(EXIT_FAILURE);
+    }
+    char magic[8];
+    bool valid = fread(magic, 1, sizeof(magic), file) == sizeof(magic) && memcmp(magic, "SCHEDDEC", 8) == 0;
+    for (int i = 0; i < 4 && valid; i++) valid = varint_get(file, &header[i], path);
+    if (!valid || header[0] != 1) {
+        fprintf(stderr, "Error: %s is not a version 1 decision log\n", path);
+        exit(EXIT_FAILURE);
+    }
+    return file;
+}
+
+/**
+ * Start recording the decisions of a simulation, or comparing them with an
+ * existing log if verify is set
+ */
+void decision_log_open(DecisionLog *log, const char *path, bool verify, const Simulation *sim) {
+    memset(log, 0, sizeof(*log));
+    log->verify = verify;
+    log->mismatch = -1;
+    log->occupant = (Process **)calloc(sim->cpu_count, sizeof(Process *));
+    if (!log->occupant) {
+        perror("Failed to allocate decision log");
+        exit(EXIT_FAILURE);
+    }
+
+    uint64_t header[4] = {1, 0, (uint64_t)sim->cpu_count, (uint64_t)sim->process_count};
+    if (sim->options->ssd.enabled || sim->uses_locks || sim->uses_bandwidth || sim->power || sim->numa) {
+        header[1] |= DECISION_LOG_UNREPLAYABLE;
+    }
+    if (verify) {
+        uint64_t logged[4];
+        log->file = decision_log_read_header(path, logged);
+        if (memcmp(logged, header, sizeof(header)) != 0) log->mismatch = 0;
+    } else {
+        log->file = fopen(path, "wb");
+        if (!log->file) {
+            perror("Error opening decision log");
+            exit(EXIT_FAILURE);
+        }
+        fwrite("SCHEDDEC", 1, 8, log->file);
+        for (int i = 0; i < 4; i++) varint_put(log->file, header[i]);
+    }
+}
+
+/**
+ * Log the CPUs whose process changed since the previous step. Called once
+ * the step's dispatching is done.
+ */
+void decision_log_step(DecisionLog *log, Simulation *sim) {
+    for (int c = 0; c < sim->cpu_count; c++) {
+        Process *before = log->occupant[c];
+        Process *now = sim->cpus[c].current_process;
+        if (before && before->state == COMPLETED) before = NULL;
+        if (before == now) continue;
+        log->occupant[c] = now;
+
+        uint64_t record[3] = {(uint64_t)(sim->current_time - log->last_time), (uint64_t)c,
+                              now ? (uint64_t)(now - sim->processes) + 1 : 0};
+        log->last_time = sim->current_time;
+        if (!log->verify) {
+            for (int f = 0; f < 3; f++) varint_put(log->file, record[f]);
+        } else if (log->mismatch == -1) {
+            uint64_t logged[3];
+            bool present = true;
+            for (int f = 0; f < 3 && present; f++) present = varint_get(log->file, &logged[f], "decision log");
+            if (!present || memcmp(logged, record, sizeof(record)) != 0) {
+                log->mismatch = log->count;
+                log->mismatch_time = sim->current_time;
+            }
+        }
+        log->count++;
+    }
+}
+
+/**
+ * Finish a decision log and report on it
+ */
+void decision_log_close(DecisionLog *log, const char *path) {
+    if (log->verify) {
+        uint64_t extra;
+        if (log->mismatch == -1 && varint_get(log->file, &extra, path)) {
+            log->mismatch = log->count; // The logged run made more decisions
+            log->mismatch_time = -1;
+        }
+        if (log->mismatch == -1) {
+            printf("Schedule matches %s (%ld decisions)\n", path, log->count);
+        } else if (log->mismatch_time >= 0) {
+            printf("Schedule differs from %s at decision %ld (time %lld)\n", path, log->mismatch,
+                   log->mismatch_time);
+        } else {
+            printf("Schedule differs from %s at decision %ld\n", path, log->mismatch);
+        }
+    } else {
+        long bytes = ftell(log->file);
+        printf("Decision log (%ld decisions, %ld bytes) written to %s\n", log->count, bytes, path);
+    }
+    if (fclose(log->file) != 0) {
+        perror("Error writing decision log");
+        exit(EXIT_FAILURE);
+    }
+    free(log->occupant);
+}
+
+/**
+ * Regenerate a schedule and its metrics from a decision log, without
+ * running any scheduling policy
+ */
+void simulate_replay(Process *processes, int process_count, const SimOptions *options) {
+    const char *path = options->decisions.replay;
+    uint64_t header[4];
+    FILE *file = decision_log_read_header(path, header);
+    if (header[1] & DECISION_LOG_UNREPLAYABLE) {
+        fprintf(stderr, "Error: %s was recorded with storage, lock, bandwidth, energy or NUMA modelling, "
+                        "which a replay does not reproduce\n", path);
+        exit(EXIT_FAILURE);
+    }
+    if (header[3] != (uint64_t)process_count || header[2] < 1 || header[2] > INT_MAX) {
+        fprintf(stderr, "Error: %s was recorded for a workload of %llu processes, not %d\n", path,
+                (unsigned long long)header[3], process_count);
+        exit(EXIT_FAILURE);
+    }
+    int cpu_count = (int)header[2];
+    CPU *cpus = (CPU *)calloc(cpu_count, sizeof(CPU));
+    if (!cpus) {
+        perror("Failed to allocate CPUs");
+        exit(EXIT_FAILURE);
+    }
+    for (int c = 0; c < cpu_count; c++) cpus[c].id = c;
+    int **timeline = NULL;
+    int timeline_capacity = INITIAL_TIMELINE_CAPACITY;
+    init_timeline(&timeline, timeline_capacity, cpu_count);
+
+    printf("\nReplaying the decisions in %s on %d CPU(s)\n", path, cpu_count);
+
+    SimTime now = 0, next = SIMTIME_MAX;
+    uint64_t record[3];
+    long decisions = 0;
+    int completed = 0;
+    bool more = varint_get(file, &record[0], path);
+    for (int f = 1; f < 3 && more; f++) more = varint_get(file, &record[f], path);
+    if (more) next = (SimTime)record[0];
+
+    while (completed < process_count) {
+        // Apply the decisions taken now
+        bool decided = false;
+        while (more && next == now) {
+            if (record[1] >= (uint64_t)cpu_count || record[2] > (uint64_t)process_count) goto invalid;
+            Process *p = record[2] > 0 ? &processes[record[2] - 1] : NULL;
+            if (p && (p->state == COMPLETED || p->arrival_time > now)) goto invalid;
+            CPU *cpu = &cpus[record[1]];
+            if (cpu->current_process) cpu->current_process->state = READY; // Unless it moved to another CPU
+            cpu->current_process = p;
+            if (p) {
+                if (p->start_time == -1) {
+                    p->start_time = now;
+                    p->response_time = now - p->arrival_time;
+                }
+            }
+            decisions++;
+            decided = true;
+            more = varint_get(file, &record[0], path);
+            for (int f = 1; f < 3 && more; f++) more = varint_get(file, &record[f], path);
+            if (more) next = now + (SimTime)record[0];
+        }
+        if (decided) {
+            for (int c = 0; c < cpu_count; c++) {
+                Process *p = cpus[c].current_process;
+                if (!p) continue;
+                for (int d = 0; d < c; d++) {
+                    if (cpus[d].current_process == p) goto invalid;
+                }
+                p->state = RUNNING;
+            }
+        }
+
+        // Run to the next decision or completion
+        SimTime step = more ? next - now : SIMTIME_MAX;
+        for (int c = 0; c < cpu_count; c++) {
+            Process *p = cpus[c].current_process;
+            if (p && p->remaining_time < step) step = p->remaining_time;
+        }
+        if (step == SIMTIME_MAX) break; // Nothing runs and nothing more was decided
+
+        if (timeline && now + step > MAX_TIMELINE_TICKS) {
+            cleanup_timeline(timeline, timeline_capacity);
+            timeline = NULL;
+            timeline_capacity = 0;
+        }
+        if (timeline) {
+            while (now + step > timeline_capacity) {
+                expand_timeline(&timeline, &timeline_capacity, timeline_capacity * 2, cpu_count);
+            }
+            for (SimTime t = now; t < now + step; t++) {
+                for (int c = 0; c < cpu_count; c++) {
+                    timeline[t][c] = cpus[c].current_process ? cpus[c].current_process->pid : -1;
+                }
+            }
+        }
+
+        for (int c = 0; c < cpu_count; c++) {
+            Process *p = cpus[c].current_process;
+            if (!p) {
+                cpus[c].idle_time += step;
+                continue;
+            }
+            cpus[c].busy_time += step;
+            p->remaining_time -= step;
+            if (p->remaining_time == 0) {
+                p->state = COMPLETED;
+                p->finish_time = now + step;
+                p->waiting_time = p->finish_time - p->arrival_time - p->burst_time;
+                cpus[c].current_process = NULL;
+                completed++;
+            }
+        }
+        now += step;
+    }
+    fclose(file);
+
+    if (completed < process_count) {
+        fprintf(stderr, "Warning: %s ends with %d of %d processes unfinished\n", path,
+                process_count - completed, process_count);
+    }
+    print_results(processes, process_count, cpus, cpu_count, timeline, now);
+    printf("\nReplayed %ld decisions\n", decisions);
+    cleanup_timeline(timeline, timeline_capacity);
+    free(cpus);
+    return;
+
+invalid:
+    fprintf(stderr, "Error: Decision %ld of %s does not fit this workload (time %lld)\n", decisions, path, now);
+    exit(EXIT_FAILURE);
+}
+
+/************************* ONE-TICK ADAPTER *************************/
+
+/*
+ * The scheduling functions in scheduler.c keep the contract of the one-tick
+ * assignment: int times, one time unit per call, true burst times and the
+ * classic SRTF rule. sim_step calls them through the wrappers below, which
+ * translate from the engine's view:
+ *
+ * - A step of elapsed units runs execute_processes for its first unit,
+ *   repeats what that did to the CPU and process counters for the units in
+ *   between, and runs it again for the last unit, which may complete a
+ *   process. Nothing changes state inside a step, so every unit would have
+ *   done the same.
+ * - update_waiting_times runs once and what it added is scaled by elapsed.
+ *   Processes blocked on storage or a lock, or throttled, are not charged.
+ * - Under --predict, SJF and SRTF find the predicted sizes in burst_time and
+ *   remaining_time while they choose.
+ * - Under --preempt-threshold T, running processes' remaining times are T
+ *   lower while handle_srtf_preemption runs, so a ready process preempts
+ *   only when it is shorter by more than T, or by exactly T with a higher
+ *   priority.
+ */
+
+/**
+ * A time or quantum as the scheduling functions take it
+ */
+static int tick_value(SimTime value, const char *what) {
+    if (value > INT_MAX) {
+        fprintf(stderr, "Error: %s %lld does not fit the int times of the scheduling functions\n", what, value);
+        exit(EXIT_FAILURE);
+    }
+    return (int)value;
+}
+
+static bool hides_true_sizes(const Simulation *sim) {
+    return sim->options->prediction.mode != PREDICT_NONE && (sim->algorithm == SJF || sim->algorithm == SRTF);
+}
+
+/**
+ * Put the predicted sizes in place of the true ones, which are kept in
+ * saved_times until restore_true_sizes
+ */
+static void hide_true_sizes(Simulation *sim) {
+    for (int i = 0; i < sim->process_count; i++) {
+        Process *p = &sim->processes[i];
+        SimTime size = job_size_estimate(p), remaining = remaining_estimate(p);
+        sim->saved_times[2 * i] = p->burst_time;
+        sim->saved_times[2 * i + 1] = p->remaining_time;
+        p->burst_time = size;
+        p->remaining_time = remaining;
+    }
+}
+
+static void restore_true_sizes(Simulation *sim) {
+    for (int i = 0; i < sim->process_count; i++) {
+        sim->processes[i].burst_time = sim->saved_times[2 * i];
+        sim->processes[i].remaining_time = sim->saved_times[2 * i + 1];
+    }
+}
+
+/**
+ * SRTF preemption over the first online CPUs, whose processes sim_step has
+ * left in srtf_heap
+ */
+static void tick_srtf_preemption(Simulation *sim, int online, SimTime current_time) {
+    SimTime threshold = sim->options->preemption.threshold;
+    bool hide = hides_true_sizes(sim);
+    if (hide) hide_true_sizes(sim);
+    for (int c = 0; c < online; c++) {
+        if (sim->srtf_heap[c]) sim->srtf_heap[c]->remaining_time -= threshold;
+    }
+    handle_srtf_preemption(sim->processes, sim->process_count, sim->cpus, online, tick_value(current_time, "Time"));
+    for (int c = 0; c < online; c++) {
+        if (sim->srtf_heap[c]) sim->srtf_heap[c]->remaining_time += threshold;
+    }
+    if (hide) restore_true_sizes(sim);
+}
+
+static void tick_assign(Simulation *sim, int online, SimTime current_time) {
+    bool hide = hides_true_sizes(sim);
+    if (hide) hide_true_sizes(sim);
+    assign_processes_to_idle_cpus(sim->processes, sim->process_count, sim->cpus, online, sim->algorithm,
+                                  &sim->ready_queue_rr, tick_value(current_time, "Time"));
+    if (hide) restore_true_sizes(sim);
+}
+
+static void tick_waiting_times(Simulation *sim, SimTime current_time, SimTime elapsed) {
+    Process *processes = sim->processes;
+    SimTime *before = sim->saved_times;
+    for (int i = 0; i < sim->process_count; i++) before[i] = processes[i].waiting_time;
+    update_waiting_times(processes, sim->process_count, tick_value(current_time, "Time"));
+    for (int i = 0; i < sim->process_count; i++) {
+        Process *p = &processes[i];
+        if (p->state == BLOCKED || p->state == THROTTLED) p->waiting_time = before[i];
+        else p->waiting_time = before[i] + (p->waiting_time - before[i]) * elapsed;
+    }
+}
+
+/**
+ * Execute the processes on the CPUs (also in sim->running) for elapsed
+ * time units. sim_next_event ends a step at the first completion, so no
+ * process completes before the last unit.
+ */
+static void tick_execute(Simulation *sim, SimTime current_time, SimTime elapsed) {
+    CPU *cpus = sim->cpus;
+    int cpu_count = sim->cpu_count;
+    int last = tick_value(current_time + elapsed - 1, "Time");
+    if (elapsed > 1) {
+        SimTime *cpu_before = sim->saved_cpu_times, *before = sim->saved_times;
+        for (int c = 0; c < cpu_count; c++) {
+            cpu_before[2 * c] = cpus[c].busy_time;
+            cpu_before[2 * c + 1] = cpus[c].idle_time;
+            Process *p = sim->running[c];
+            if (!p) continue;
+            int i = (int)(p - sim->processes);
+            before[2 * i] = p->remaining_time;
+            before[2 * i + 1] = p->quantum_used;
+        }
+        execute_processes(sim->processes, sim->process_count, cpus, cpu_count, (int)current_time,
+                          &sim->completed_count);
+
+        SimTime repeat = elapsed - 2;
+        for (int c = 0; c < cpu_count; c++) {
+            cpus[c].busy_time += (cpus[c].busy_time - cpu_before[2 * c]) * repeat;
+            cpus[c].idle_time += (cpus[c].idle_time - cpu_before[2 * c + 1]) * repeat;
+            Process *p = sim->running[c];
+            if (!p || cpus[c].current_process != p) continue;
+            int i = (int)(p - sim->processes);
+            p->remaining_time += (p->remaining_time - before[2 * i]) * repeat;
+            p->quantum_used += (p->quantum_used - before[2 * i + 1]) * repeat;
+        }
+    }
+    execute_processes(sim->processes, sim->process_count, cpus, cpu_count, last, &sim->completed_count);
+}
+
+/************************* MAIN SIMULATION *************************/
+
+/**
+ * Set up a simulation over processes[0..process_count), a malloc'd array
+ * of process_capacity entries. Cluster hosts start empty and receive their
+ * jobs one at a time through sim_add_process, which grows the array.
+ */
+void sim_init(Simulation *sim, Process *processes, int process_count, int process_capacity, int cpu_count,
+              Algorithm algorithm, SimTime time_quantum, const SimOptions *options, bool record_timeline) {
+    memset(sim, 0, sizeof(*sim));
+    sim->processes = processes;
+    sim->process_count = process_count;
+    sim->process_capacity = process_capacity;
+    sim->cpu_count = cpu_count;
+    sim->algorithm = algorithm;
+    sim->time_quantum = time_quantum;
+    sim->options = options;
+    sim->record_timeline = record_timeline;
+
+    init_queue(&sim->ready_queue_rr, process_capacity > 0 ? process_capacity : 1);
+
+    sim->arrived_indices = (int *)malloc((process_capacity > 0 ? process_capacity : 1) * sizeof(int));
+    if (!sim->arrived_indices) {
+        perror("Failed to allocate arrival buffer");
+        exit(EXIT_FAILURE);
+    }
+
+    if (options->ssd.enabled) ssd_init(&sim->ssd, &options->ssd);
+
+    sim->cpus = (CPU *)calloc(cpu_count, sizeof(CPU));
+    if (!sim->cpus) {
+        perror("Failed to allocate CPUs");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < cpu_count; i++) sim->cpus[i].id = i;
+
+    if (record_timeline) {
+        sim->timeline_capacity = INITIAL_TIMELINE_CAPACITY;
+        init_timeline(&sim->timeline, sim->timeline_capacity, cpu_count);
+    }
+
+    sim->running = (Process **)malloc(cpu_count * sizeof(Process *));
+    sim->srtf_heap = (Process **)malloc(cpu_count * sizeof(Process *));
+    sim->saved_times = (SimTime *)malloc(2 * (process_capacity > 0 ? process_capacity : 1) * sizeof(SimTime));
+    sim->saved_cpu_times = (SimTime *)malloc(2 * cpu_count * sizeof(SimTime));
+    if (!sim->running || !sim->srtf_heap || !sim->saved_times || !sim->saved_cpu_times) {
+        perror("Failed to allocate CPU snapshot");
+        exit(EXIT_FAILURE);
+    }
+    if (options->prediction.mode != PREDICT_NONE) {
+        predictor_init(&sim->predictor, &options->prediction, process_capacity);
+    }
+    for (int i = 0; i < process_count; i++) {
+        lock_register_process(sim, &processes[i]);
+        bandwidth_register_process(sim, &processes[i]);
+    }
+
+    sim->online_cpus = cpu_count;
+    if (options->energy.policy != ENERGY_OFF) {
+        sim->power = (CpuPower *)calloc(cpu_count, sizeof(CpuPower));
+        if (!sim->power) {
+            perror("Failed to allocate CPU power state");
+            exit(EXIT_FAILURE);
+        }
+        if (options->energy.policy == ENERGY_CONSOLIDATE) sim->online_cpus = 1;
+    }
+
+    if (options->numa.nodes > 0) numa_init(sim);
+
+    // The power and NUMA models work tick by tick
+    sim->stop_time = -1;
+    sim->event_steps = !options->tick_steps && !sim->power && !sim->numa;
+    if (sim->event_steps) {
+        sim->arrival_times = (SimTime *)malloc((process_capacity > 0 ? process_capacity : 1) * sizeof(SimTime));
+        if (!sim->arrival_times) {
+            perror("Failed to allocate arrival times");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < process_count; i++) sim->arrival_times[i] = processes[i].arrival_time;
+        qsort(sim->arrival_times, process_count, sizeof(SimTime), compare_times_ascending);
+    }
+}
+
+/**
+ * Append a process that arrives now or later than every known process
+ * (a cluster host's next job), growing the per-process storage
+ * geometrically. Processes may move, so CPUs and locks are re-pointed.
+ */
+void sim_add_process(Simulation *sim, const Process *p) {
+    if (sim->process_count == sim->process_capacity) {
+        int capacity = sim->process_capacity > 0 ? 2 * sim->process_capacity : INITIAL_HOST_CAPACITY;
+        int lock_owner[MAX_LOCKS];
+        for (int l = 0; l < MAX_LOCKS; l++) {
+            lock_owner[l] = sim->locks[l].owner ? (int)(sim->locks[l].owner - sim->processes) : -1;
+        }
+        int *running_index = (int *)malloc((sim->cpu_count > 0 ? sim->cpu_count : 1) * sizeof(int));
+        if (!running_index) {
+            perror("Failed to allocate processes");
+            exit(EXIT_FAILURE);
+        }
+        for (int c = 0; c < sim->cpu_count; c++) {
+            Process *q = sim->cpus[c].current_process;
+            running_index[c] = q ? (int)(q - sim->processes) : -1;
+        }
+
+        Process *processes = (Process *)realloc(sim->processes, capacity * sizeof(Process));
+        int *arrived = (int *)realloc(sim->arrived_indices, capacity * sizeof(int));
+        SimTime *saved = (SimTime *)realloc(sim->saved_times, 2 * capacity * sizeof(SimTime));
+        if (!processes || !arrived || !saved) {
+            perror("Failed to allocate processes");
+            exit(EXIT_FAILURE);
+        }
+        sim->processes = processes;
+        sim->arrived_indices = arrived;
+        sim->saved_times = saved;
+        for (int c = 0; c < sim->cpu_count; c++) {
+            sim->cpus[c].current_process = running_index[c] >= 0 ? &processes[running_index[c]] : NULL;
+        }
+        for (int l = 0; l < MAX_LOCKS; l++) {
+            sim->locks[l].owner = lock_owner[l] >= 0 ? &processes[lock_owner[l]] : NULL;
+        }
+        free(running_index);
+
+        grow_queue(&sim->ready_queue_rr, capacity);
+        if (sim->event_steps) {
+            SimTime *times = (SimTime *)realloc(sim->arrival_times, capacity * sizeof(SimTime));
+            if (!times) {
+                perror("Failed to allocate arrival times");
+                exit(EXIT_FAILURE);
+            }
+            sim->arrival_times = times;
+        }
+        if (sim->uses_locks) {
+            for (int l = 0; l < MAX_LOCKS; l++) {
+                int *waiters = (int *)realloc(sim->locks[l].waiters, capacity * sizeof(int));
+                if (!waiters) {
+                    perror("Failed to allocate lock wait queue");
+                    exit(EXIT_FAILURE);
+                }
+                sim->locks[l].waiters = waiters;
+            }
+        }
+        if (sim->uses_bandwidth) {
+            Bucket *buckets = (Bucket *)realloc(sim->buckets, (MAX_CLASSES + capacity) * sizeof(Bucket));
+            RefillTimer *timers = (RefillTimer *)realloc(sim->timers, (MAX_CLASSES + capacity) * sizeof(RefillTimer));
+            if (!buckets || !timers) {
+                perror("Failed to allocate bandwidth buckets");
+                exit(EXIT_FAILURE);
+            }
+            memset(buckets + MAX_CLASSES + sim->process_capacity, 0,
+                   (capacity - sim->process_capacity) * sizeof(Bucket));
+            sim->buckets = buckets;
+            sim->timers = timers;
+        }
+        if (sim->options->prediction.mode != PREDICT_NONE) predictor_reserve(&sim->predictor, capacity);
+        sim->process_capacity = capacity;
+    }
+
+    Process *added = &sim->processes[sim->process_count++];
+    *added = *p;
+    if (sim->event_steps) sim->arrival_times[sim->process_count - 1] = added->arrival_time;
+    lock_register_process(sim, added);
+    bandwidth_register_process(sim, added);
+}
+
+/**
+ * Length of the next step: the time until the next event that any part of
+ * the simulator reacts to. Nothing but the CPU time of running processes
+ * changes between events, so a step of dt time units has the same effect
+ * as dt single ticks. Called once the CPUs have been assigned.
+ */
+static SimTime sim_next_event(Simulation *sim) {
+    if (!sim->event_steps || sim->srtf_recheck) return 1;
+    SimTime now = sim->current_time;
+    SimTime step = SIMTIME_MAX;
+
+    // Arrivals
+    while (sim->next_arrival < sim->process_count && sim->arrival_times[sim->next_arrival] <= now) {
+        sim->next_arrival++;
+    }
+    if (sim->next_arrival < sim->process_count) step = sim->arrival_times[sim->next_arrival] - now;
+
+    // Least attained waiting process, which LAS lets displace a process past its quantum
+    SimTime least_attained = SIMTIME_MAX;
+    if (sim->algorithm == LAS) {
+        for (int i = 0; i < sim->process_count; i++) {
+            const Process *p = &sim->processes[i];
+            if (p->state != WAITING || p->arrival_time > now) continue;
+            SimTime attained = p->burst_time - p->remaining_time;
+            if (attained < least_attained) least_attained = attained;
+        }
+    }
+
+    // Completions, quantum expiries, storage writes and critical sections of running processes
+    int busy = 0;
+    bool mlq_expired = false;
+    for (int c = 0; c < sim->cpu_count; c++) {
+        const Process *p = sim->cpus[c].current_process;
+        if (!p) continue;
+        busy++;
+        SimTime attained = p->burst_time - p->remaining_time;
+        if (p->remaining_time < step) step = p->remaining_time;
+        if (sim->algorithm == RR || sim->algorithm == LAS) {
+            SimTime left = sim->time_quantum - p->quantum_used;
+            if (left > 0 && left < step) step = left;
+            if (left <= 0 && sim->algorithm == LAS && least_attained != SIMTIME_MAX) {
+                SimTime overtaken = least_attained + 1 - attained;
+                if (overtaken < 1) overtaken = 1;
+                if (overtaken < step) step = overtaken;
+            }
+        }
+        if (sim->algorithm == MLQ) {
+            const MlqOptions *mlq = &sim->options->mlq;
+            int level = mlq->level_of[p->class_id];
+            SimTime left = mlq->quanta[level] - p->quantum_used;
+            if (mlq->policies[level] == RR && left > 0 && left < step) step = left;
+            if (mlq->policies[level] == RR && left <= 0) mlq_expired = true;
+        }
+        if (sim->options->ssd.enabled && p->io_interval > 0) {
+            SimTime to_write = p->io_interval - attained % p->io_interval;
+            if (to_write < step) step = to_write;
+        }
+        for (int u = 0; u < p->lock_use_count; u++) {
+            const LockUse *use = &p->lock_uses[u];
+            SimTime until = (p->locks_held & (1 << u)) ? use->release_at : use->acquire_at;
+            if (until > attained && until - attained < step) step = until - attained;
+        }
+    }
+
+    // A runnable process left waiting beside an idle CPU is picked up next tick
+    long runnable = sim->arrived_count - sim->completed_count - busy - sim->blocked_count;
+    if (runnable > 0 && busy < sim->online_cpus) return 1;
+
+    // Storage writes completing
+    if (sim->options->ssd.enabled) {
+        for (int i = 0; i < sim->process_count; i++) {
+            const Process *p = &sim->processes[i];
+            if (p->state == BLOCKED && p->io_wake_time > now && p->io_wake_time - now < step) {
+                step = p->io_wake_time - now;
+            }
+        }
+    }
+
+    // Quota exhaustion, the end of a charged period, and pending refills
+    if (sim->uses_bandwidth) {
+        for (int c = 0; c < sim->cpu_count; c++) {
+            const Process *p = sim->cpus[c].current_process;
+            if (!p || p->bucket < 0) continue;
+            const Bucket *b = &sim->buckets[p->bucket];
+            int members = 0;
+            for (int d = 0; d < sim->cpu_count; d++) {
+                const Process *q = sim->cpus[d].current_process;
+                if (q && q->bucket == p->bucket) members++;
+            }
+            SimTime exhausted = (b->quota - b->used + members - 1) / members;
+            if (exhausted < 1) exhausted = 1;
+            if (exhausted < step) step = exhausted;
+            SimTime period_end = (now / b->period + 1) * b->period - now;
+            if (period_end < step) step = period_end;
+        }
+        if (sim->timer_count > 0 && sim->timers[0].time > now && sim->timers[0].time - now < step) {
+            step = sim->timers[0].time - now;
+        }
+    }
+
+    // An MLQ process past its quantum whose level only has processes rotated out this
+    // tick waiting yields to them next tick
+    if (mlq_expired) {
+        const MlqOptions *mlq = &sim->options->mlq;
+        bool waiting[MAX_CLASSES + 1] = {false};
+        for (int i = 0; i < sim->process_count; i++) {
+            const Process *p = &sim->processes[i];
+            if (p->state == WAITING && p->arrival_time <= now) waiting[mlq->level_of[p->class_id]] = true;
+        }
+        for (int c = 0; c < sim->cpu_count; c++) {
+            const Process *p = sim->cpus[c].current_process;
+            if (!p) continue;
+            int level = mlq->level_of[p->class_id];
+            if (mlq->policies[level] == RR && p->quantum_used >= mlq->quanta[level] && waiting[level]) return 1;
+        }
+    }
+
+    // The lead level changing under time-slice arbitration
+    if (sim->algorithm == MLQ) {
+        SimTime until_change;
+        mlq_lead_level(&sim->options->mlq, now, &until_change);
+        if (until_change < step) step = until_change;
+    }
+
+    // Window rows and a caller's stop time
+    if (sim->window.out && sim->window.start + sim->window.width - now < step) {
+        step = sim->window.start + sim->window.width - now;
+    }
+    if (sim->stop_time > now && sim->stop_time - now < step) step = sim->stop_time - now;
+
+    return step == SIMTIME_MAX ? 1 : step;
+}
+
+/**
+ * Advance the simulation to its next event (see sim_next_event), or by
+ * one time unit. Returns false if the simulation had to be aborted.
+ */
+bool sim_step(Simulation *sim) {
+    Process *processes = sim->processes;
+    int process_count = sim->process_count;
+    CPU *cpus = sim->cpus;
+    int cpu_count = sim->cpu_count;
+    Algorithm algorithm = sim->algorithm;
+    SimTime current_time = sim->current_time;
+
+    // Return throttled groups whose bandwidth was refilled
+    if (sim->uses_bandwidth) {
+        int refilled = handle_bandwidth_refills(sim);
+        sim->blocked_count -= refilled;
+        if (refilled > 0) sim->srtf_recheck = true;
+    }
+
+    // Wake processes whose storage writes have completed
+    if (sim->options->ssd.enabled) {
+        int woken = handle_io_completions(processes, process_count, current_time, algorithm, &sim->ready_queue_rr);
+        sim->blocked_count -= woken;
+        if (woken > 0) sim->srtf_recheck = true;
+    }
+
+    // Handle new process arrivals
+    int arrival_count = 0;
+    handle_arrivals(processes, process_count, tick_value(current_time, "Time"), algorithm, sim->arrived_indices,
+                    &arrival_count);
+    sim->arrived_count += arrival_count;
+    int new_arrivals = arrival_count;
+
+    // Size-based policies only get to see predicted bursts
+    if (sim->options->prediction.mode != PREDICT_NONE) {
+        for (int i = 0; i < arrival_count; i++) {
+            Process *p = &processes[sim->arrived_indices[i]];
+            p->predicted_burst = predictor_estimate(&sim->predictor, p);
+        }
+    }
+
+    // Arrivals in a throttled group wait for its next refill
+    if (sim->uses_bandwidth) sim->blocked_count += handle_throttled_arrivals(sim, &arrival_count);
+
+    // Energy policies may park cores, leaving the schedulers a prefix of the CPUs
+    if (sim->power) energy_update_online(sim);
+    int online = sim->online_cpus;
+
+    // Remember who held the CPUs so preemptions can be counted
+    WindowStats *window = sim->window.out ? &sim->window : NULL;
+    if (window) {
+        for (int c = 0; c < cpu_count; c++) sim->running[c] = cpus[c].current_process;
+    }
+
+    // Enqueue newly arrived processes for Round Robin
+    if (algorithm == RR) {
+        for (int i = 0; i < arrival_count; i++) {
+            enqueue(&sim->ready_queue_rr, sim->arrived_indices[i]);
+        }
+        handle_rr_quantum_expiry(processes, cpus, online, tick_value(sim->time_quantum, "Quantum"),
+                                 &sim->ready_queue_rr, tick_value(current_time, "Time"));
+    }
+
+    // Newly arrived processes join their MLQ level's queue
+    if (algorithm == MLQ) {
+        for (int i = 0; i < arrival_count; i++) processes[sim->arrived_indices[i]].queued_at = sim->mlq_tickets++;
+    }
+
+    // Handle SRTF preemption, only when something became runnable
+    bool srtf_saw_idle = false;
+    if (algorithm == SRTF) {
+        PreemptionStats *stats = &sim->preemption;
+        srtf_saw_idle = false;
+        if (srtf_preemption_possible(sim, arrival_count)) {
+            int displaced = 0;
+            for (int c = 0; c < online; c++) {
+                sim->srtf_heap[c] = cpus[c].current_process;
+                if (!cpus[c].current_process) srtf_saw_idle = true;
+            }
+            tick_srtf_preemption(sim, online, current_time);
+            for (int c = 0; c < online; c++) {
+                if (sim->srtf_heap[c] && sim->srtf_heap[c]->state != RUNNING) displaced++;
+            }
+            stats->checks++;
+            stats->preemptions += displaced;
+        } else {
+            stats->skipped++;
+            stats->visits_avoided += process_count;
+        }
+        sim->srtf_recheck = false;
+    }
+
+    // Assign processes to idle CPUs, again whenever one blocks on a lock or is throttled
+    for (;;) {
+        if (algorithm == LAS) {
+            handle_las_scheduling(processes, process_count, cpus, online, sim->time_quantum,
+                                  arrival_count, current_time);
+        } else if (algorithm == PRIO) {
+            handle_priority_scheduling(processes, process_count, cpus, online, current_time);
+        } else if (algorithm == MLQ) {
+            handle_mlq_scheduling(sim, current_time);
+        } else {
+            tick_assign(sim, online, current_time);
+        }
+        int blocked = 0;
+        if (sim->uses_locks) blocked += handle_lock_acquires(sim);
+        if (sim->uses_bandwidth) blocked += handle_throttled_dispatch(sim);
+        if (blocked == 0) break;
+        sim->blocked_count += blocked;
+    }
+    if (sim->numa) numa_place(sim);
+
+    // A check that found a CPU idle left any further preemptions to the next
+    // tick; they are only possible if the newly runnable work filled every CPU
+    if (srtf_saw_idle) {
+        sim->srtf_recheck = true;
+        for (int c = 0; c < online; c++) {
+            if (!cpus[c].current_process) sim->srtf_recheck = false;
+        }
+    }
+
+    if (window) {
+        window->arrivals += new_arrivals;
+        for (int c = 0; c < cpu_count; c++) {
+            Process *previous = sim->running[c];
+            if (previous && (previous->state == WAITING || previous->state == READY)) window->preemptions++;
+        }
+    }
+
+    if (sim->decisions) decision_log_step(sim->decisions, sim);
+
+    // Run until the next event
+    SimTime elapsed = sim_next_event(sim);
+    if (algorithm == SRTF) {
+        // Nothing becomes runnable inside a step, so its later ticks need no check
+        sim->preemption.ticks += elapsed;
+        sim->preemption.skipped += elapsed - 1;
+        sim->preemption.visits_avoided += (elapsed - 1) * process_count;
+    }
+
+    // Update timeline, giving up on drawing it once the run gets too long
+    if (sim->record_timeline && current_time + elapsed > MAX_TIMELINE_TICKS) {
+        cleanup_timeline(sim->timeline, sim->timeline_capacity);
+        sim->timeline = NULL;
+        sim->timeline_capacity = 0;
+        sim->record_timeline = false;
+    }
+    if (sim->record_timeline) {
+        while (current_time + elapsed > sim->timeline_capacity) {
+            expand_timeline(&sim->timeline, &sim->timeline_capacity, sim->timeline_capacity * 2, cpu_count);
+        }
+        for (SimTime t = current_time; t < current_time + elapsed; t++) {
+            for (int c = 0; c < cpu_count; c++) {
+                sim->timeline[t][c] = (cpus[c].current_process != NULL) ? cpus[c].current_process->pid : -1;
+            }
+        }
+    }
+
+    // Update waiting times for processes
+    tick_waiting_times(sim, current_time, elapsed);
+    if (sim->uses_locks) account_lock_waits(sim, elapsed);
+
+    // Execute processes on CPUs
+    int busy = 0;
+    for (int c = 0; c < cpu_count; c++) {
+        sim->running[c] = cpus[c].current_process;
+        busy += cpus[c].current_process != NULL;
+    }
+    int queue_during = (int)(sim->arrived_count - sim->completed_count - busy - sim->blocked_count);
+    if (sim->power) energy_before_execute(sim);
+    if (sim->numa) numa_before_execute(sim);
+    tick_execute(sim, current_time, elapsed);
+    if (sim->numa) numa_after_execute(sim);
+    if (sim->power) energy_after_execute(sim);
+    if (sim->uses_locks) {
+        int woken = handle_lock_releases(sim);
+        sim->blocked_count -= woken;
+        if (woken > 0) sim->srtf_recheck = true;
+    }
+
+    // Learn the bursts of processes that just completed
+    if (sim->options->prediction.mode != PREDICT_NONE) {
+        for (int c = 0; c < cpu_count; c++) {
+            if (sim->running[c] && sim->running[c]->state == COMPLETED) {
+                predictor_learn(&sim->predictor, sim->running[c]);
+            }
+        }
+    }
+
+    // Block processes that issue storage writes
+    if (sim->options->ssd.enabled) {
+        sim->blocked_count += handle_io_requests(processes, cpus, cpu_count, &sim->ssd, current_time + elapsed);
+    }
+
+    // Charge CPU bandwidth and throttle groups that used up their quota
+    if (sim->uses_bandwidth) sim->blocked_count += charge_bandwidth(sim, elapsed);
+
+    if (window) {
+        busy = 0;
+        for (int c = 0; c < cpu_count; c++) {
+            Process *p = sim->running[c];
+            if (!p) continue;
+            window->cpu_busy[c] += elapsed;
+            if (p->state == COMPLETED) {
+                window->completions++;
+                window_record_response(window, p->response_time);
+            }
+        }
+        for (int c = 0; c < cpu_count; c++) busy += cpus[c].current_process != NULL;
+        int queue_length = (int)(sim->arrived_count - sim->completed_count - busy - sim->blocked_count);
+        window_end_tick(window, current_time, elapsed, queue_during, queue_length);
+    }
+
+    // Advance time
+    sim->current_time += elapsed;
+    return true;
+}
+
+/**
+ * Release everything owned by a simulation (but not its processes)
+ */
+void sim_cleanup(Simulation *sim) {
+    if (sim->options->ssd.enabled) ssd_cleanup(&sim->ssd);
+    cleanup_timeline(sim->timeline, sim->timeline_capacity);
+    free_queue(&sim->ready_queue_rr);
+    free(sim->arrived_indices);
+    free(sim->cpus);
+    free(sim->running);
+    free(sim->srtf_heap);
+    free(sim->saved_times);
+    free(sim->saved_cpu_times);
+    free(sim->arrival_times);
+    if (sim->options->prediction.mode != PREDICT_NONE) predictor_cleanup(&sim->predictor);
+    if (sim->uses_locks) {
+        for (int l = 0; l < MAX_LOCKS; l++) free(sim->locks[l].waiters);
+    }
+    if (sim->uses_bandwidth) {
+        for (int b = 0; b < sim->bucket_count; b++) free(sim->buckets[b].members);
+        free(sim->buckets);
+        free(sim->timers);
+    }
+    free(sim->power);
+    numa_cleanup(sim);
+}
+
+/**
+ * Upper bound on how long a simulation of these processes may take before
+ * it is considered stuck
+ */
+SimTime sim_time_limit(const Process *processes, int process_count) {
+    SimTime last_arrival = 0, total_burst = 0;
+    for (int i = 0; i < process_count; i++) {
+        if (processes[i].arrival_time > last_arrival) last_arrival = processes[i].arrival_time;
+        total_burst += processes[i].burst_time;
+    }
+    return last_arrival + 5 * (total_burst + INITIAL_TIMELINE_CAPACITY);
+}
+
+/**
+ * Run a simulation without display until all processes complete.
+ * Returns false if it had to be aborted.
+ */
+bool sim_run_quietly(Simulation *sim) {
+    SimTime time_limit = sim_time_limit(sim->processes, sim->process_count);
+    while (sim->completed_count < sim->process_count) {
+        if (!sim_step(sim) || sim->current_time > time_limit) return false;
+    }
+    return true;
+}
+
+/**
+ * Run the entire CPU scheduling simulation
+ */
+void simulate(Process *processes, int process_count, int cpu_count, Algorithm algorithm, SimTime time_quantum,
+              const SimOptions *options) {
+    // Keep a pristine copy to replay with true burst times for comparison
+    Process *oracle = NULL;
+    if (options->prediction.mode != PREDICT_NONE) {
+        oracle = (Process *)malloc(process_count * sizeof(Process));
+        if (!oracle) {
+            perror("Failed to allocate oracle processes");
+            exit(EXIT_FAILURE);
+        }
+        memcpy(oracle, processes, process_count * sizeof(Process));
+    }
+
+    // Initialize simulation components
+    Simulation sim;
+    sim_init(&sim, processes, process_count, process_count, cpu_count, algorithm, time_quantum, options, true);
+    if (options->window.width > 0) window_open(&sim.window, &options->window, cpu_count);
+    const CheckpointOptions *ckpt = &options->checkpoint;
+    CheckpointWriter checkpoints = {0};
+    if (ckpt->path) checkpoint_open(&checkpoints, ckpt->path, &sim, ckpt->interval);
+    DecisionLog decisions;
+    const char *decision_path = options->decisions.record ? options->decisions.record : options->decisions.verify;
+    if (decision_path) {
+        decision_log_open(&decisions, decision_path, options->decisions.verify != NULL, &sim);
+        sim.decisions = &decisions;
+    }
+
+    // Display simulation header
+    printf("\nStarting simulation with %s on %d CPU(s)%s\n", 
+           algorithm_name(algorithm),
+           cpu_count, 
+           algorithm == RR ? ", Quantum=" : "");
+    if (algorithm == RR) printf("%lld", time_quantum);
+    printf("\n");
+    if (ckpt->resume) checkpoint_resume(&sim, ckpt->resume, ckpt->path ? &checkpoints : NULL);
+
+    // Main Simulation Loop, with a safety break to prevent infinite loops
+    SimTime time_limit = sim_time_limit(processes, process_count);
+    while (sim.completed_count < process_count) {
+        if (checkpoints.file && sim.current_time >= checkpoints.next_time) checkpoint_write(&checkpoints, &sim);
+        if (!sim_step(&sim)) break;
+        if (sim.current_time > time_limit) {
+            fprintf(stderr, "Warning: Simulation exceeded maximum expected time. Aborting.\n");
+            break;
+        }
+    }
+
+    SimTime total_time = sim.current_time; // Record total simulation time
+    if (checkpoints.file) {
+        checkpoint_close(&checkpoints, ckpt->path);
+        printf("Checkpoints (every %lld ticks) written to %s\n", ckpt->interval, ckpt->path);
+    }
+    if (sim.decisions) decision_log_close(&decisions, decision_path);
+    if (sim.window.out) {
+        window_close(&sim.window, total_time);
+        printf("Time-series metrics (%lld-tick windows) written to %s\n", options->window.width,
+               options->window.path);
+    }
+    print_results(processes, process_count, sim.cpus, cpu_count, sim.timeline, total_time);
+    if (options->ssd.enabled) {
+        print_storage_stats(&sim.ssd, processes, process_count);
+    }
+    if (sim.uses_locks) print_lock_stats(&sim);
+    if (sim.uses_bandwidth) print_bandwidth_stats(&sim);
+    if (algorithm == MLQ) print_mlq_stats(&sim);
+    if (sim.numa) print_numa_stats(&sim);
+    if (sim.power) print_energy_stats(&sim, total_time);
+    if (algorithm == SRTF && options->preemption.report) print_preemption_stats(&sim);
+    if (options->results.path) {
+        ResultsStore store;
+        results_open(&store, options->results.path);
+        int64_t config[4] = {results_key(&store, options->results.workload),
+                             results_key(&store, ALGORITHM_KEYS[algorithm]), cpu_count, time_quantum};
+        for (int i = 0; i < process_count; i++) {
+            const Process *p = &processes[i];
+            results_append_process(&store, config, p, p->start_time, p->finish_time);
+        }
+        results_close(&store);
+        printf("\nResults appended to %s\n", options->results.path);
+    }
+
+    if (oracle) {
+        SimOptions oracle_options = *options;
+        oracle_options.prediction.mode = PREDICT_NONE;
+        Simulation oracle_sim;
+        sim_init(&oracle_sim, oracle, process_count, process_count, cpu_count, algorithm, time_quantum,
+                 &oracle_options, false);
+        if (!sim_run_quietly(&oracle_sim)) {
+            fprintf(stderr, "Warning: Oracle simulation exceeded maximum expected time.\n");
+        }
+        print_prediction_report(&sim.predictor, processes, oracle, process_count);
+        sim_cleanup(&oracle_sim);
+        free(oracle);
+    }
+
+    // Cleanup
+    sim_cleanup(&sim);
+}
+
+/************************* WHAT-IF BRANCHING *************************/
+
+/**
+ * Change the scheduling policy of a simulation in flight. Ready processes
+ * move between the RR queue and the WAITING pool as the new policy expects;
+ * running processes keep their CPUs and start a fresh quantum.
+ */
+void sim_switch_policy(Simulation *sim, Algorithm algorithm, SimTime time_quantum) {
+    Process *processes = sim->processes;
+
+    // The outgoing policy may have left a ready process shorter than a running one
+    sim->srtf_recheck = true;
+    while (dequeue(&sim->ready_queue_rr) != -1);
+    for (int c = 0; c < sim->cpu_count; c++) {
+        if (sim->cpus[c].current_process) sim->cpus[c].current_process->quantum_used = 0;
+    }
+
+    if (algorithm == RR) {
+        // Queue arrived, ready processes in order of arrival
+        for (;;) {
+            int next = -1;
+            for (int i = 0; i < sim->process_count; i++) {
+                Process *p = &processes[i];
+                if (p->state != WAITING || p->arrival_time >= sim->current_time) continue;
+                if (next == -1 || p->arrival_time < processes[next].arrival_time) next = i;
+            }
+            if (next == -1) break;
+            processes[next].state = READY;
+            enqueue(&sim->ready_queue_rr, next);
+        }
+    } else {
+        for (int i = 0; i < sim->process_count; i++) {
+            if (processes[i].state == READY) processes[i].state = WAITING;
+        }
+    }
+
+    sim->algorithm = algorithm;
+    sim->time_quantum = time_quantum;
+}
+
+/**
+ * Summarize a finished branch for the parent (or a batch file's run)
+ */
+static WhatIfResult whatif_collect(Simulation *sim, bool finished) {
+    WhatIfResult r;
+    memset(&r, 0, sizeof(r));
+    r.finished = finished;
+    r.completed = sim->completed_count;
+    summarize_processes(sim->processes, sim->process_count, &r.avg_turnaround, &r.avg_waiting,
+                        &r.avg_response, &r.p99_turnaround);
+    for (int i = 0; i < sim->process_count; i++) {
+        if (sim->processes[i].finish_time > r.makespan) r.makespan = sim->processes[i].finish_time;
+    }
+    SimTime busy = 0;
+    for (int c = 0; c < sim->cpu_count; c++) busy += sim->cpus[c].busy_time;
+    if (sim->current_time > 0) {
+        r.utilization = 100.0 * (double)busy / ((double)sim->cpu_count * (double)sim->current_time);
+    }
+    return r;
+}
+
+/**
+ * Run the base policy up to the branch time, then fork one child per
+ * alternative (plus one that keeps the base policy). Each child inherits
+ * the simulation state copy-on-write, switches policy, runs to completion
+ * and writes a WhatIfResult to its pipe. Children run concurrently.
+ */
+void simulate_whatif(Process *processes, int process_count, int cpu_count, Algorithm algorithm,
+                     SimTime time_quantum, const SimOptions *options) {
+    const WhatIfOptions *w = &options->whatif;
+    int branch_count = w->branch_count + 1; // Branch 0 keeps the base policy
+
+    Simulation sim;
+    sim_init(&sim, processes, process_count, process_count, cpu_count, algorithm, time_quantum, options, false);
+
+    printf("\nRunning %s on %d CPU(s) up to time %lld, then branching %d way(s)\n",
+           algorithm_name(algorithm), cpu_count, w->branch_time, branch_count);
+
+    SimTime time_limit = sim_time_limit(processes, process_count);
+    sim.stop_time = w->branch_time;
+    while (sim.current_time < w->branch_time && sim.completed_count < process_count &&
+           sim.current_time <= time_limit) {
+        sim_step(&sim);
+    }
+    sim.stop_time = -1;
+    printf("State at time %lld: %d of %d processes completed\n",
+           sim.current_time, sim.completed_count, process_count);
+    fflush(stdout); // Children must not inherit unwritten output
+
+    pid_t pids[MAX_WHATIF_BRANCHES + 1];
+    int pipes[MAX_WHATIF_BRANCHES + 1];
+    for (int b = 0; b < branch_count; b++) {
+        int fds[2];
+        if (pipe(fds) == -1) {
+            perror("pipe");
+            exit(EXIT_FAILURE);
+        }
+        pid_t pid = fork();
+        if (pid == -1) {
+            perror("fork");
+            exit(EXIT_FAILURE);
+        }
+        if (pid == 0) {
+            close(fds[0]);
+            if (b > 0) sim_switch_policy(&sim, w->algorithms[b - 1], w->quanta[b - 1]);
+            bool finished = sim_run_quietly(&sim);
+            WhatIfResult result = whatif_collect(&sim, finished);
+
+            const char *data = (const char *)&result;
+            size_t left = sizeof(result);
+            while (left > 0) {
+                ssize_t n = write(fds[1], data, left);
+                if (n <= 0) _exit(EXIT_FAILURE);
+                data += n;
+                left -= (size_t)n;
+            }
+            close(fds[1]);
+            _exit(EXIT_SUCCESS);
+        }
+        close(fds[1]);
+        pids[b] = pid;
+        pipes[b] = fds[0];
+    }
+
+    printf("\nWhat-If Results (branch at time %lld):\n", sim.current_time);
+    printf("%-4s %-32s %-8s %-10s %-10s %-10s %-8s %-9s %-8s\n",
+           "#", "Policy", "Done", "Avg Turn.", "Avg Wait", "Avg Resp.", "P99 Turn", "Makespan", "Util%");
+    printf("-------------------------------------------------------------------------------------------------------\n");
+    for (int b = 0; b < branch_count; b++) {
+        WhatIfResult result;
+        char *data = (char *)&result;
+        size_t got = 0;
+        while (got < sizeof(result)) {
+            ssize_t n = read(pipes[b], data + got, sizeof(result) - got);
+            if (n <= 0) break;
+            got += (size_t)n;
+        }
+        close(pipes[b]);
+
+        int status;
+        waitpid(pids[b], &status, 0);
+
+        Algorithm branch_algorithm = (b == 0) ? algorithm : w->algorithms[b - 1];
+        SimTime branch_quantum = (b == 0) ? time_quantum : w->quanta[b - 1];
+        char label[64];
+        if (branch_algorithm == RR || branch_algorithm == LAS) {
+            snprintf(label, sizeof(label), "%s%s (q=%lld)", b == 0 ? "* " : "",
+                     algorithm_name(branch_algorithm), branch_quantum);
+        } else {
+            snprintf(label, sizeof(label), "%s%s", b == 0 ? "* " : "", algorithm_name(branch_algorithm));
+        }
+
+        if (got < sizeof(result) || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            printf("%-4d %-32s (branch failed)\n", b, label);
+            continue;
+        }
+        printf("%-4d %-32s %-8d %-10.2f %-10.2f %-10.2f %-8lld %-9lld %-8.2f%s\n",
+               b, label, result.completed, result.avg_turnaround, result.avg_waiting, result.avg_response,
+               result.p99_turnaround, result.makespan, result.utilization,
+               result.finished ? "" : " (aborted)");
+    }
+    printf("-------------------------------------------------------------------------------------------------------\n");
+    printf("* base policy continued unchanged\n");
+
+    sim_cleanup(&sim);
+}
+
+/************************* KERNEL VALIDATION *************************/
+
+/**
+ * When one child of a validation run ran, in CLOCK_MONOTONIC nanoseconds.
+ * Children write their own entry in memory shared with the parent.
+ */
+typedef struct {
+    long long release_ns; // When the parent released it (its real arrival)
+    long long start_ns;   // When it first ran after being released
+    long long finish_ns;  // When its spin loop finished
+} ValidationTimes;
+
+static long long monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * Burn CPU for a number of loop iterations. The result only keeps the
+ * compiler from removing the loop.
+ */
+static unsigned int validation_spin(long long iterations) {
+    unsigned int state = 1;
+    for (long long i = 0; i < iterations; i++) xorshift32(&state);
+    return state;
+}
+
+/**
+ * Spin-loop iterations per nanosecond of CPU time on the calling thread,
+ * best of VALIDATE_CALIBRATION_ROUNDS runs of at least
+ * VALIDATE_CALIBRATION_NS each. CPU time rather than wall time, so being
+ * preempted while calibrating does not skew the rate.
+ */
+static double validation_calibrate(volatile unsigned int *sink) {
+    double best = 0.0;
+    long long iterations = 1 << 16;
+    for (int round = 0; round < VALIDATE_CALIBRATION_ROUNDS; round++) {
+        struct timespec t0, t1;
+        long long ns;
+        do {
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t0);
+            *sink += validation_spin(iterations);
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t1);
+            ns = (t1.tv_sec - t0.tv_sec) * 1000000000LL + (t1.tv_nsec - t0.tv_nsec);
+            if (ns < VALIDATE_CALIBRATION_NS) iterations *= 2;
+        } while (ns < VALIDATE_CALIBRATION_NS);
+        if ((double)iterations / ns > best) best = (double)iterations / ns;
+    }
+    return best;
+}
+
+/**
+ * The Linux policy closest to a simulated one: SCHED_FIFO for FCFS and
+ * PRIO, SCHED_RR for RR, and SCHED_OTHER for policies the kernel has no
+ * counterpart of
+ */
+static int validation_kernel_policy(Algorithm algorithm) {
+    switch (algorithm) {
+        case FCFS:
+        case PRIO: return SCHED_FIFO;
+        case RR:   return SCHED_RR;
+        default:   return SCHED_OTHER;
+    }
+}
+
+static const char *kernel_policy_name(int policy) {
+    switch (policy) {
+        case SCHED_FIFO: return "SCHED_FIFO";
+        case SCHED_RR:   return "SCHED_RR";
+        default:         return "SCHED_OTHER";
+    }
+}
+
+/**
+ * Real-time priority of each process: all equal, except under PRIO, where
+ * the distinct priorities of the workload map in order onto 1..98 (the
+ * parent releasing the children runs at 99)
+ */
+static void validation_rt_priorities(const Process *processes, int process_count, Algorithm algorithm, int *rt) {
+    for (int i = 0; i < process_count; i++) {
+        rt[i] = 1;
+        if (algorithm != PRIO) continue;
+        for (int j = 0; j < process_count; j++) {
+            bool counted = false;
+            for (int k = 0; k < j; k++) counted |= processes[k].priority == processes[j].priority;
+            if (!counted && processes[j].priority < processes[i].priority && rt[i] < 98) rt[i]++;
+        }
+    }
+}
+
+/**
+ * Run the workload as real processes and compare their turnaround and
+ * response times with the simulator's. Every process becomes a child,
+ * forked up front and pinned to the first cpu_count CPUs, that waits on a
+ * pipe until the parent releases it at its arrival time and then spins
+ * for its burst using a calibrated loop. Children run under the Linux
+ * policy matching the simulated one if the real-time policies are
+ * permitted, otherwise under SCHED_OTHER.
+ */
+void simulate_validate(Process *processes, int process_count, int cpu_count, Algorithm algorithm,
+                       SimTime time_quantum, const SimOptions *options) {
+#ifdef __linux__
+    SimTime total_burst = 0;
+    for (int i = 0; i < process_count; i++) {
+        const Process *p = &processes[i];
+        if (p->io_interval > 0 || p->lock_use_count > 0 || p->bw_quota > 0 ||
+            options->bandwidth.quota[p->class_id] > 0) {
+            fprintf(stderr, "Error: --validate runs CPU-bound processes only (no io=, lock= or cpu.max=)\n");
+            exit(EXIT_FAILURE);
+        }
+        total_burst += p->burst_time;
+    }
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    if (process_count > MAX_VALIDATE_PROCESSES || total_burst > MAX_VALIDATE_NS / TICK_NS) {
+        fprintf(stderr, "Error: --validate takes at most %d processes and %.0f s of CPU time\n",
+                MAX_VALIDATE_PROCESSES, MAX_VALIDATE_NS / 1e9);
+        exit(EXIT_FAILURE);
+    }
+    if (cpu_count > online) {
+        fprintf(stderr, "Error: -c %d exceeds the %ld online CPU(s)\n", cpu_count, online);
+        exit(EXIT_FAILURE);
+    }
+
+    // The simulator's prediction
+    Process *predicted = (Process *)malloc(process_count * sizeof(Process));
+    ValidationTimes *times = (ValidationTimes *)mmap(NULL, process_count * sizeof(ValidationTimes),
+                                                     PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    int *rt = (int *)malloc(process_count * sizeof(int));
+    int *order = (int *)malloc(process_count * sizeof(int));
+    int *pipes = (int *)malloc(process_count * sizeof(int));
+    pid_t *pids = (pid_t *)malloc(process_count * sizeof(pid_t));
+    if (!predicted || times == MAP_FAILED || !rt || !order || !pipes || !pids) {
+        perror("Failed to allocate validation state");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(predicted, processes, process_count * sizeof(Process));
+    Simulation sim;
+    sim_init(&sim, predicted, process_count, process_count, cpu_count, algorithm, time_quantum, options, false);
+    bool simulated = sim_run_quietly(&sim);
+    sim_cleanup(&sim);
+
+    // Real-time policies need CAP_SYS_NICE or an RLIMIT_RTPRIO allowance
+    int policy = validation_kernel_policy(algorithm);
+    struct sched_param param = { .sched_priority = 99 };
+    bool realtime = policy != SCHED_OTHER && sched_setscheduler(0, policy, &param) == 0;
+    if (policy != SCHED_OTHER && !realtime) {
+        printf("Note: %s not permitted (%s); running under SCHED_OTHER\n", kernel_policy_name(policy),
+               strerror(errno));
+        policy = SCHED_OTHER;
+    }
+    validation_rt_priorities(processes, process_count, algorithm, rt);
+
+    cpu_set_t cpus, all;
+    CPU_ZERO(&cpus);
+    for (int c = 0; c < cpu_count; c++) CPU_SET(c, &cpus);
+    sched_getaffinity(0, sizeof(all), &all);
+
+    // Calibrate on one of the CPUs the children will use
+    volatile unsigned int sink = 0;
+    cpu_set_t first;
+    CPU_ZERO(&first);
+    CPU_SET(0, &first);
+    sched_setaffinity(0, sizeof(first), &first);
+    double per_ns = validation_calibrate(&sink);
+    sched_setaffinity(0, sizeof(all), &all);
+
+    printf("\nValidating %s on %d CPU(s) against %s%s\n", algorithm_name(algorithm), cpu_count,
+           kernel_policy_name(policy), algorithm == PRIO && realtime ? " (priorities mapped in order)" : "");
+    printf("Spin loop: %.1f iterations per microsecond of CPU time; one tick is %lld ns\n", per_ns * 1000.0,
+           TICK_NS);
+    if (policy == SCHED_RR) {
+        struct timespec slice;
+        if (sched_rr_get_interval(0, &slice) == 0) {
+            printf("Kernel SCHED_RR time slice: %.3f ms (simulated quantum: %lld ticks = %.3f ms)\n",
+                   slice.tv_sec * 1e3 + slice.tv_nsec / 1e6, time_quantum, time_quantum * TICK_NS / 1e6);
+        }
+    }
+    if (policy == SCHED_OTHER && algorithm != FCFS && algorithm != RR && algorithm != PRIO) {
+        printf("Note: Linux has no counterpart of %s; SCHED_OTHER (CFS) runs instead\n", algorithm_name(algorithm));
+    }
+    fflush(stdout); // Children must not inherit unwritten output
+
+    // Fork every child up front, blocked on its pipe
+    for (int i = 0; i < process_count; i++) {
+        int fds[2];
+        if (pipe(fds) == -1) {
+            perror("pipe");
+            exit(EXIT_FAILURE);
+        }
+        times[i] = (ValidationTimes){-1, -1, -1};
+        pid_t pid = fork();
+        if (pid == -1) {
+            perror("fork");
+            exit(EXIT_FAILURE);
+        }
+        if (pid == 0) {
+            close(fds[1]);
+            for (int j = 0; j < i; j++) close(pipes[j]);
+            struct sched_param child = { .sched_priority = rt[i] };
+            sched_setaffinity(0, sizeof(cpus), &cpus);
+            if (policy != SCHED_OTHER) sched_setscheduler(0, policy, &child);
+
+            char go;
+            if (read(fds[0], &go, 1) != 1) _exit(EXIT_FAILURE);
+            times[i].start_ns = monotonic_ns();
+            sink += validation_spin((long long)(processes[i].burst_time * TICK_NS * per_ns));
+            times[i].finish_ns = monotonic_ns();
+            _exit(EXIT_SUCCESS);
+        }
+        close(fds[0]);
+        pipes[i] = fds[1];
+        pids[i] = pid;
+    }
+
+    // Release the children at their arrival times, in the order the simulator sees them
+    for (int i = 0; i < process_count; i++) order[i] = i;
+    for (int i = 1; i < process_count; i++) {
+        for (int j = i; j > 0 && processes[order[j]].arrival_time < processes[order[j - 1]].arrival_time; j--) {
+            int swap = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = swap;
+        }
+    }
+    long long base_ns = monotonic_ns() + VALIDATE_LEAD_NS;
+    for (int k = 0; k < process_count; k++) {
+        int i = order[k];
+        long long at = base_ns + processes[i].arrival_time * TICK_NS;
+        struct timespec until = { at / 1000000000LL, at % 1000000000LL };
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL) == EINTR);
+        times[i].release_ns = monotonic_ns();
+        if (write(pipes[i], "x", 1) != 1) perror("Failed to release a child");
+        close(pipes[i]);
+    }
+    int failed = 0;
+    for (int i = 0; i < process_count; i++) {
+        int status;
+        waitpid(pids[i], &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || times[i].finish_ns < 0) failed++;
+    }
+    if (realtime) sched_setscheduler(0, SCHED_OTHER, &(struct sched_param){0});
+
+    // Compare, in ticks, from the intended arrival times
+    printf("\n%-6s %-8s %-7s %-10s %-10s %-10s %-10s %-10s %-10s\n", "PID", "Arrival", "Burst", "SimTurn",
+           "RealTurn", "SimResp", "RealResp", "Lateness", "RealRun");
+    printf("--------------------------------------------------------------------------------------------\n");
+    double turn_error = 0.0, resp_error = 0.0, turn_relative = 0.0, real_makespan = 0.0;
+    int compared = 0;
+    for (int i = 0; i < process_count; i++) {
+        const Process *p = &predicted[i];
+        const ValidationTimes *t = &times[i];
+        if (t->finish_ns < 0) {
+            printf("%-6d %-8lld %-7lld (child failed)\n", p->pid, p->arrival_time, p->burst_time);
+            continue;
+        }
+        double arrival_ns = (double)base_ns + p->arrival_time * TICK_NS;
+        double turnaround = (t->finish_ns - arrival_ns) / TICK_NS;
+        double response = (t->start_ns - arrival_ns) / TICK_NS;
+        double lateness = (t->release_ns - arrival_ns) / TICK_NS;
+        double run = (double)(t->finish_ns - t->start_ns) / TICK_NS;
+        if ((t->finish_ns - base_ns) / (double)TICK_NS > real_makespan) {
+            real_makespan = (t->finish_ns - base_ns) / (double)TICK_NS;
+        }
+        printf("%-6d %-8lld %-7lld %-10lld %-10.2f %-10lld %-10.2f %-10.2f %-10.2f\n", p->pid, p->arrival_time,
+               p->burst_time, p->finish_time - p->arrival_time, turnaround, p->response_time, response, lateness,
+               run);
+        if (p->finish_time == -1) continue;
+        SimTime sim_turnaround = p->finish_time - p->arrival_time;
+        turn_error += fabs(turnaround - sim_turnaround);
+        resp_error += fabs(response - p->response_time);
+        turn_relative += fabs(turnaround - sim_turnaround) / (sim_turnaround > 0 ? sim_turnaround : 1);
+        compared++;
+    }
+    printf("--------------------------------------------------------------------------------------------\n");
+
+    SimTime sim_makespan = 0;
+    for (int i = 0; i < process_count; i++) {
+        if (predicted[i].finish_time > sim_makespan) sim_makespan = predicted[i].finish_time;
+    }
+    printf("\nValidation Summary (times in ticks):\n");
+    printf("  Makespan simulated/real:        %lld / %.2f\n", sim_makespan, real_makespan);
+    if (compared > 0) {
+        printf("  Mean |turnaround error|:        %.2f (%.1f%% of the simulated turnaround)\n",
+               turn_error / compared, 100.0 * turn_relative / compared);
+        printf("  Mean |response error|:          %.2f\n", resp_error / compared);
+    }
+    if (!simulated) printf("  Warning: The simulation did not finish\n");
+    if (failed > 0) printf("  Warning: %d child process(es) failed\n", failed);
+    printf("(Lateness is how late the parent released a process; RealRun is its first-run-to-finish span)\n");
+
+    munmap(times, process_count * sizeof(ValidationTimes));
+    free(predicted);
+    free(rt);
+    free(order);
+    free(pipes);
+    free(pids);
+#else
+    (void)processes; (void)process_count; (void)cpu_count; (void)algorithm; (void)time_quantum; (void)options;
+    fprintf(stderr, "Error: --validate needs Linux (sched_setaffinity)\n");
+    exit(EXIT_FAILURE);
+#endif
+}
+
+/************************* CLUSTER SIMULATION *************************/
+
+/**
+ * Swap two heap slots and keep the position index in sync
+ */
+static void host_heap_swap(HostHeap *h, int a, int b) {
+    int host_a = h->heap[a], host_b = h->heap[b];
+    h->heap[a] = host_b;
+    h->heap[b] = host_a;
+    h->position[host_b] = a;
+    h->position[host_a] = b;
+}
+
+/**
+ * Heap order: fewer jobs first, lower host number on ties so the pick does
+ * not depend on the order in which hosts reported their completions
+ */
+static int host_heap_less(const HostHeap *h, int a, int b) {
+    int host_a = h->heap[a], host_b = h->heap[b];
+    if (h->load[host_a] != h->load[host_b]) return h->load[host_a] < h->load[host_b];
+    return host_a < host_b;
+}
+
+/**
+ * Restore heap order around a host whose load just changed
+ */
+static void host_heap_fix(HostHeap *h, int host) {
+    int i = h->position[host];
+    while (i > 0 && host_heap_less(h, i, (i - 1) / 2)) {
+        host_heap_swap(h, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+    for (;;) {
+        int smallest = i, left = 2 * i + 1, right = 2 * i + 2;
+        if (left < h->size && host_heap_less(h, left, smallest)) smallest = left;
+        if (right < h->size && host_heap_less(h, right, smallest)) smallest = right;
+        if (smallest == i) break;
+        host_heap_swap(h, i, smallest);
+        i = smallest;
+    }
+}
+
+/**
+ * Initialize a dispatcher with every host idle
+ */
+void dispatcher_init(Dispatcher *d, const ClusterOptions *cluster) {
+    d->policy = cluster->dispatch;
+    d->host_count = cluster->hosts;
+    d->choices = cluster->choices;
+    d->next_host = 0;
+    d->rng = cluster->seed;
+
+    HostHeap *h = &d->hosts;
+    h->size = cluster->hosts;
+    h->heap = (int *)malloc(h->size * sizeof(int));
+    h->position = (int *)malloc(h->size * sizeof(int));
+    h->load = (int *)calloc(h->size, sizeof(int));
+    if (!h->heap || !h->position || !h->load) {
+        perror("Failed to allocate dispatcher");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < h->size; i++) {
+        h->heap[i] = i;
+        h->position[i] = i;
+    }
+}
+
+/**
+ * Choose the host for the next arriving job
+ */
+int dispatcher_pick(Dispatcher *d) {
+    switch (d->policy) {
+        case DISPATCH_RANDOM:
+            return (int)(xorshift32(&d->rng) % (unsigned int)d->host_count);
+        case DISPATCH_JSQ:
+            return d->hosts.heap[0];
+        case DISPATCH_POWER_OF_D: {
+            int best = (int)(xorshift32(&d->rng) % (unsigned int)d->host_count);
+            for (int i = 1; i < d->choices; i++) {
+                int candidate = (int)(xorshift32(&d->rng) % (unsigned int)d->host_count);
+                if (d->hosts.load[candidate] < d->hosts.load[best]) best = candidate;
+            }
+            return best;
+        }
+        case DISPATCH_ROUND_ROBIN:
+        default: {
+            int host = d->next_host;
+            d->next_host = (d->next_host + 1) % d->host_count;
+            return host;
+        }
+    }
+}
+
+/**
+ * Record jobs entering (delta > 0) or leaving (delta < 0) a host
+ */
+void dispatcher_adjust(Dispatcher *d, int host, int delta) {
+    d->hosts.load[host] += delta;
+    if (d->policy == DISPATCH_JSQ) host_heap_fix(&d->hosts, host);
+}
+
+/**
+ * Release dispatcher storage
+ */
+void dispatcher_cleanup(Dispatcher *d) {
+    free(d->hosts.heap);
+    free(d->hosts.position);
+    free(d->hosts.load);
+}
+
+/**
+ * Order jobs by arrival time, keeping input order for ties
+ */
+typedef struct {
+    SimTime arrival_time;
+    int index;
+} ArrivalOrder;
+
+static int compare_arrivals(const void *a, const void *b) {
+    const ArrivalOrder *x = (const ArrivalOrder *)a, *y = (const ArrivalOrder *)b;
+    if (x->arrival_time != y->arrival_time) return (x->arrival_time > y->arrival_time) - (x->arrival_time < y->arrival_time);
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+/**
+ * Simulate a cluster of hosts, each running the single-host scheduler on
+ * cpu_count CPUs. Jobs are dispatched at their arrival time using the
+ * hosts' current number of jobs in system. Between arrivals every host runs
+ * on its own, event to event, up to the next arrival; each host's storage
+ * grows with the jobs it actually receives.
+ */
+void simulate_cluster(Process *processes, int process_count, int cpu_count, Algorithm algorithm,
+                      SimTime time_quantum, const SimOptions *options) {
+    int host_count = options->cluster.hosts;
+
+    ArrivalOrder *order = (ArrivalOrder *)malloc(process_count * sizeof(ArrivalOrder));
+    Simulation *hosts = (Simulation *)malloc(host_count * sizeof(Simulation));
+    double *queue_area = (double *)calloc(host_count, sizeof(double));
+    int *peak_load = (int *)calloc(host_count, sizeof(int));
+    if (!order || !hosts || !queue_area || !peak_load) {
+        perror("Failed to allocate cluster");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < process_count; i++) {
+        order[i].arrival_time = processes[i].arrival_time;
+        order[i].index = i;
+    }
+    qsort(order, process_count, sizeof(ArrivalOrder), compare_arrivals);
+
+    for (int h = 0; h < host_count; h++) {
+        sim_init(&hosts[h], NULL, 0, 0, cpu_count, algorithm, time_quantum, options, false);
+    }
+
+    Dispatcher dispatcher;
+    dispatcher_init(&dispatcher, &options->cluster);
+
+    printf("\nStarting cluster simulation with %s on %d host(s) x %d CPU(s), dispatcher=%s",
+           algorithm_name(algorithm), host_count, cpu_count, dispatch_name(options->cluster.dispatch));
+    if (options->cluster.dispatch == DISPATCH_POWER_OF_D) printf(" (d=%d)", options->cluster.choices);
+    if (algorithm == RR) printf(", Quantum=%lld", time_quantum);
+    printf("\n");
+
+    SimTime time_limit = sim_time_limit(processes, process_count);
+
+    int next = 0;
+    bool aborted = false;
+    while (!aborted) {
+        // Run every host up to the next arrival (or, once all are dispatched, to its last completion)
+        bool dispatching = next < process_count;
+        SimTime until = dispatching ? order[next].arrival_time : SIMTIME_MAX;
+        for (int h = 0; h < host_count && !aborted; h++) {
+            Simulation *sim = &hosts[h];
+            sim->stop_time = dispatching ? until : -1;
+            while (dispatching ? sim->current_time < until : sim->completed_count < sim->process_count) {
+                SimTime from = sim->current_time;
+                int before = sim->completed_count;
+                if (!sim_step(sim) || sim->current_time > time_limit) {
+                    fprintf(stderr, "Warning: Cluster simulation exceeded maximum expected time. Aborting.\n");
+                    aborted = true;
+                    break;
+                }
+                // Jobs in system only change at step boundaries
+                queue_area[h] += (double)dispatcher.hosts.load[h] * (sim->current_time - from);
+                int finished = sim->completed_count - before;
+                if (finished > 0) dispatcher_adjust(&dispatcher, h, -finished);
+            }
+        }
+        if (!dispatching) break;
+
+        // Dispatch the arrivals at this time
+        while (next < process_count && order[next].arrival_time <= until) {
+            int host = dispatcher_pick(&dispatcher);
+            sim_add_process(&hosts[host], &processes[order[next].index]);
+            dispatcher_adjust(&dispatcher, host, +1);
+            if (dispatcher.hosts.load[host] > peak_load[host]) peak_load[host] = dispatcher.hosts.load[host];
+            next++;
+        }
+    }
+
+    SimTime current_time = 0;
+    for (int h = 0; h < host_count; h++) {
+        if (hosts[h].current_time > current_time) current_time = hosts[h].current_time;
+    }
+
+    print_cluster_results(hosts, host_count, queue_area, peak_load, current_time);
+
+    for (int h = 0; h < host_count; h++) {
+        free(hosts[h].processes);
+        sim_cleanup(&hosts[h]);
+    }
+    dispatcher_cleanup(&dispatcher);
+    free(order);
+    free(hosts);
+    free(queue_area);
+    free(peak_load);
+}
+
+/************************* LOCKSTEP SWEEPS *************************/
+
+static int *lanes_alloc(size_t count) {
+    int *values = (int *)malloc((count > 0 ? count : 1) * sizeof(int));
+    if (!values) {
+        perror("Failed to allocate lane state");
+        exit(EXIT_FAILURE);
+    }
+    return values;
+}
+
+/**
+ * Set up K = lanes configurations of the same workload. Lane k runs
+ * cpu_counts[k] CPUs with quantum quanta[k].
+ */
+void lanes_init(LaneBatch *b, const Process *processes, int process_count, Algorithm algorithm,
+                const int *cpu_counts, const int *quanta, int lanes) {
+    memset(b, 0, sizeof(*b));
+    b->processes = processes;
+    b->process_count = process_count;
+    b->lanes = lanes;
+    b->algorithm = algorithm;
+    for (int k = 0; k < lanes; k++) {
+        b->cpu_counts[k] = cpu_counts[k];
+        b->quanta[k] = quanta[k];
+        b->makespan[k] = -1;
+        if (cpu_counts[k] > b->max_cpus) b->max_cpus = cpu_counts[k];
+    }
+
+    size_t cells = (size_t)process_count * lanes;
+    b->state = lanes_alloc(cells);
+    b->rank = lanes_alloc(cells);
+    b->remaining = lanes_alloc(cells);
+    b->start = lanes_alloc(cells);
+    b->finish = lanes_alloc(cells);
+    for (int i = 0; i < process_count; i++) {
+        for (int k = 0; k < lanes; k++) {
+            size_t j = (size_t)i * lanes + k;
+            b->state[j] = WAITING;
+            b->rank[j] = algorithm == LAS ? 0 : processes[i].priority;
+            b->remaining[j] = (int)processes[i].burst_time; // simulate_sweep checks the range
+            b->start[j] = -1;
+            b->finish[j] = -1;
+        }
+    }
+
+    size_t slots = (size_t)b->max_cpus * lanes;
+    b->slot_process = lanes_alloc(slots);
+    b->slot_remaining = lanes_alloc(slots);
+    b->slot_quantum = lanes_alloc(slots);
+    b->slot_rank = lanes_alloc(slots);
+    for (size_t j = 0; j < slots; j++) {
+        b->slot_process[j] = -1;
+        b->slot_remaining[j] = b->slot_quantum[j] = b->slot_rank[j] = 0;
+    }
+
+    b->lanes_done = lanes_alloc(process_count);
+    memset(b->lanes_done, 0, (process_count > 0 ? process_count : 1) * sizeof(int));
+    b->order = lanes_alloc(process_count);
+    b->active = lanes_alloc(process_count);
+    ArrivalOrder *sorted = (ArrivalOrder *)malloc((process_count > 0 ? process_count : 1) * sizeof(ArrivalOrder));
+    if (!sorted) {
+        perror("Failed to allocate lane batch");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < process_count; i++) {
+        sorted[i].arrival_time = processes[i].arrival_time;
+        sorted[i].index = i;
+    }
+    qsort(sorted, process_count, sizeof(ArrivalOrder), compare_arrivals);
+    for (int i = 0; i < process_count; i++) b->order[i] = sorted[i].index;
+    free(sorted);
+}
+
+/**
+ * Place lane k's chosen process on an idle CPU, or preempt the lowest
+ * ranked running process if the policy allows it (the rules of
+ * handle_las_scheduling and handle_priority_scheduling).
+ * Returns false if the process cannot run this tick.
+ */
+static bool lanes_place(LaneBatch *b, int k, int best, int arrival_count) {
+    int K = b->lanes;
+
+    int target = -1;
+    for (int c = 0; c < b->cpu_counts[k] && target == -1; c++) {
+        if (b->slot_process[c * K + k] == -1) target = c * K + k;
+    }
+    if (target == -1) {
+        // Lowest ranked preemptible running process, first CPU on ties
+        int victim = -1;
+        for (int c = 0; c < b->cpu_counts[k]; c++) {
+            int s = c * K + k;
+            if (b->algorithm == LAS && arrival_count == 0 && b->slot_quantum[s] < b->quanta[k]) continue;
+            if (victim == -1 || b->slot_rank[s] < b->slot_rank[victim]) victim = s;
+        }
+        if (victim == -1 || b->rank[(size_t)best * K + k] <= b->slot_rank[victim]) return false;
+
+        // Hand the victim's state back to its process
+        size_t j = (size_t)b->slot_process[victim] * K + k;
+        b->state[j] = WAITING;
+        b->remaining[j] = b->slot_remaining[victim];
+        b->rank[j] = b->slot_rank[victim];
+        b->running[k]--;
+        target = victim;
+    }
+
+    size_t j = (size_t)best * K + k;
+    b->state[j] = RUNNING;
+    if (b->start[j] == -1) b->start[j] = b->current_time;
+    b->slot_process[target] = best;
+    b->slot_remaining[target] = b->remaining[j];
+    b->slot_quantum[target] = 0;
+    b->slot_rank[target] = b->rank[j];
+    b->running[k]++;
+    return true;
+}
+
+/**
+ * Scheduling decisions for this tick of the unfinished lanes that have
+ * one due (all of them after an arrival). Each round finds the highest
+ * ranked waiting process of every such lane in one pass over the active
+ * processes; lanes drop out once they cannot place theirs.
+ */
+static void lanes_dispatch(LaneBatch *b, int arrival_count) {
+    int K = b->lanes;
+    int open[MAX_SWEEP_LANES], best[MAX_SWEEP_LANES], best_rank[MAX_SWEEP_LANES];
+    int open_count = 0;
+    for (int k = 0; k < K; k++) {
+        open[k] = b->makespan[k] == -1 && (arrival_count > 0 || b->next_decision[k] <= b->current_time);
+        open_count += open[k];
+        if (open[k]) b->waiting_rank[k] = INT_MIN;
+    }
+
+    while (open_count > 0) {
+        for (int k = 0; k < K; k++) {
+            best[k] = -1;
+            best_rank[k] = INT_MIN;
+        }
+        // Active processes are in arrival order, so the first of equal rank arrived earliest
+        if (open_count == K) {
+            for (int a = 0; a < b->active_count; a++) {
+                int i = b->active[a];
+                size_t row = (size_t)i * K;
+                const int *state = &b->state[row], *rank = &b->rank[row];
+                for (int k = 0; k < K; k++) {
+                    int better = open[k] & (state[k] == WAITING) & (rank[k] > best_rank[k]);
+                    best_rank[k] = better ? rank[k] : best_rank[k];
+                    best[k] = better ? i : best[k];
+                }
+            }
+        } else {
+            // A few lanes: visit only their columns
+            int due[MAX_SWEEP_LANES], due_count = 0;
+            for (int k = 0; k < K; k++) {
+                if (open[k]) due[due_count++] = k;
+            }
+            for (int a = 0; a < b->active_count; a++) {
+                int i = b->active[a];
+                size_t row = (size_t)i * K;
+                for (int d = 0; d < due_count; d++) {
+                    int k = due[d];
+                    if (b->state[row + k] == WAITING && b->rank[row + k] > best_rank[k]) {
+                        best_rank[k] = b->rank[row + k];
+                        best[k] = i;
+                    }
+                }
+            }
+        }
+
+        for (int k = 0; k < K; k++) {
+            if (open[k] && (best[k] == -1 || !lanes_place(b, k, best[k], arrival_count))) {
+                b->waiting_rank[k] = best_rank[k];
+                open[k] = 0;
+                open_count--;
+            }
+        }
+    }
+}
+
+/**
+ * Charge a tick of waiting to every unfinished lane: all arrived processes
+ * that are neither running nor completed are waiting
+ */
+static void lanes_wait_kernel(LaneBatch *b) {
+    for (int k = 0; k < b->lanes; k++) {
+        b->waiting[k] += b->next_arrival - b->completed[k] - b->running[k];
+    }
+}
+
+/**
+ * Run every occupied CPU slot of every lane for one tick, then retire the
+ * processes that completed
+ */
+static void lanes_execute_kernel(LaneBatch *b) {
+    int K = b->lanes, t = b->current_time;
+    int rank_step = b->algorithm == LAS; // LAS ranks fall as service is attained
+    for (int c = 0; c < b->max_cpus; c++) {
+        const int *process = &b->slot_process[c * K];
+        int *remaining = &b->slot_remaining[c * K], *quantum = &b->slot_quantum[c * K];
+        int *rank = &b->slot_rank[c * K];
+        for (int k = 0; k < K; k++) {
+            int occupied = process[k] >= 0;
+            remaining[k] -= occupied;
+            quantum[k] += occupied;
+            rank[k] -= occupied * rank_step;
+            b->busy[k] += occupied;
+        }
+    }
+
+    for (int s = 0; s < b->max_cpus * K; s++) {
+        int i = b->slot_process[s];
+        if (i < 0 || b->slot_remaining[s] > 0) continue;
+        int k = s % K;
+        size_t j = (size_t)i * K + k;
+        b->state[j] = COMPLETED;
+        b->remaining[j] = 0;
+        b->finish[j] = t + 1;
+        b->slot_process[s] = -1;
+        b->running[k]--;
+        b->completed[k]++;
+        if (++b->lanes_done[i] == K) b->retired = true;
+        if (b->completed[k] == b->process_count) b->makespan[k] = t + 1;
+    }
+
+    // Drop processes that have completed in every lane
+    if (b->retired) {
+        int kept = 0;
+        for (int a = 0; a < b->active_count; a++) {
+            if (b->lanes_done[b->active[a]] < K) b->active[kept++] = b->active[a];
+        }
+        b->active_count = kept;
+        b->retired = false;
+    }
+}
+
+/**
+ * Work out when each lane next has a scheduling decision to make, and
+ * return the ticks from now on in which none does, so they only run the
+ * occupied slots and charge waiting. A lane decides at once if it has an
+ * idle CPU and a waiting process (a slot just completed), and under LAS
+ * when a running process has both used its quantum and fallen below the
+ * best waiting rank of its lane; PRIO ranks do not change, so only
+ * arrivals and completions lead to another PRIO decision. The quiet run
+ * also ends before the next arrival and before the tick in which some
+ * slot completes.
+ */
+static int lanes_quiet_ticks(LaneBatch *b, SimTime time_limit) {
+    int K = b->lanes;
+    SimTime quiet = time_limit - b->current_time;
+    if (b->next_arrival < b->process_count) {
+        SimTime until = b->processes[b->order[b->next_arrival]].arrival_time - b->current_time;
+        if (until < quiet) quiet = until;
+    }
+
+    SimTime decide[MAX_SWEEP_LANES];
+    for (int k = 0; k < K; k++) {
+        int waiting = b->next_arrival - b->completed[k] - b->running[k];
+        decide[k] = waiting > 0 && b->running[k] < b->cpu_counts[k] ? 0 : quiet;
+    }
+    for (int s = 0; s < b->max_cpus * K; s++) {
+        if (b->slot_process[s] < 0) continue;
+        int k = s % K;
+        if (b->slot_remaining[s] - 1 < quiet) quiet = b->slot_remaining[s] - 1;
+        // Completions do not change who is waiting, so the dispatch's best rank still holds
+        if (b->algorithm == LAS && b->waiting_rank[k] != INT_MIN) {
+            SimTime expired = (SimTime)b->quanta[k] - b->slot_quantum[s];
+            SimTime outranked = (SimTime)b->slot_rank[s] - b->waiting_rank[k] + 1;
+            SimTime preempt = expired > outranked ? expired : outranked;
+            if (preempt < decide[k]) decide[k] = preempt;
+        }
+    }
+    for (int k = 0; k < K; k++) {
+        if (decide[k] < 0) decide[k] = 0;
+        b->next_decision[k] = (int)(b->current_time + decide[k]);
+        if (decide[k] < quiet) quiet = decide[k];
+    }
+    return quiet > 0 ? (int)quiet : 0;
+}
+
+/**
+ * Advance every lane through 'ticks' quiet ticks at once
+ */
+static void lanes_skip(LaneBatch *b, int ticks) {
+    int K = b->lanes;
+    int rank_step = b->algorithm == LAS;
+    for (int c = 0; c < b->max_cpus; c++) {
+        const int *process = &b->slot_process[c * K];
+        int *remaining = &b->slot_remaining[c * K], *quantum = &b->slot_quantum[c * K];
+        int *rank = &b->slot_rank[c * K];
+        for (int k = 0; k < K; k++) {
+            int run = (process[k] >= 0) * ticks;
+            remaining[k] -= run;
+            quantum[k] += run;
+            rank[k] -= run * rank_step;
+        }
+    }
+    for (int k = 0; k < K; k++) {
+        b->busy[k] += (long)ticks * b->running[k];
+        b->waiting[k] += (long)ticks * (b->next_arrival - b->completed[k] - b->running[k]);
+    }
+    b->current_time += ticks;
+}
+
+/**
+ * Advance all lanes until every one has finished. Arrivals are processed
+ * once per tick for all lanes, and runs of ticks in which no lane has a
+ * decision to make are skipped together. Returns false if the time limit
+ * was hit.
+ */
+bool lanes_run(LaneBatch *b) {
+    SimTime time_limit = sim_time_limit(b->processes, b->process_count);
+    int finished = 0;
+    while (finished < b->lanes) {
+        if (b->current_time > time_limit) return false;
+
+        int arrival_count = 0;
+        while (b->next_arrival < b->process_count &&
+               b->processes[b->order[b->next_arrival]].arrival_time <= b->current_time) {
+            b->active[b->active_count++] = b->order[b->next_arrival++];
+            arrival_count++;
+        }
+
+        lanes_dispatch(b, arrival_count);
+        lanes_wait_kernel(b);
+        lanes_execute_kernel(b);
+
+        b->current_time++;
+        finished = 0;
+        for (int k = 0; k < b->lanes; k++) finished += b->makespan[k] != -1;
+        if (finished < b->lanes) {
+            int quiet = lanes_quiet_ticks(b, time_limit);
+            if (quiet > 0) lanes_skip(b, quiet);
+        }
+    }
+    return true;
+}
+
+/**
+ * Release a lane batch
+ */
+void lanes_cleanup(LaneBatch *b) {
+    int *fields[] = {b->state, b->rank, b->remaining, b->start, b->finish, b->slot_process,
+                     b->slot_remaining, b->slot_quantum, b->slot_rank, b->lanes_done, b->order, b->active};
+    for (size_t f = 0; f < sizeof(fields) / sizeof(fields[0]); f++) free(fields[f]);
+}
+
+static double elapsed_ms(const struct timespec *from, const struct timespec *to) {
+    return (to->tv_sec - from->tv_sec) * 1000.0 + (to->tv_nsec - from->tv_nsec) / 1e6;
+}
+
+/**
+ * Run every combination of the swept quanta and CPU counts in one lockstep
+ * batch and print a row per configuration. With --sweep-bench, also time
+ * the same configurations as independent simulations and check that both
+ * engines agree.
+ */
+void simulate_sweep(Process *processes, int process_count, int cpu_count, Algorithm algorithm,
+                    SimTime time_quantum, const SimOptions *options) {
+    (void)cpu_count;
+    (void)time_quantum;
+    const SweepOptions *sweep = &options->sweep;
+    for (int i = 0; i < process_count; i++) {
+        if (processes[i].lock_use_count > 0) {
+            fprintf(stderr, "Error: Sweeps do not model locks\n");
+            exit(EXIT_FAILURE);
+        }
+        if (processes[i].bw_quota > 0 || options->bandwidth.quota[processes[i].class_id] > 0) {
+            fprintf(stderr, "Error: Sweeps do not model CPU bandwidth limits\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    // Lanes keep 32-bit times so that more of them fit in a vector register
+    if (sim_time_limit(processes, process_count) > INT_MAX) {
+        fprintf(stderr, "Error: Sweeps support workloads spanning up to %d ticks\n", INT_MAX);
+        exit(EXIT_FAILURE);
+    }
+
+    int cpu_counts[MAX_SWEEP_LANES], quanta[MAX_SWEEP_LANES], lanes = 0;
+    for (int c = 0; c < sweep->cpu_value_count; c++) {
+        for (int q = 0; q < sweep->quantum_count; q++) {
+            cpu_counts[lanes] = sweep->cpus[c];
+            quanta[lanes] = sweep->quanta[q];
+            lanes++;
+        }
+    }
+
+    printf("\nLockstep sweep of %s over %d configuration(s), %d process(es)\n",
+           algorithm_name(algorithm), lanes, process_count);
+
+    LaneBatch batch;
+    struct timespec t0, t1;
+    double batched_ms = 0.0;
+    int rounds = sweep->bench ? SWEEP_BENCH_ROUNDS : 1;
+    for (int r = 0; r < rounds; r++) {
+        if (r > 0) lanes_cleanup(&batch);
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        lanes_init(&batch, processes, process_count, algorithm, cpu_counts, quanta, lanes);
+        bool ok = lanes_run(&batch);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        if (!ok) fprintf(stderr, "Warning: Sweep exceeded maximum expected time.\n");
+        double ms = elapsed_ms(&t0, &t1);
+        if (r == 0 || ms < batched_ms) batched_ms = ms;
+    }
+
+    printf("\n%-5s %-5s %-8s %-9s %-14s %-11s %-12s %-11s\n", "Lane", "CPUs", "Quantum", "Makespan",
+           "AvgTurnaround", "AvgWaiting", "AvgResponse", "Utilization");
+    printf("-------------------------------------------------------------------------------\n");
+    double lane_turnaround[MAX_SWEEP_LANES];
+    for (int k = 0; k < lanes; k++) {
+        double turnaround = 0.0, response = 0.0;
+        int n = 0;
+        for (int i = 0; i < process_count; i++) {
+            size_t j = (size_t)i * lanes + k;
+            if (batch.finish[j] == -1) continue;
+            turnaround += batch.finish[j] - processes[i].arrival_time;
+            response += batch.start[j] - processes[i].arrival_time;
+            n++;
+        }
+        lane_turnaround[k] = n > 0 ? turnaround / n : 0.0;
+        double capacity = (double)cpu_counts[k] * batch.makespan[k];
+        printf("%-5d %-5d %-8d %-9d %-14.2f %-11.2f %-12.2f %.2f%%\n", k, cpu_counts[k], quanta[k],
+               batch.makespan[k], lane_turnaround[k], n > 0 ? (double)batch.waiting[k] / n : 0.0,
+               n > 0 ? response / n : 0.0, capacity > 0 ? 100.0 * batch.busy[k] / capacity : 0.0);
+    }
+
+    if (options->results.path) {
+        ResultsStore store;
+        results_open(&store, options->results.path);
+        int64_t config[4] = {results_key(&store, options->results.workload),
+                             results_key(&store, ALGORITHM_KEYS[algorithm]), 0, 0};
+        for (int k = 0; k < lanes; k++) {
+            config[RESULT_CPUS] = cpu_counts[k];
+            config[RESULT_QUANTUM] = quanta[k];
+            for (int i = 0; i < process_count; i++) {
+                size_t j = (size_t)i * lanes + k;
+                results_append_process(&store, config, &processes[i], batch.start[j], batch.finish[j]);
+            }
+        }
+        results_close(&store);
+        printf("\nResults of %d configuration(s) appended to %s\n", lanes, options->results.path);
+    }
+
+    if (sweep->bench) {
+        Process *copy = (Process *)malloc(process_count * sizeof(Process));
+        if (!copy) {
+            perror("Failed to allocate benchmark processes");
+            exit(EXIT_FAILURE);
+        }
+        double independent_ms = 0.0;
+        int mismatches = 0;
+        for (int r = 0; r < SWEEP_BENCH_ROUNDS; r++) {
+            double total_ms = 0.0;
+            for (int k = 0; k < lanes; k++) {
+                memcpy(copy, processes, process_count * sizeof(Process));
+                Simulation sim;
+                clock_gettime(CLOCK_MONOTONIC, &t0);
+                sim_init(&sim, copy, process_count, process_count, cpu_counts[k], algorithm, quanta[k],
+                         options, false);
+                sim_run_quietly(&sim);
+                clock_gettime(CLOCK_MONOTONIC, &t1);
+                total_ms += elapsed_ms(&t0, &t1);
+
+                if (r == 0) {
+                    double avg_turnaround, avg_waiting, avg_response;
+                    SimTime p99;
+                    summarize_processes(copy, process_count, &avg_turnaround, &avg_waiting, &avg_response, &p99);
+                    if (sim.current_time != batch.makespan[k] || fabs(avg_turnaround - lane_turnaround[k]) > 1e-9) {
+                        mismatches++;
+                    }
+                }
+                sim_cleanup(&sim);
+            }
+            if (r == 0 || total_ms < independent_ms) independent_ms = total_ms;
+        }
+        free(copy);
+
+        printf("\nBenchmark (best of %d):\n", SWEEP_BENCH_ROUNDS);
+        printf("  Lockstep batch:       %.3f ms\n", batched_ms);
+        printf("  %2d independent runs:  %.3f ms\n", lanes, independent_ms);
+        printf("  Speedup:              %.2fx\n", batched_ms > 0 ? independent_ms / batched_ms : 0.0);
+        if (mismatches > 0) printf("  Warning: %d configuration(s) differ from the independent runs\n", mismatches);
+        else printf("  Results match the independent runs\n");
+    }
+
+    lanes_cleanup(&batch);
+}
+
+/************************* RESULTS STORE *************************/
+
+/*
+ * A results store holds one row per process per simulated configuration,
+ * column by column, so analyses read only the columns they use. Layout
+ * (host byte order):
+ *
+ *   "SCHEDCOL", int32 version (2), int32 column count
+ *   chunks: for each column, int64[rows]      (rows <= RESULTS_CHUNK_ROWS)
+ *   footer: int32 key count, then per key int32 length and its bytes;
+ *           int32 chunk count, then per chunk int64 offset, int32 rows,
+ *           int64 min[columns], int64 max[columns]
+ *   int64 footer offset, "SCHEDIDX"
+ *
+ * Workload and algorithm are stored as ids into the key dictionary. -1 in
+ * a time column means N/A (the process did not start or finish); N/A
+ * values are left out of the chunk ranges, so a column with no other
+ * value has min > max, and they fail every filter. Appending
+ * writes new chunks over the old footer and then a new, longer footer.
+ */
+
+/**
+ * Find a results column by name; -1 if there is none
+ */
+int result_column_lookup(const char *name) {
+    for (int c = 0; c < NUM_RESULT_COLUMNS; c++) {
+        if (strcmp(name, RESULT_COLUMN_NAMES[c]) == 0) return c;
+    }
+    return -1;
+}
+
+static bool result_column_is_key(int column) {
+    return column == RESULT_WORKLOAD || column == RESULT_ALGORITHM;
+}
+
+static bool result_missing(int column, int64_t value) {
+    return value == -1 && column >= RESULT_START;
+}
+
+static void results_read(ResultsStore *s, void *data, size_t size, const char *path) {
+    if (fread(data, 1, size, s->file) != size) {
+        fprintf(stderr, "Error: %s is not a valid results store\n", path);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Read an int32 count or length from the index and check that it is not
+ * negative and that that many items of item_size bytes fit before the end
+ * of the index, so a corrupt store cannot trigger a huge allocation
+ */
+static int32_t results_read_count(ResultsStore *s, size_t item_size, long index_end, const char *path) {
+    int32_t count;
+    results_read(s, &count, sizeof(count), path);
+    long position = ftell(s->file);
+    if (count < 0 || position < 0 || (uint64_t)count * item_size > (uint64_t)(index_end - position)) {
+        fprintf(stderr, "Error: %s has a corrupt index\n", path);
+        exit(EXIT_FAILURE);
+    }
+    return count;
+}
+
+/**
+ * Read the key dictionary and chunk index of an existing store
+ */
+static void results_load_index(ResultsStore *s, const char *path) {
+    char magic[8];
+    int32_t header[2];
+    results_read(s, magic, sizeof(magic), path);
+    results_read(s, header, sizeof(header), path);
+    if (memcmp(magic, "SCHEDCOL", 8) != 0 || header[0] != 2 || header[1] != NUM_RESULT_COLUMNS) {
+        fprintf(stderr, "Error: %s is not a version 2 results store\n", path);
+        exit(EXIT_FAILURE);
+    }
+
+    int64_t footer;
+    if (fseek(s->file, -(long)(sizeof(footer) + 8), SEEK_END) != 0) {
+        fprintf(stderr, "Error: %s is not a valid results store\n", path);
+        exit(EXIT_FAILURE);
+    }
+    results_read(s, &footer, sizeof(footer), path);
+    results_read(s, magic, sizeof(magic), path);
+    long index_end = ftell(s->file) - (long)(sizeof(footer) + 8);
+    if (memcmp(magic, "SCHEDIDX", 8) != 0 || footer < 0 || footer > index_end ||
+        fseek(s->file, (long)footer, SEEK_SET) != 0) {
+        fprintf(stderr, "Error: %s has no index (was it closed cleanly?)\n", path);
+        exit(EXIT_FAILURE);
+    }
+    s->data_end = footer;
+
+    // Each key takes at least its int32 length
+    int32_t count = results_read_count(s, sizeof(int32_t), index_end, path);
+    s->key_capacity = count > 0 ? count : 1;
+    s->keys = (char **)malloc(s->key_capacity * sizeof(char *));
+    if (!s->keys) {
+        perror("Failed to allocate results dictionary");
+        exit(EXIT_FAILURE);
+    }
+    for (s->key_count = 0; s->key_count < count; s->key_count++) {
+        int32_t length = results_read_count(s, 1, index_end, path);
+        char *key = (char *)malloc((size_t)length + 1);
+        if (!key) {
+            perror("Failed to allocate results dictionary");
+            exit(EXIT_FAILURE);
+        }
+        results_read(s, key, (size_t)length, path);
+        key[length] = '\0';
+        s->keys[s->key_count] = key;
+    }
+
+    count = results_read_count(s, sizeof(int64_t) + sizeof(int32_t) + 2 * NUM_RESULT_COLUMNS * sizeof(int64_t),
+                               index_end, path);
+    s->chunk_capacity = count > 0 ? count : 1;
+    s->chunks = (ResultChunk *)malloc(s->chunk_capacity * sizeof(ResultChunk));
+    if (!s->chunks) {
+        perror("Failed to allocate results index");
+        exit(EXIT_FAILURE);
+    }
+    for (s->chunk_count = 0; s->chunk_count < count; s->chunk_count++) {
+        ResultChunk *chunk = &s->chunks[s->chunk_count];
+        results_read(s, &chunk->offset, sizeof(chunk->offset), path);
+        results_read(s, &chunk->rows, sizeof(chunk->rows), path);
+        results_read(s, chunk->min, sizeof(chunk->min), path);
+        results_read(s, chunk->max, sizeof(chunk->max), path);
+        if (chunk->rows <= 0 || chunk->rows > RESULTS_CHUNK_ROWS) {
+            fprintf(stderr, "Error: %s has a corrupt index\n", path);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+static void results_free(ResultsStore *s) {
+    for (int k = 0; k < s->key_count; k++) free(s->keys[k]);
+    free(s->keys);
+    free(s->chunks);
+    for (int c = 0; c < NUM_RESULT_COLUMNS; c++) free(s->pending[c]);
+}
+
+/**
+ * Open a results store for appending, creating it if it does not exist
+ */
+void results_open(ResultsStore *s, const char *path) {
+    memset(s, 0, sizeof(*s));
+    s->file = fopen(path, "r+b");
+    if (s->file) {
+        results_load_index(s, path);
+    } else {
+        s->file = fopen(path, "w+b");
+        if (!s->file) {
+            perror("Error opening results store");
+            exit(EXIT_FAILURE);
+        }
+        int32_t header[2] = {2, NUM_RESULT_COLUMNS};
+        fwrite("SCHEDCOL", 1, 8, s->file);
+        fwrite(header, sizeof(int32_t), 2, s->file);
+        s->data_end = 8 + sizeof(header);
+    }
+    for (int c = 0; c < NUM_RESULT_COLUMNS; c++) {
+        s->pending[c] = (int64_t *)malloc(RESULTS_CHUNK_ROWS * sizeof(int64_t));
+        if (!s->pending[c]) {
+            perror("Failed to allocate results buffer");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+/**
+ * Dictionary id of a key, adding it if it is new
+ */
+int results_key(ResultsStore *s, const char *key) {
+    for (int k = 0; k < s->key_count; k++) {
+        if (strcmp(s->keys[k], key) == 0) return k;
+    }
+    if (s->key_count == s->key_capacity) {
+        s->key_capacity = s->key_capacity > 0 ? s->key_capacity * 2 : 8;
+        s->keys = (char **)realloc(s->keys, s->key_capacity * sizeof(char *));
+        if (!s->keys) {
+            perror("Failed to grow results dictionary");
+            exit(EXIT_FAILURE);
+        }
+    }
+    s->keys[s->key_count] = strdup(key);
+    if (!s->keys[s->key_count]) {
+        perror("Failed to grow results dictionary");
+        exit(EXIT_FAILURE);
+    }
+    return s->key_count++;
+}
+
+/**
+ * Write the buffered rows as one chunk and index it
+ */
+static void results_flush(ResultsStore *s) {
+    int rows = s->pending_rows;
+    if (rows == 0) return;
+    if (s->chunk_count == s->chunk_capacity) {
+        s->chunk_capacity = s->chunk_capacity > 0 ? s->chunk_capacity * 2 : 8;
+        s->chunks = (ResultChunk *)realloc(s->chunks, s->chunk_capacity * sizeof(ResultChunk));
+        if (!s->chunks) {
+            perror("Failed to grow results index");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    ResultChunk *chunk = &s->chunks[s->chunk_count++];
+    chunk->offset = s->data_end;
+    chunk->rows = rows;
+    fseek(s->file, (long)s->data_end, SEEK_SET);
+    for (int c = 0; c < NUM_RESULT_COLUMNS; c++) {
+        const int64_t *values = s->pending[c];
+        chunk->min[c] = INT64_MAX;
+        chunk->max[c] = INT64_MIN;
+        for (int r = 0; r < rows; r++) {
+            if (result_missing(c, values[r])) continue;
+            if (values[r] < chunk->min[c]) chunk->min[c] = values[r];
+            if (values[r] > chunk->max[c]) chunk->max[c] = values[r];
+        }
+        if (fwrite(values, sizeof(int64_t), rows, s->file) != (size_t)rows) {
+            perror("Error writing results store");
+            exit(EXIT_FAILURE);
+        }
+    }
+    s->data_end += (int64_t)rows * NUM_RESULT_COLUMNS * sizeof(int64_t);
+    s->pending_rows = 0;
+}
+
+/**
+ * Append one row (a value per column)
+ */
+void results_append(ResultsStore *s, const int64_t *row) {
+    for (int c = 0; c < NUM_RESULT_COLUMNS; c++) s->pending[c][s->pending_rows] = row[c];
+    if (++s->pending_rows == RESULTS_CHUNK_ROWS) results_flush(s);
+}
+
+/**
+ * Append the outcome of one process under one configuration. config holds
+ * the workload id, algorithm id, CPU count and quantum; start and finish
+ * are -1 if the process never started or finished.
+ */
+void results_append_process(ResultsStore *s, const int64_t *config, const Process *p, SimTime start,
+                            SimTime finish) {
+    int64_t row[NUM_RESULT_COLUMNS];
+    memcpy(row, config, (RESULT_PID - RESULT_WORKLOAD) * sizeof(int64_t));
+    row[RESULT_PID] = p->pid;
+    row[RESULT_ARRIVAL] = p->arrival_time;
+    row[RESULT_BURST] = p->burst_time;
+    row[RESULT_PRIORITY] = p->priority;
+    row[RESULT_START] = start;
+    row[RESULT_FINISH] = finish;
+    row[RESULT_TURNAROUND] = row[RESULT_WAITING] = -1;
+    row[RESULT_RESPONSE] = start != -1 ? start - p->arrival_time : -1;
+    if (finish != -1) {
+        SimTime turnaround = finish - p->arrival_time;
+        SimTime waiting = turnaround - p->burst_time - p->io_time;
+        row[RESULT_TURNAROUND] = turnaround;
+        row[RESULT_WAITING] = waiting > 0 ? waiting : 0;
+    }
+    results_append(s, row);
+}
+
+/**
+ * Flush the last chunk, write the dictionary and index, and close the store
+ */
+void results_close(ResultsStore *s) {
+    results_flush(s);
+    fseek(s->file, (long)s->data_end, SEEK_SET);
+
+    int32_t count = s->key_count;
+    fwrite(&count, sizeof(count), 1, s->file);
+    for (int k = 0; k < s->key_count; k++) {
+        int32_t length = (int32_t)strlen(s->keys[k]);
+        fwrite(&length, sizeof(length), 1, s->file);
+        fwrite(s->keys[k], 1, length, s->file);
+    }
+    count = s->chunk_count;
+    fwrite(&count, sizeof(count), 1, s->file);
+    for (int i = 0; i < s->chunk_count; i++) {
+        const ResultChunk *chunk = &s->chunks[i];
+        fwrite(&chunk->offset, sizeof(chunk->offset), 1, s->file);
+        fwrite(&chunk->rows, sizeof(chunk->rows), 1, s->file);
+        fwrite(chunk->min, sizeof(chunk->min), 1, s->file);
+        fwrite(chunk->max, sizeof(chunk->max), 1, s->file);
+    }
+    fwrite(&s->data_end, sizeof(s->data_end), 1, s->file);
+    fwrite("SCHEDIDX", 1, 8, s->file);
+
+    fflush(s->file);
+    if (ftruncate(fileno(s->file), ftell(s->file)) != 0 || ferror(s->file)) {
+        perror("Error writing results store");
+        exit(EXIT_FAILURE);
+    }
+    fclose(s->file);
+    results_free(s);
+}
+
+/**
+ * Aggregate of the query metric over one group
+ */
+typedef struct {
+    int64_t key;          // Value of the group-by column
+    long count;           // Matching rows with a value
+    long missing;         // Matching rows where the metric is N/A
+    double sum;
+    int64_t min;
+    int64_t max;
+} ResultGroup;
+
+static unsigned int result_group_hash(int64_t key, int table_size) {
+    uint64_t mixed = (uint64_t)key * 0x9E3779B97F4A7C15ull;
+    return (unsigned int)(mixed >> 32) & (unsigned int)(table_size - 1);
+}
+
+static int compare_result_groups(const void *a, const void *b) {
+    int64_t x = ((const ResultGroup *)a)->key, y = ((const ResultGroup *)b)->key;
+    return (x > y) - (x < y);
+}
+
+static bool result_filter_matches(FilterOp op, int64_t value, int64_t operand) {
+    switch (op) {
+        case FILTER_EQ: return value == operand;
+        case FILTER_NE: return value != operand;
+        case FILTER_LT: return value < operand;
+        case FILTER_LE: return value <= operand;
+        case FILTER_GT: return value > operand;
+        case FILTER_GE: return value >= operand;
+    }
+    return false;
+}
+
+/**
+ * Whether any value in [min, max] can pass a filter (none if min > max)
+ */
+static bool result_filter_overlaps(FilterOp op, int64_t min, int64_t max, int64_t operand) {
+    if (min > max) return false;
+    switch (op) {
+        case FILTER_EQ: return min <= operand && operand <= max;
+        case FILTER_NE: return !(min == operand && max == operand);
+        case FILTER_LT: return min < operand;
+        case FILTER_LE: return min <= operand;
+        case FILTER_GT: return max > operand;
+        case FILTER_GE: return max >= operand;
+    }
+    return true;
+}
+
+/**
+ * Filter a results store and aggregate one metric per group. Chunks whose
+ * index ranges rule out a filter are skipped unread, and only the columns
+ * the query names are read from the others.
+ */
+void results_query(const ResultsOptions *options) {
+    ResultsStore s;
+    memset(&s, 0, sizeof(s));
+    s.file = fopen(options->query, "rb");
+    if (!s.file) {
+        perror("Error opening results store");
+        exit(EXIT_FAILURE);
+    }
+    results_load_index(&s, options->query);
+
+    // Resolve operands; a key missing from the dictionary matches no id
+    int64_t operands[MAX_RESULT_FILTERS];
+    for (int f = 0; f < options->filter_count; f++) {
+        const ResultFilter *filter = &options->filters[f];
+        if (result_column_is_key(filter->column)) {
+            operands[f] = -1;
+            for (int k = 0; k < s.key_count; k++) {
+                if (strcmp(s.keys[k], filter->value) == 0) operands[f] = k;
+            }
+        } else {
+            SimTime operand;
+            if (!parse_time(filter->value, &operand) && sscanf(filter->value, "%lld", &operand) != 1) {
+                fprintf(stderr, "Error: '%s' is not a number or a time\n", filter->value);
+                exit(EXIT_FAILURE);
+            }
+            operands[f] = operand;
+        }
+    }
+
+    bool needed[NUM_RESULT_COLUMNS] = {false};
+    for (int f = 0; f < options->filter_count; f++) needed[options->filters[f].column] = true;
+    if (options->group_by >= 0) needed[options->group_by] = true;
+    needed[options->metric] = true;
+    int64_t *columns[NUM_RESULT_COLUMNS] = {NULL};
+    int columns_read = 0;
+    for (int c = 0; c < NUM_RESULT_COLUMNS; c++) {
+        if (!needed[c]) continue;
+        columns[c] = (int64_t *)malloc(RESULTS_CHUNK_ROWS * sizeof(int64_t));
+        if (!columns[c]) {
+            perror("Failed to allocate query buffer");
+            exit(EXIT_FAILURE);
+        }
+        columns_read++;
+    }
+
+    // Groups in an open-addressing table keyed by the group-by value
+    int group_capacity = 16, group_count = 0, table_size = 32;
+    ResultGroup *groups = (ResultGroup *)malloc(group_capacity * sizeof(ResultGroup));
+    int *table = (int *)malloc(table_size * sizeof(int));
+    if (!groups || !table) {
+        perror("Failed to allocate query groups");
+        exit(EXIT_FAILURE);
+    }
+    for (int t = 0; t < table_size; t++) table[t] = -1;
+
+    long total_rows = 0, matched = 0;
+    int scanned = 0, skipped = 0;
+    for (int i = 0; i < s.chunk_count; i++) {
+        const ResultChunk *chunk = &s.chunks[i];
+        total_rows += chunk->rows;
+        bool possible = true;
+        for (int f = 0; f < options->filter_count && possible; f++) {
+            int c = options->filters[f].column;
+            possible = result_filter_overlaps(options->filters[f].op, chunk->min[c], chunk->max[c], operands[f]);
+        }
+        if (!possible) {
+            skipped++;
+            continue;
+        }
+        scanned++;
+        for (int c = 0; c < NUM_RESULT_COLUMNS; c++) {
+            if (!columns[c]) continue;
+            long offset = (long)(chunk->offset + (int64_t)c * chunk->rows * sizeof(int64_t));
+            if (fseek(s.file, offset, SEEK_SET) != 0) {
+                fprintf(stderr, "Error: %s is truncated\n", options->query);
+                exit(EXIT_FAILURE);
+            }
+            results_read(&s, columns[c], chunk->rows * sizeof(int64_t), options->query);
+        }
+
+        for (int r = 0; r < chunk->rows; r++) {
+            bool match = true;
+            for (int f = 0; f < options->filter_count && match; f++) {
+                const ResultFilter *filter = &options->filters[f];
+                int64_t value = columns[filter->column][r];
+                match = !result_missing(filter->column, value) && result_filter_matches(filter->op, value, operands[f]);
+            }
+            if (!match) continue;
+            matched++;
+
+            // Keep the table at most half full
+            if ((group_count + 1) * 2 > table_size) {
+                table_size *= 2;
+                table = (int *)realloc(table, table_size * sizeof(int));
+                if (!table) {
+                    perror("Failed to grow query groups");
+                    exit(EXIT_FAILURE);
+                }
+                for (int t = 0; t < table_size; t++) table[t] = -1;
+                for (int g = 0; g < group_count; g++) {
+                    unsigned int t = result_group_hash(groups[g].key, table_size);
+                    while (table[t] != -1) t = (t + 1) & (table_size - 1);
+                    table[t] = g;
+                }
+            }
+
+            int64_t key = options->group_by >= 0 ? columns[options->group_by][r] : 0;
+            unsigned int t = result_group_hash(key, table_size);
+            while (table[t] != -1 && groups[table[t]].key != key) t = (t + 1) & (table_size - 1);
+            if (table[t] == -1) {
+                if (group_count == group_capacity) {
+                    group_capacity *= 2;
+                    groups = (ResultGroup *)realloc(groups, group_capacity * sizeof(ResultGroup));
+                    if (!groups) {
+                        perror("Failed to grow query groups");
+                        exit(EXIT_FAILURE);
+                    }
+                }
+                memset(&groups[group_count], 0, sizeof(ResultGroup));
+                groups[group_count].key = key;
+                table[t] = group_count++;
+            }
+
+            ResultGroup *g = &groups[table[t]];
+            int64_t value = columns[options->metric][r];
+            if (result_missing(options->metric, value)) {
+                g->missing++;
+                continue;
+            }
+            if (g->count == 0 || value < g->min) g->min = value;
+            if (g->count == 0 || value > g->max) g->max = value;
+            g->sum += (double)value;
+            g->count++;
+        }
+    }
+
+    const char *group_name = options->group_by >= 0 ? RESULT_COLUMN_NAMES[options->group_by] : "all";
+    printf("Query of %s: %ld of %ld rows matched\n", options->query, matched, total_rows);
+    printf("Chunks read: %d, skipped by index: %d; columns read: %d of %d\n", scanned, skipped,
+           columns_read, NUM_RESULT_COLUMNS);
+    printf("\n%-24s %-10s %-12s %-10s %-10s %-8s\n", group_name, "Count", "Mean", "Min", "Max", "N/A");
+    printf("------------------------------------------------------------------------------\n");
+    qsort(groups, group_count, sizeof(ResultGroup), compare_result_groups);
+    for (int g = 0; g < group_count; g++) {
+        const ResultGroup *group = &groups[g];
+        if (options->group_by >= 0 && result_column_is_key(options->group_by) &&
+            group->key >= 0 && group->key < s.key_count) {
+            printf("%-24s ", s.keys[group->key]);
+        } else if (options->group_by >= 0) {
+            printf("%-24" PRId64 " ", group->key);
+        } else {
+            printf("%-24s ", "all");
+        }
+        if (group->count > 0) {
+            printf("%-10ld %-12.2f %-10" PRId64 " %-10" PRId64 " %-8ld\n", group->count, group->sum / group->count,
+                   group->min, group->max, group->missing);
+        } else {
+            printf("%-10ld %-12s %-10s %-10s %-8ld\n", group->count, "N/A", "N/A", "N/A", group->missing);
+        }
+    }
+    printf("(metric: %s)\n", RESULT_COLUMN_NAMES[options->metric]);
+
+    for (int c = 0; c < NUM_RESULT_COLUMNS; c++) free(columns[c]);
+    free(groups);
+    free(table);
+    fclose(s.file);
+    results_free(&s);
+}
+
+/************************* WORK QUEUE *************************/
+
+/**
+ * Initialize a work queue holding at least capacity values
+ */
+void work_queue_init(WorkQueue *q, size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) size *= 2;
+    q->cells = (WorkCell *)malloc(size * sizeof(WorkCell));
+    if (!q->cells) {
+        perror("Failed to allocate work queue");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < size; i++) atomic_init(&q->cells[i].sequence, i);
+    q->mask = size - 1;
+    atomic_init(&q->enqueue_pos, 0);
+    atomic_init(&q->dequeue_pos, 0);
+}
+
+/**
+ * Add a value; returns false if the queue is full
+ */
+bool work_queue_push(WorkQueue *q, int value) {
+    size_t pos = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+    for (;;) {
+        WorkCell *cell = &q->cells[pos & q->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+        if (diff == 0) {
+            // Free in this lap: claim it (a failed claim reloads pos)
+            if (atomic_compare_exchange_weak_explicit(&q->enqueue_pos, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                cell->value = value;
+                atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false; // Still holds the value from the previous lap
+        } else {
+            pos = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * Take the oldest value; returns false if the queue is empty
+ */
+bool work_queue_pop(WorkQueue *q, int *value) {
+    size_t pos = atomic_load_explicit(&q->dequeue_pos, memory_order_relaxed);
+    for (;;) {
+        WorkCell *cell = &q->cells[pos & q->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->dequeue_pos, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                *value = cell->value;
+                // Free the cell for the producer one lap ahead
+                atomic_store_explicit(&cell->sequence, pos + q->mask + 1, memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false; // Not yet written in this lap
+        } else {
+            pos = atomic_load_explicit(&q->dequeue_pos, memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * Release the storage of a work queue
+ */
+void work_queue_free(WorkQueue *q) {
+    free(q->cells);
+    q->cells = NULL;
+}
+
+/**
+ * One thread of the queue benchmark. Every thread repeatedly takes a task
+ * and puts it back, spending work steps on each, so the queue always holds
+ * tasks and the threads contend only for the queue itself.
+ */
+typedef struct {
+    WorkQueue *queue;     // Lock-free queue, or NULL to use the mutex-guarded one
+    ReadyQueue *locked;
+    pthread_mutex_t *lock;
+    long operations;      // Tasks each thread takes
+    int work;             // xorshift steps per task
+    unsigned int sink;    // Keeps the work from being optimized away
+} QueueBenchThread;
+
+static void *queue_bench_worker(void *arg) {
+    QueueBenchThread *t = (QueueBenchThread *)arg;
+    unsigned int state = 1;
+    for (long n = 0; n < t->operations; n++) {
+        int task;
+        if (t->queue) {
+            while (!work_queue_pop(t->queue, &task));
+        } else {
+            pthread_mutex_lock(t->lock);
+            task = dequeue(t->locked);
+            pthread_mutex_unlock(t->lock);
+        }
+        for (int w = 0; w < t->work; w++) xorshift32(&state);
+        t->sink += state + (unsigned int)task;
+        if (t->queue) {
+            while (!work_queue_push(t->queue, task));
+        } else {
+            pthread_mutex_lock(t->lock);
+            enqueue(t->locked, task);
+            pthread_mutex_unlock(t->lock);
+        }
+    }
+    t->sink = state;
+    return NULL;
+}
+
+/**
+ * Run threads threads over the lock-free queue (or a mutex-guarded ring if
+ * lock_free is false) and return the tasks handed out per microsecond.
+ * Clears *intact unless the queue ends up holding every task exactly once.
+ */
+static double queue_bench_run(int threads, bool lock_free, int work, bool *intact) {
+    WorkQueue queue;
+    ReadyQueue locked;
+    pthread_mutex_t lock;
+    work_queue_init(&queue, QUEUE_BENCH_CAPACITY);
+    init_queue(&locked, QUEUE_BENCH_CAPACITY);
+    pthread_mutex_init(&lock, NULL);
+    for (int task = 0; task < QUEUE_BENCH_CAPACITY / 2; task++) {
+        work_queue_push(&queue, task);
+        enqueue(&locked, task);
+    }
+
+    pthread_t *ids = (pthread_t *)malloc(threads * sizeof(pthread_t));
+    QueueBenchThread *args = (QueueBenchThread *)malloc(threads * sizeof(QueueBenchThread));
+    if (!ids || !args) {
+        perror("Failed to allocate benchmark threads");
+        exit(EXIT_FAILURE);
+    }
+    long operations = QUEUE_BENCH_OPERATIONS / threads;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int t = 0; t < threads; t++) {
+        args[t] = (QueueBenchThread){lock_free ? &queue : NULL, &locked, &lock, operations, work, 0};
+        if (pthread_create(&ids[t], NULL, queue_bench_worker, &args[t]) != 0) {
+            fprintf(stderr, "Error: Failed to start benchmark thread %d\n", t);
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int t = 0; t < threads; t++) pthread_join(ids[t], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double ms = elapsed_ms(&t0, &t1);
+
+    int task, count = 0;
+    bool seen[QUEUE_BENCH_CAPACITY / 2] = {false};
+    while (lock_free ? work_queue_pop(&queue, &task) : (task = dequeue(&locked)) != -1) {
+        if (task < 0 || task >= QUEUE_BENCH_CAPACITY / 2 || seen[task]) *intact = false;
+        else seen[task] = true;
+        count++;
+    }
+    if (count != QUEUE_BENCH_CAPACITY / 2) *intact = false;
+
+    free(ids);
+    free(args);
+    pthread_mutex_destroy(&lock);
+    free_queue(&locked);
+    work_queue_free(&queue);
+    return ms > 0 ? operations * threads / (ms * 1000.0) : 0.0;
+}
+
+/**
+ * Compare the lock-free work queue with a mutex-guarded ring from one
+ * thread up to max_threads (doubling), handing out empty tasks and tasks
+ * about the size of a tiny sweep configuration, best of a few rounds
+ */
+void queue_bench(int max_threads) {
+    printf("\nWork Queue Benchmark (tasks per microsecond, best of %d, %d online CPU(s)):\n", QUEUE_BENCH_ROUNDS,
+           (int)sysconf(_SC_NPROCESSORS_ONLN));
+    printf("%-8s %-12s %-12s %-8s %-12s %-12s %-8s\n", "Threads", "Empty/LF", "Empty/Mutex", "LF/Mutex",
+           "Tiny/LF", "Tiny/Mutex", "Scaling");
+    printf("----------------------------------------------------------------------------\n");
+    double single = 0.0;
+    bool intact = true;
+    for (int threads = 1;; threads = threads * 2 < max_threads ? threads * 2 : max_threads) {
+        double rates[4] = {0.0, 0.0, 0.0, 0.0};
+        for (int r = 0; r < QUEUE_BENCH_ROUNDS; r++) {
+            for (int k = 0; k < 4; k++) {
+                double rate = queue_bench_run(threads, k % 2 == 0, k < 2 ? 0 : QUEUE_BENCH_WORK, &intact);
+                if (rate > rates[k]) rates[k] = rate;
+            }
+        }
+        if (threads == 1) single = rates[2];
+        printf("%-8d %-12.3f %-12.3f %-8.2f %-12.3f %-12.3f %.2fx\n", threads, rates[0], rates[1],
+               rates[1] > 0 ? rates[0] / rates[1] : 0.0, rates[2], rates[3], single > 0 ? rates[2] / single : 0.0);
+        if (threads >= max_threads) break;
+    }
+    printf("----------------------------------------------------------------------------\n");
+    printf("(Tiny tasks run %d xorshift steps; Scaling is Tiny/LF relative to one thread)\n", QUEUE_BENCH_WORK);
+    if (intact) printf("Every run ended with each task queued exactly once\n");
+    else printf("Warning: Tasks were lost or duplicated\n");
+}
+
+/************************* BATCH MODE *************************/
+
+/**
+ * One workload file of a batch and what simulating it produced
+ */
+typedef struct {
+    char *path;
+    long long bytes;      // File size, the estimate of its processing time
+    int process_count;    // Processes loaded (0: nothing to simulate)
+    WhatIfResult result;
+    double ms;            // Time to load and simulate the file
+} BatchJob;
+
+/**
+ * Work shared by the batch workers. Jobs are sorted largest first and
+ * queued in that order, so the pool runs longest-processing-time-first
+ * list scheduling.
+ */
+typedef struct {
+    BatchJob *jobs;
+    int job_count;
+    WorkQueue queue;      // Indices of the jobs not yet taken
+    pthread_mutex_t lock; // Guards the results store
+    Algorithm algorithm;
+    int cpu_count;
+    SimTime time_quantum;
+    const SimOptions *options;
+    ResultsStore *store;  // Rows of every file (NULL without --results)
+} BatchPool;
+
+static int compare_batch_jobs_by_size(const void *a, const void *b) {
+    const BatchJob *x = (const BatchJob *)a, *y = (const BatchJob *)b;
+    if (x->bytes != y->bytes) return x->bytes < y->bytes ? 1 : -1;
+    return strcmp(x->path, y->path);
+}
+
+static int compare_batch_jobs_by_path(const void *a, const void *b) {
+    return strcmp(((const BatchJob *)a)->path, ((const BatchJob *)b)->path);
+}
+
+static void batch_add_file(BatchJob **jobs, int *count, int *capacity, const char *path) {
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) return;
+    if (*count == *capacity) {
+        *capacity = *capacity > 0 ? *capacity * 2 : 64;
+        *jobs = (BatchJob *)realloc(*jobs, *capacity * sizeof(BatchJob));
+        if (!*jobs) {
+            perror("Failed to grow batch");
+            exit(EXIT_FAILURE);
+        }
+    }
+    BatchJob *job = &(*jobs)[(*count)++];
+    memset(job, 0, sizeof(*job));
+    job->path = strdup(path);
+    if (!job->path) {
+        perror("Failed to grow batch");
+        exit(EXIT_FAILURE);
+    }
+    job->bytes = (long long)st.st_size;
+}
+
+/**
+ * List the regular files of a directory (not its hidden files or
+ * subdirectories), or the files matching a glob pattern
+ */
+static BatchJob *batch_collect(const char *spec, int *count) {
+    BatchJob *jobs = NULL;
+    int capacity = 0;
+    *count = 0;
+
+    struct stat st;
+    if (stat(spec, &st) == 0 && S_ISDIR(st.st_mode)) {
+        DIR *dir = opendir(spec);
+        if (!dir) {
+            perror("Error opening batch directory");
+            exit(EXIT_FAILURE);
+        }
+        char path[PATH_MAX];
+        for (struct dirent *entry = readdir(dir); entry; entry = readdir(dir)) {
+            if (entry->d_name[0] == '.') continue;
+            snprintf(path, sizeof(path), "%s/%s", spec, entry->d_name);
+            batch_add_file(&jobs, count, &capacity, path);
+        }
+        closedir(dir);
+    } else {
+        glob_t matches;
+        if (glob(spec, 0, NULL, &matches) == 0) {
+            for (size_t i = 0; i < matches.gl_pathc; i++) {
+                batch_add_file(&jobs, count, &capacity, matches.gl_pathv[i]);
+            }
+        }
+        globfree(&matches);
+    }
+    return jobs;
+}
+
+/**
+ * Take jobs until none are left: load each file, simulate it quietly and
+ * keep its summary (and its rows, when there is a results store)
+ */
+static void *batch_worker(void *arg) {
+    BatchPool *pool = (BatchPool *)arg;
+    const SimOptions *options = pool->options;
+    int j;
+    while (work_queue_pop(&pool->queue, &j)) {
+        BatchJob *job = &pool->jobs[j];
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+
+        TraceOptions trace = options->trace;
+        if (!options->batch.format_given) trace.format = infer_trace_format(job->path, trace.format);
+        Process *processes = NULL;
+        if (trace.format == FORMAT_NATIVE) load_processes(job->path, &processes, &job->process_count, true);
+        else load_trace(job->path, &trace, &processes, &job->process_count, true);
+
+        if (job->process_count > 0) {
+            Simulation sim;
+            sim_init(&sim, processes, job->process_count, job->process_count, pool->cpu_count,
+                     pool->algorithm, pool->time_quantum, options, false);
+            job->result = whatif_collect(&sim, sim_run_quietly(&sim));
+            sim_cleanup(&sim);
+
+            if (pool->store) {
+                pthread_mutex_lock(&pool->lock);
+                int64_t config[4] = {results_key(pool->store, job->path),
+                                     results_key(pool->store, ALGORITHM_KEYS[pool->algorithm]),
+                                     pool->cpu_count, pool->time_quantum};
+                for (int i = 0; i < job->process_count; i++) {
+                    const Process *p = &processes[i];
+                    results_append_process(pool->store, config, p, p->start_time, p->finish_time);
+                }
+                pthread_mutex_unlock(&pool->lock);
+            }
+        }
+        free(processes);
+
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        job->ms = elapsed_ms(&t0, &t1);
+    }
+    return NULL;
+}
+
+/**
+ * Simulate every workload file of a directory or glob with the same
+ * policy and settings on a fixed pool of worker threads, largest files
+ * first, and print one table for the whole batch
+ */
+void simulate_batch(Algorithm algorithm, int cpu_count, SimTime time_quantum, const SimOptions *options) {
+    const BatchOptions *batch = &options->batch;
+    BatchPool pool;
+    memset(&pool, 0, sizeof(pool));
+    pool.jobs = batch_collect(batch->path, &pool.job_count);
+    if (pool.job_count == 0) {
+        fprintf(stderr, "Error: No workload files in %s\n", batch->path);
+        exit(EXIT_FAILURE);
+    }
+    qsort(pool.jobs, pool.job_count, sizeof(BatchJob), compare_batch_jobs_by_size);
+    work_queue_init(&pool.queue, pool.job_count);
+    for (int j = 0; j < pool.job_count; j++) work_queue_push(&pool.queue, j);
+    pthread_mutex_init(&pool.lock, NULL);
+    pool.algorithm = algorithm;
+    pool.cpu_count = cpu_count;
+    pool.time_quantum = time_quantum;
+    pool.options = options;
+
+    ResultsStore store;
+    if (options->results.path) {
+        results_open(&store, options->results.path);
+        pool.store = &store;
+    }
+
+    int workers = batch->workers < pool.job_count ? batch->workers : pool.job_count;
+    printf("\nBatch of %d file(s) from %s: %s on %d CPU(s), %d worker(s)\n", pool.job_count, batch->path,
+           algorithm_name(algorithm), cpu_count, workers);
+
+    pthread_t *threads = (pthread_t *)malloc(workers * sizeof(pthread_t));
+    if (!threads) {
+        perror("Failed to allocate batch workers");
+        exit(EXIT_FAILURE);
+    }
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int w = 0; w < workers; w++) {
+        if (pthread_create(&threads[w], NULL, batch_worker, &pool) != 0) {
+            fprintf(stderr, "Error: Failed to start batch worker %d\n", w);
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int w = 0; w < workers; w++) pthread_join(threads[w], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double wall_ms = elapsed_ms(&t0, &t1);
+    free(threads);
+    pthread_mutex_destroy(&pool.lock);
+    work_queue_free(&pool.queue);
+
+    if (pool.store) results_close(&store);
+
+    // Aggregate in file order
+    qsort(pool.jobs, pool.job_count, sizeof(BatchJob), compare_batch_jobs_by_path);
+    printf("\n%-32s %-7s %-9s %-14s %-11s %-12s %-8s %-8s %-9s\n", "File", "Procs", "Makespan",
+           "AvgTurnaround", "AvgWaiting", "AvgResponse", "P99Turn", "Util%", "ms");
+    printf("--------------------------------------------------------------------------------------------------"
+           "--------------\n");
+    long processes = 0;
+    int unfinished = 0, empty = 0;
+    double work_ms = 0.0, longest_ms = 0.0;
+    for (int j = 0; j < pool.job_count; j++) {
+        const BatchJob *job = &pool.jobs[j];
+        const WhatIfResult *r = &job->result;
+        work_ms += job->ms;
+        if (job->ms > longest_ms) longest_ms = job->ms;
+        if (job->process_count == 0) {
+            printf("%-32s %-7s\n", job->path, "empty");
+            empty++;
+            continue;
+        }
+        processes += job->process_count;
+        if (!r->finished) unfinished++;
+        printf("%-32s %-7d %-9lld %-14.2f %-11.2f %-12.2f %-8lld %-8.2f %-9.3f%s\n", job->path, job->process_count,
+               r->makespan, r->avg_turnaround, r->avg_waiting, r->avg_response, r->p99_turnaround,
+               r->utilization, job->ms, r->finished ? "" : " (timed out)");
+    }
+
+    // No schedule of these jobs on this many workers can beat the bound
+    double bound_ms = work_ms / workers > longest_ms ? work_ms / workers : longest_ms;
+    printf("\nBatch Summary:\n");
+    printf("  Files:                  %d (%d empty, %d timed out)\n", pool.job_count, empty, unfinished);
+    printf("  Processes simulated:    %ld\n", processes);
+    printf("  Wall time:              %.3f ms\n", wall_ms);
+    printf("  Sum of per-file times:  %.3f ms\n", work_ms);
+    printf("  Makespan lower bound:   %.3f ms (%.1f%% of wall time)\n", bound_ms,
+           wall_ms > 0 ? 100.0 * bound_ms / wall_ms : 0.0);
+    printf("  Speedup over serial:    %.2fx\n", wall_ms > 0 ? work_ms / wall_ms : 0.0);
+    if (options->results.path) printf("  Results appended to %s\n", options->results.path);
+
+    for (int j = 0; j < pool.job_count; j++) free(pool.jobs[j].path);
+    free(pool.jobs);
+}
+
+/************************* RESULTS DISPLAY *************************/
+
+/**
+ * Print the execution timeline visualization
+ */
+void print_timeline(int **timeline, SimTime total_time, Process *processes, int process_count, int cpu_count) {
+    printf("\nExecution Timeline:\n");
+    if (!timeline || total_time > MAX_TIMELINE_TICKS) {
+        printf("  Omitted: the run is longer than %d time units\n", MAX_TIMELINE_TICKS);
+        return;
+    }
+    int time_units_per_line = (TIMELINE_WIDTH - 5) / TIME_UNIT_WIDTH;
+    if (time_units_per_line <= 0) time_units_per_line = 1; // Ensure at least 1 unit per line
+    int time_segments = (int)((total_time + time_units_per_line - 1) / time_units_per_line);
+
+    // Print color key
+    printf("\nColor Key:\n");
+    for (int i = 0; i < process_count; i++) {
+        printf("%sPID %-2d%s ", get_color_for_pid(processes[i].pid), processes[i].pid, COLOR_RESET);
+        if ((i + 1) % 8 == 0 && i + 1 < process_count) printf("\n");
+    }
+    printf("\n");
+
+    // Print timeline in segments
+    for (int segment = 0; segment < time_segments; segment++) {
+        int start_t = segment * time_units_per_line;
+        int end_t = start_t + time_units_per_line;
+        if (end_t > total_time) end_t = (int)total_time;
+
+        printf("\nTime %d to %d:\n", start_t, end_t - 1);
+
+        // Time markers
+        printf("Time: ");
+        for (int t = start_t; t < end_t; t++) {
+            printf("%-5d", t); // Print time marker for each unit
+        }
+        printf("\n");
+
+        // CPU timelines
+        for (int c = 0; c < cpu_count; c++) {
+            printf("CPU%-2d ", c);
+            for (int t = start_t; t < end_t; t++) {
+                int pid = timeline[t][c];
+                if (pid == -1) {
+                    printf("%-*s", TIME_UNIT_WIDTH, "."); // Idle marker
+                } else {
+                    printf("%s%-*d%s", get_color_for_pid(pid), TIME_UNIT_WIDTH, pid, COLOR_RESET);
+                }
+            }
+            printf("\n");
+        }
+    }
+}
+
+/**
+ * Print detailed process statistics
+ */
+void print_process_stats(Process *processes, int process_count) {
+    printf("\nProcess Statistics:\n");
+    printf("%-6s %-7s %-7s %-7s %-7s %-7s %-7s %-7s\n",
+           "PID", "Arrival", "Burst", "Start", "Finish", "Turn.", "Waiting", "Resp.");
+    printf("----------------------------------------------------------------\n");
+
+    for (int i = 0; i < process_count; i++) {
+        Process *p = &processes[i];
+        if (p->finish_time != -1) { // Only calculate for completed processes
+            SimTime turnaround = p->finish_time - p->arrival_time;
+            SimTime waiting = turnaround - p->burst_time - p->io_time;
+            if (waiting < 0) waiting = 0; // Cannot be negative
+
+            printf("%-6d %-7lld %-7lld %-7lld %-7lld %-7lld %-7lld %-7lld\n",
+                   p->pid, p->arrival_time, p->burst_time,
+                   p->start_time, p->finish_time, turnaround, waiting, p->response_time);
+        } else {
+            printf("%-6d %-7lld %-7lld %-7s %-7s %-7s %-7s %-7s\n",
+                   p->pid, p->arrival_time, p->burst_time,
+                   (p->start_time == -1 ? "N/A" : "-"), "N/A", "N/A", "N/A",
+                   (p->response_time == -1 ? "N/A" : "-"));
+        }
+    }
+    printf("----------------------------------------------------------------\n");
+}
+
+/**
+ * Print CPU usage statistics
+ */
+void print_cpu_stats(CPU *cpus, int cpu_count) {
+    printf("\nCPU Statistics:\n");
+    printf("%-6s %-9s %-9s %-12s\n", "CPU ID", "Busy Time", "Idle Time", "Utilization");
+    printf("------------------------------------------\n");
+    for (int i = 0; i < cpu_count; i++) {
+        double utilization = 0.0;
+        SimTime cpu_total_time = cpus[i].busy_time + cpus[i].idle_time;
+        if (cpu_total_time > 0) {
+            utilization = 100.0 * cpus[i].busy_time / cpu_total_time;
+        }
+        printf("%-6d %-9lld %-9lld %-11.2f%%\n", cpus[i].id, cpus[i].busy_time, cpus[i].idle_time, utilization);
+    }
+    printf("------------------------------------------\n");
+}
+
+/**
+ * Print average performance metrics
+ */
+void print_average_stats(Process *processes, int process_count) {
+    double total_turnaround = 0.0, total_waiting = 0.0, total_response = 0.0;
+    int valid_stats_count = 0;
+
+    for (int i = 0; i < process_count; i++) {
+        Process *p = &processes[i];
+        if (p->finish_time != -1) { // Only calculate for completed processes
+            SimTime turnaround = p->finish_time - p->arrival_time;
+            SimTime waiting = turnaround - p->burst_time - p->io_time;
+            if (waiting < 0) waiting = 0;
+
+            total_turnaround += turnaround;
+            total_waiting += waiting;
+            total_response += p->response_time;
+            valid_stats_count++;
+        }
+    }
+
+    if (valid_stats_count > 0) {
+        printf("\nAverage Statistics (for %d completed processes):\n", valid_stats_count);
+        printf("  Average Turnaround Time: %.2f\n", total_turnaround / valid_stats_count);
+        printf("  Average Waiting Time:    %.2f\n", total_waiting / valid_stats_count);
+        printf("  Average Response Time:   %.2f\n", total_response / valid_stats_count);
+    } else {
+        printf("\nNo processes completed. Cannot calculate average statistics.\n");
+    }
+}
+
+/**
+ * Generate CSV output for automated testing
+ */
+void print_csv_output(Process *processes, int process_count, CPU *cpus, int cpu_count) {
+    printf("\n\n--- CSV Output ---\n");
+    
+    // Process stats CSV
+    printf("\nProcess Stats (CSV):\n");
+    printf("PID,Arrival,Burst,Priority,Start,Finish,Turnaround,Waiting,Response\n");
+    for (int i = 0; i < process_count; i++) {
+        Process *p = &processes[i];
+        if (p->finish_time != -1) {
+            SimTime turnaround = p->finish_time - p->arrival_time;
+            SimTime waiting = turnaround - p->burst_time - p->io_time;
+            if (waiting < 0) waiting = 0;
+            printf("%d,%lld,%lld,%d,%lld,%lld,%lld,%lld,%lld\n",
+                   p->pid, p->arrival_time, p->burst_time, p->priority,
+                   p->start_time, p->finish_time, turnaround, waiting, p->response_time);
+        } else {
+             printf("%d,%lld,%lld,%d,%s,%s,%s,%s,%s\n",
+                   p->pid, p->arrival_time, p->burst_time, p->priority,
+                   "N/A", "N/A", "N/A", "N/A", "N/A");
+        }
+    }
+
+    // CPU stats CSV
+    printf("\nCPU Stats (CSV):\n");
+    printf("CPU_ID,BusyTime,IdleTime,Utilization%%\n");
+    for (int i = 0; i < cpu_count; i++) {
+        double utilization = 0.0;
+        SimTime cpu_total_time = cpus[i].busy_time + cpus[i].idle_time;
+        if (cpu_total_time > 0) {
+            utilization = 100.0 * cpus[i].busy_time / cpu_total_time;
+        }
+        printf("%d,%lld,%lld,%.2f\n", cpus[i].id, cpus[i].busy_time, cpus[i].idle_time, utilization);
+    }
+
+    // Average stats CSV
+    double total_turnaround = 0.0, total_waiting = 0.0, total_response = 0.0;
+    int valid_stats_count = 0;
+    for (int i = 0; i < process_count; i++) {
+        Process *p = &processes[i];
+        if (p->finish_time != -1) {
+            SimTime turnaround = p->finish_time - p->arrival_time;
+            SimTime waiting = turnaround - p->burst_time - p->io_time;
+            if (waiting < 0) waiting = 0;
+            
+            total_turnaround += turnaround;
+            total_waiting += waiting;
+            total_response += p->response_time;
+            valid_stats_count++;
+        }
+    }
+
+    printf("\nAverage Stats (CSV):\n");
+    printf("AvgTurnaround,AvgWaiting,AvgResponse\n");
+    if (valid_stats_count > 0) {
+        printf("%.2f,%.2f,%.2f\n",
+               total_turnaround / valid_stats_count,
+               total_waiting / valid_stats_count,
+               total_response / valid_stats_count);
+    } else {
+        printf("N/A,N/A,N/A\n");
+    }
+    printf("--- End CSV Output ---\n");
+}
+
+/**
+ * Print flash device statistics: write amplification, GC activity, wear
+ * and the latency distribution seen by blocked processes
+ */
+void print_storage_stats(const Ssd *ssd, Process *processes, int process_count) {
+    printf("\nStorage Statistics (SSD, %s GC, %d%% over-provisioning):\n",
+           ssd->cfg.gc_policy == GC_GREEDY ? "greedy" : "cost-benefit", ssd->cfg.op_percent);
+    printf("------------------------------------------\n");
+    printf("  Host page writes:      %ld\n", ssd->host_writes);
+    printf("  Flash page writes:     %ld\n", ssd->flash_writes);
+    printf("  Write amplification:   %.2f\n",
+           ssd->host_writes > 0 ? (double)ssd->flash_writes / ssd->host_writes : 0.0);
+    printf("  Blocks reclaimed (GC): %ld\n", ssd->gc_runs);
+
+    int min_erase = INT_MAX, max_erase = 0;
+    for (int i = 0; i < ssd->cfg.blocks; i++) {
+        if (ssd->blocks[i].erase_count < min_erase) min_erase = ssd->blocks[i].erase_count;
+        if (ssd->blocks[i].erase_count > max_erase) max_erase = ssd->blocks[i].erase_count;
+    }
+    printf("  Erase count min/max:   %d/%d\n", min_erase, max_erase);
+
+    if (ssd->latency_count > 0) {
+        SimTime *sorted = (SimTime *)malloc(ssd->latency_count * sizeof(SimTime));
+        if (!sorted) {
+            perror("Failed to allocate latency buffer");
+            exit(EXIT_FAILURE);
+        }
+        memcpy(sorted, ssd->latencies, ssd->latency_count * sizeof(SimTime));
+        printf("  Write latency p50:     %lld\n", percentile(sorted, ssd->latency_count, 50.0));
+        printf("  Write latency p99:     %lld\n", percentile(sorted, ssd->latency_count, 99.0));
+        printf("  Write latency max:     %lld\n", sorted[ssd->latency_count - 1]);
+        free(sorted);
+    }
+
+    long total_io_time = 0;
+    for (int i = 0; i < process_count; i++) total_io_time += processes[i].io_time;
+    printf("  Total I/O blocked time: %ld\n", total_io_time);
+    printf("------------------------------------------\n");
+}
+
+/**
+ * Print lock contention, per-process blocking and priority inversion, and
+ * how the highest-priority jobs fared
+ */
+void print_lock_stats(const Simulation *sim) {
+    printf("\nLock Statistics (%s):\n", lock_protocol_name(sim->options->lock_protocol));
+    printf("------------------------------------------\n");
+    printf("%-6s %-13s %-10s %-9s\n", "Lock", "Acquisitions", "Contended", "Ceiling");
+    for (int l = 0; l < MAX_LOCKS; l++) {
+        const SimLock *lock = &sim->locks[l];
+        if (lock->acquisitions == 0) continue;
+        printf("%-6d %-13ld %-10ld %-9d\n", l, lock->acquisitions, lock->contended, lock->ceiling);
+    }
+
+    printf("\n%-6s %-9s %-10s %-10s\n", "PID", "Priority", "LockWait", "Inversion");
+    long total_inversion = 0;
+    int top_priority = INT_MIN;
+    for (int i = 0; i < sim->process_count; i++) {
+        const Process *p = &sim->processes[i];
+        if (p->base_priority > top_priority) top_priority = p->base_priority;
+        if (p->lock_use_count == 0) continue;
+        printf("%-6d %-9d %-10lld %-10lld\n", p->pid, p->base_priority, p->lock_wait_time, p->inversion_time);
+        total_inversion += p->inversion_time;
+    }
+    printf("Total priority inversion: %ld\n", total_inversion);
+
+    // Latency of the jobs the protocols exist to protect
+    for (int i = 0; i < sim->process_count; i++) {
+        const Process *p = &sim->processes[i];
+        if (p->base_priority != top_priority || p->state != COMPLETED) continue;
+        printf("Highest priority PID %d: response %lld, turnaround %lld\n",
+               p->pid, p->response_time, p->finish_time - p->arrival_time);
+    }
+    printf("------------------------------------------\n");
+}
+
+/**
+ * Print how many SRTF preemption checks ran, how many ticks needed none,
+ * and what the checks that were skipped would have cost
+ */
+void print_preemption_stats(const Simulation *sim) {
+    const PreemptionStats *st = &sim->preemption;
+    printf("\nPreemption Statistics (threshold %lld):\n", sim->options->preemption.threshold);
+    printf("------------------------------------------\n");
+    printf("Ticks under SRTF:          %ld\n", st->ticks);
+    printf("Preemption checks run:     %ld\n", st->checks);
+    printf("Checks avoided:            %ld (%.1f%%)\n", st->skipped,
+           st->ticks > 0 ? 100.0 * st->skipped / st->ticks : 0.0);
+    printf("Process visits avoided:    %ld\n", st->visits_avoided);
+    printf("Preemptions:               %ld\n", st->preemptions);
+    printf("Suppressed by threshold:   %ld\n", st->suppressed);
+    printf("------------------------------------------\n");
+}
+
+/**
+ * Print energy per CPU, time at each frequency and in each idle state,
+ * the latency processes paid for waking idle CPUs, and the energy-delay
+ * product of the whole run
+ */
+void print_energy_stats(const Simulation *sim, SimTime total_time) {
+    double seconds = total_time * sim->options->energy.tick_ms / 1000.0;
+    printf("\nEnergy Statistics (%s, %.3f ms ticks):\n", energy_policy_name(sim->options->energy.policy),
+           sim->options->energy.tick_ms);
+    printf("------------------------------------------\n");
+    printf("%-4s %-10s", "CPU", "Joules");
+    for (int l = 0; l < NUM_FREQ_LEVELS; l++) printf(" %5dMHz", FREQ_LEVELS[l].mhz);
+    for (int s = 0; s < NUM_IDLE_STATES; s++) printf(" %8s", IDLE_STATES[s].name);
+    printf(" %8s %-8s\n", "Parked", "WakeLat");
+
+    double joules = 0.0;
+    long wakeups[NUM_IDLE_STATES] = {0}, wake_ticks = 0, unparks = 0;
+    for (int c = 0; c < sim->cpu_count; c++) {
+        const CpuPower *pw = &sim->power[c];
+        printf("%-4d %-10.4f", c, pw->joules);
+        for (int l = 0; l < NUM_FREQ_LEVELS; l++) printf(" %8ld", pw->level_ticks[l]);
+        for (int s = 0; s < NUM_IDLE_STATES; s++) {
+            printf(" %8ld", pw->state_ticks[s]);
+            wakeups[s] += pw->wakeups[s];
+        }
+        printf(" %8ld %-8ld\n", pw->parked_ticks, pw->wake_ticks);
+        joules += pw->joules;
+        wake_ticks += pw->wake_ticks;
+        unparks += pw->unparks;
+    }
+
+    printf("\nWake-ups by idle state:");
+    for (int s = 0; s < NUM_IDLE_STATES; s++) {
+        printf(" %s=%ld (exit %d)", IDLE_STATES[s].name, wakeups[s], IDLE_STATES[s].exit_latency);
+    }
+    if (sim->options->energy.policy == ENERGY_CONSOLIDATE) {
+        printf(" parked=%ld (exit %d)", unparks, PARK_EXIT_LATENCY);
+    }
+    printf("\nLatency added by idle exits: %ld ticks\n", wake_ticks);
+    printf("Total energy:              %.4f J\n", joules);
+    printf("Average power:             %.3f W\n", seconds > 0 ? joules / seconds : 0.0);
+    printf("Energy-delay product:      %.6f J*s\n", joules * seconds);
+    if (sim->process_count > 0) printf("Energy per job:            %.4f J\n", joules / sim->process_count);
+    printf("------------------------------------------\n");
+}
+
+/**
+ * Print how often each bandwidth group ran out of quota, how long its
+ * members were throttled, and how much of their turnaround that explains
+ */
+void print_bandwidth_stats(const Simulation *sim) {
+    printf("\nCPU Bandwidth Statistics:\n");
+    printf("------------------------------------------\n");
+    printf("%-12s %-9s %-8s %-10s %-10s %-14s %-10s\n", "Group", "Quota", "Members", "Throttles",
+           "Throttled", "AvgTurnaround", "Throttled%");
+
+    long total_throttled = 0;
+    double total_turnaround = 0.0;
+    for (int g = 0; g < sim->bucket_count; g++) {
+        const Bucket *b = &sim->buckets[g];
+        if (b->member_count == 0) continue;
+
+        long throttled = 0;
+        double turnaround = 0.0;
+        int finished = 0;
+        for (int m = 0; m < b->member_count; m++) {
+            const Process *p = &sim->processes[b->members[m]];
+            throttled += p->throttled_time;
+            if (p->finish_time == -1) continue;
+            turnaround += p->finish_time - p->arrival_time;
+            finished++;
+        }
+        total_throttled += throttled;
+        total_turnaround += turnaround;
+
+        char name[MAX_CLASS_NAME + 8], quota[32];
+        if (b->owner_pid >= 0) snprintf(name, sizeof(name), "PID %d", b->owner_pid);
+        else snprintf(name, sizeof(name), "%s", class_name(g));
+        snprintf(quota, sizeof(quota), "%lld/%lld", b->quota, b->period);
+        printf("%-12s %-9s %-8d %-10ld %-10ld %-14.2f %.2f%%\n", name, quota, b->member_count,
+               b->throttle_count, throttled, finished > 0 ? turnaround / finished : 0.0,
+               turnaround > 0 ? 100.0 * throttled / turnaround : 0.0);
+    }
+    printf("Total throttled time: %ld (%.2f%% of limited processes' turnaround)\n", total_throttled,
+           total_turnaround > 0 ? 100.0 * total_throttled / total_turnaround : 0.0);
+    printf("------------------------------------------\n");
+}
+
+/**
+ * Print the turnaround and response percentiles of each multi-level queue
+ * level, so the latency each class sees can be compared
+ */
+void print_mlq_stats(const Simulation *sim) {
+    const MlqOptions *mlq = &sim->options->mlq;
+    int n = sim->process_count > 0 ? sim->process_count : 1;
+    SimTime *turnarounds = (SimTime *)malloc(n * sizeof(SimTime));
+    SimTime *responses = (SimTime *)malloc(n * sizeof(SimTime));
+    if (!turnarounds || !responses) {
+        perror("Failed to allocate latency buffers");
+        exit(EXIT_FAILURE);
+    }
+
+    printf("\nMulti-Level Queue Statistics (%s arbitration):\n", mlq->time_slice ? "time-slice" : "fixed-priority");
+    printf("------------------------------------------------------------------------------------------\n");
+    printf("%-6s %-12s %-9s %-6s %-6s %-6s %-9s %-20s %s\n", "Level", "Class", "Policy", "Slice", "Jobs",
+           "Done", "AvgWait", "Turn p50/p90/p99", "Resp p50/p90/p99");
+    for (int l = 0; l <= mlq->level_count; l++) {
+        int jobs = 0, done = 0;
+        double waiting = 0.0;
+        for (int i = 0; i < sim->process_count; i++) {
+            const Process *p = &sim->processes[i];
+            if (mlq->level_of[p->class_id] != l) continue;
+            jobs++;
+            if (p->finish_time == -1) continue;
+            turnarounds[done] = p->finish_time - p->arrival_time;
+            responses[done] = p->response_time;
+            SimTime wait = turnarounds[done] - p->burst_time - p->io_time;
+            waiting += wait > 0 ? wait : 0;
+            done++;
+        }
+        if (l == mlq->level_count && jobs == 0) break;
+
+        char policy[32], slice[24], turnaround[64], response[64];
+        if (mlq->policies[l] == RR) snprintf(policy, sizeof(policy), "RR q=%lld", mlq->quanta[l]);
+        else snprintf(policy, sizeof(policy), "%s", ALGORITHM_KEYS[mlq->policies[l]]);
+        if (mlq->time_slice && l < mlq->level_count) snprintf(slice, sizeof(slice), "%lld", mlq->slices[l]);
+        else snprintf(slice, sizeof(slice), "-");
+        snprintf(turnaround, sizeof(turnaround), "%lld/%lld/%lld", percentile(turnarounds, done, 50.0),
+                 percentile(turnarounds, done, 90.0), percentile(turnarounds, done, 99.0));
+        snprintf(response, sizeof(response), "%lld/%lld/%lld", percentile(responses, done, 50.0),
+                 percentile(responses, done, 90.0), percentile(responses, done, 99.0));
+        printf("%-6d %-12s %-9s %-6s %-6d %-6d %-9.2f %-20s %s\n", l,
+               l < mlq->level_count ? class_name(mlq->classes[l]) : "(others)", policy, slice, jobs, done,
+               done > 0 ? waiting / done : 0.0, done > 0 ? turnaround : "-", done > 0 ? response : "-");
+    }
+    printf("------------------------------------------------------------------------------------------\n");
+
+    free(turnarounds);
+    free(responses);
+}
+
+/**
+ * Print how much CPU time ran on and off its home node, by node and
+ * overall, and how often placement and balancing moved work
+ */
+void print_numa_stats(const Simulation *sim) {
+    const NumaState *numa = sim->numa;
+    const NumaOptions *options = &sim->options->numa;
+    printf("\nNUMA Statistics (%d nodes, remote penalty %.2fx, %s placement):\n", options->nodes, options->penalty,
+           numa_policy_name(options->policy));
+    printf("------------------------------------------------------------\n");
+    printf("%-6s %-6s %-7s %-11s %-11s %-8s\n", "Node", "CPUs", "Homed", "Local", "Remote", "Remote%");
+
+    long local = 0, remote = 0;
+    for (int n = 0; n < options->nodes; n++) {
+        int cpus = 0, homed = 0;
+        for (int c = 0; c < sim->cpu_count; c++) cpus += numa->cpu_node[c] == n;
+        for (int i = 0; i < sim->process_count; i++) homed += sim->processes[i].home_node == n;
+        long total = numa->local_ticks[n] + numa->remote_ticks[n];
+        printf("%-6d %-6d %-7d %-11ld %-11ld %.2f%%\n", n, cpus, homed, numa->local_ticks[n], numa->remote_ticks[n],
+               total > 0 ? 100.0 * numa->remote_ticks[n] / total : 0.0);
+        local += numa->local_ticks[n];
+        remote += numa->remote_ticks[n];
+    }
+    printf("------------------------------------------------------------\n");
+
+    // Slowdown: CPU time beyond the bursts, all of it spent remote or migrating memory
+    SimTime work = 0;
+    int mostly_remote = 0;
+    for (int i = 0; i < sim->process_count; i++) {
+        const Process *p = &sim->processes[i];
+        work += p->burst_time - p->remaining_time;
+        if (p->remote_time > p->local_time) mostly_remote++;
+    }
+    long total = local + remote;
+    printf("Runtime local/remote:     %.2f%% / %.2f%% (%ld / %ld ticks)\n", total > 0 ? 100.0 * local / total : 0.0,
+           total > 0 ? 100.0 * remote / total : 0.0, local, remote);
+    printf("Lost to remote memory:    %lld ticks (%.2f%% of CPU time)\n", total - work,
+           total > 0 ? 100.0 * (total - work) / total : 0.0);
+    printf("Processes mostly remote:  %d of %d\n", mostly_remote, sim->process_count);
+    printf("Task migrations:          %ld\n", numa->migrations);
+    if (options->policy == NUMA_BALANCE) printf("Memory migrations:        %ld\n", numa->memory_migrations);
+    printf("------------------------------------------------------------\n");
+}
+
+/**
+ * Print per-host load, load imbalance and end-to-end latency percentiles
+ * for a cluster run
+ */
+void print_cluster_results(Simulation *hosts, int host_count, const double *queue_area, const int *peak_load,
+                           SimTime total_time) {
+    printf("\n--- Cluster Results ---\n");
+    printf("\nHost Statistics:\n");
+    printf("%-6s %-7s %-9s %-12s %-10s %-8s\n", "Host", "Jobs", "Busy Time", "Utilization", "Avg Queue", "Peak");
+    printf("-------------------------------------------------------\n");
+
+    int job_count = 0, max_jobs = 0;
+    double total_busy = 0.0, max_busy = 0.0, sum_sq_busy = 0.0;
+    for (int h = 0; h < host_count; h++) {
+        Simulation *sim = &hosts[h];
+        long busy = 0;
+        for (int c = 0; c < sim->cpu_count; c++) busy += sim->cpus[c].busy_time;
+        double capacity = (double)sim->cpu_count * total_time;
+        double utilization = capacity > 0 ? 100.0 * busy / capacity : 0.0;
+        double avg_queue = total_time > 0 ? queue_area[h] / total_time : 0.0;
+
+        printf("%-6d %-7d %-9ld %-11.2f%% %-10.2f %-8d\n",
+               h, sim->process_count, busy, utilization, avg_queue, peak_load[h]);
+
+        job_count += sim->process_count;
+        if (sim->process_count > max_jobs) max_jobs = sim->process_count;
+        total_busy += busy;
+        sum_sq_busy += (double)busy * busy;
+        if (busy > max_busy) max_busy = busy;
+    }
+    printf("-------------------------------------------------------\n");
+
+    double mean_jobs = (double)job_count / host_count;
+    double mean_busy = total_busy / host_count;
+    double variance = sum_sq_busy / host_count - mean_busy * mean_busy;
+    double cv_busy = mean_busy > 0 ? sqrt(variance > 0 ? variance : 0) / mean_busy : 0.0;
+    printf("\nLoad Imbalance:\n");
+    printf("  Max/Mean Jobs:      %.2f\n", mean_jobs > 0 ? max_jobs / mean_jobs : 0.0);
+    printf("  Max/Mean Busy Time: %.2f\n", mean_busy > 0 ? max_busy / mean_busy : 0.0);
+    printf("  CoV of Busy Time:   %.2f\n", cv_busy);
+
+    // End-to-end latency: dispatch is instantaneous, so turnaround is arrival to finish
+    SimTime *turnarounds = (SimTime *)malloc((job_count > 0 ? job_count : 1) * sizeof(SimTime));
+    SimTime *responses = (SimTime *)malloc((job_count > 0 ? job_count : 1) * sizeof(SimTime));
+    if (!turnarounds || !responses) {
+        perror("Failed to allocate latency buffers");
+        exit(EXIT_FAILURE);
+    }
+    int n = 0;
+    double total_turnaround = 0.0;
+    for (int h = 0; h < host_count; h++) {
+        for (int i = 0; i < hosts[h].process_count; i++) {
+            Process *p = &hosts[h].processes[i];
+            if (p->finish_time == -1) continue;
+            turnarounds[n] = p->finish_time - p->arrival_time;
+            responses[n] = p->response_time;
+            total_turnaround += turnarounds[n];
+            n++;
+        }
+    }
+
+    printf("\nEnd-to-End Latency (%d of %d jobs completed):\n", n, job_count);
+    if (n > 0) {
+        SimTime t50 = percentile(turnarounds, n, 50.0), t90 = percentile(turnarounds, n, 90.0);
+        SimTime t99 = percentile(turnarounds, n, 99.0), tmax = turnarounds[n - 1];
+        SimTime r50 = percentile(responses, n, 50.0), r99 = percentile(responses, n, 99.0);
+        printf("  Turnaround mean/p50/p90/p99/max: %.2f/%lld/%lld/%lld/%lld\n",
+               total_turnaround / n, t50, t90, t99, tmax);
+        printf("  Response p50/p99:                %lld/%lld\n", r50, r99);
+
+        printf("\nCluster Latency (CSV):\n");
+        printf("Jobs,AvgTurnaround,P50,P90,P99,Max,ResponseP50,ResponseP99\n");
+        printf("%d,%.2f,%lld,%lld,%lld,%lld,%lld,%lld\n", n, total_turnaround / n, t50, t90, t99, tmax, r50, r99);
+    }
+    printf("Makespan: %lld\n", total_time);
+
+    free(turnarounds);
+    free(responses);
+}
+
+/**
+ * Summarize completed processes: mean turnaround, waiting and response,
+ * and the 99th-percentile turnaround
+ */
+void summarize_processes(const Process *processes, int process_count, double *avg_turnaround,
+                         double *avg_waiting, double *avg_response, SimTime *p99_turnaround) {
+    SimTime *turnarounds = (SimTime *)malloc((process_count > 0 ? process_count : 1) * sizeof(SimTime));
+    if (!turnarounds) {
+        perror("Failed to allocate turnaround buffer");
+        exit(EXIT_FAILURE);
+    }
+    double total_turnaround = 0.0, total_waiting = 0.0, total_response = 0.0;
+    int n = 0;
+    for (int i = 0; i < process_count; i++) {
+        const Process *p = &processes[i];
+        if (p->finish_time == -1) continue;
+        SimTime turnaround = p->finish_time - p->arrival_time;
+        SimTime waiting = turnaround - p->burst_time - p->io_time;
+        if (waiting < 0) waiting = 0;
+        turnarounds[n++] = turnaround;
+        total_turnaround += turnaround;
+        total_waiting += waiting;
+        total_response += p->response_time;
+    }
+    *avg_turnaround = n > 0 ? total_turnaround / n : 0.0;
+    *avg_waiting = n > 0 ? total_waiting / n : 0.0;
+    *avg_response = n > 0 ? total_response / n : 0.0;
+    *p99_turnaround = percentile(turnarounds, n, 99.0);
+    free(turnarounds);
+}
+
+/**
+ * Compare a schedule built from predicted bursts with the oracle schedule
+ * that knows every burst exactly
+ */
+void print_prediction_report(const Predictor *pred, Process *predicted, Process *oracle, int process_count) {
+    printf("\nPrediction Accuracy (exponential averaging by %s, alpha=%.2f, initial=%lld):\n",
+           pred->mode == PREDICT_CLASS ? "class" : "PID", pred->alpha, pred->initial_estimate);
+    if (pred->samples > 0) {
+        printf("  Mean absolute error: %.2f\n", pred->total_abs_error / pred->samples);
+        printf("  Mean relative error: %.2f%%\n", 100.0 * pred->total_rel_error / pred->samples);
+    }
+
+    double pt, pw, pr, ot, ow, orr;
+    SimTime p99p, p99o;
+    summarize_processes(predicted, process_count, &pt, &pw, &pr, &p99p);
+    summarize_processes(oracle, process_count, &ot, &ow, &orr, &p99o);
+
+    int same_start = 0;
+    for (int i = 0; i < process_count; i++) {
+        if (predicted[i].start_time == oracle[i].start_time) same_start++;
+    }
+
+    printf("\nPredicted vs Oracle Schedule:\n");
+    printf("%-16s %-10s %-10s %-10s\n", "Metric", "Predicted", "Oracle", "Gap");
+    printf("----------------------------------------------\n");
+    printf("%-16s %-10.2f %-10.2f %+.2f%%\n", "Avg Turnaround", pt, ot, ot > 0 ? 100.0 * (pt - ot) / ot : 0.0);
+    printf("%-16s %-10.2f %-10.2f %+.2f%%\n", "Avg Waiting", pw, ow, ow > 0 ? 100.0 * (pw - ow) / ow : 0.0);
+    printf("%-16s %-10.2f %-10.2f %+.2f%%\n", "Avg Response", pr, orr, orr > 0 ? 100.0 * (pr - orr) / orr : 0.0);
+    printf("%-16s %-10lld %-10lld %+lld\n", "P99 Turnaround", p99p, p99o, p99p - p99o);
+    printf("----------------------------------------------\n");
+    printf("  Jobs started at the oracle's time: %d/%d\n", same_start, process_count);
+}
+
+/**
+ * Display all simulation results
+ */
+void print_results(Process *processes, int process_count, CPU *cpus, int cpu_count, int **timeline, SimTime total_time) {
+    printf("\n--- Simulation Results ---\n");
+
+    // Print visual timeline
+    print_timeline(timeline, total_time, processes, process_count, cpu_count);
+    
+    // Print detailed statistics
+    print_process_stats(processes, process_count);
+    print_cpu_stats(cpus, cpu_count);
+    print_average_stats(processes, process_count);
+    
+    // Print CSV output for automated testing
+    print_csv_output(processes, process_count, cpus, cpu_count);
+}
+
+/************************* MAIN FUNCTION *************************/
+
+int main(int argc, char *argv[]) {
+    Algorithm algorithm = FCFS;
+    int cpu_count = 1;
+    SimTime time_quantum = DEFAULT_TIME_QUANTUM;
+    char *input_file = NULL;
+    SimOptions options;
+
+    // Parse command line arguments
+    parse_arguments(argc, argv, &algorithm, &cpu_count, &time_quantum, &input_file, &options);
+    if (options.results.query) {
+        results_query(&options.results);
+        return EXIT_SUCCESS;
+    }
+    if (options.batch.queue_bench) {
+        queue_bench(options.batch.workers < MAX_QUEUE_BENCH_THREADS ? options.batch.workers : MAX_QUEUE_BENCH_THREADS);
+        return EXIT_SUCCESS;
+    }
+    if (options.batch.path) {
+        simulate_batch(algorithm, cpu_count, time_quantum, &options);
+        return EXIT_SUCCESS;
+    }
+    if (options.checkpoint.resume) {
+        checkpoint_read_config(options.checkpoint.resume, &algorithm, &cpu_count, &time_quantum, &options);
+    }
+
+    // Load processes
+    Process *processes = NULL;
+    int process_count = 0;
+    if (options.trace.format == FORMAT_NATIVE) {
+        load_processes(input_file, &processes, &process_count, false);
+    } else {
+        load_trace(input_file, &options.trace, &processes, &process_count, false);
+    }
+    checkpoint_check_support(&options, algorithm, processes, process_count);
+
+    // Run simulation if processes were loaded successfully
+    if (process_count > 0 && options.sweep.quantum_count > 0) {
+        simulate_sweep(processes, process_count, cpu_count, algorithm, time_quantum, &options);
+    } else if (process_count > 0 && options.whatif.branch_count > 0) {
+        simulate_whatif(processes, process_count, cpu_count, algorithm, time_quantum, &options);
+    } else if (process_count > 0 && options.validate) {
+        simulate_validate(processes, process_count, cpu_count, algorithm, time_quantum, &options);
+    } else if (process_count > 0 && options.decisions.replay) {
+        simulate_replay(processes, process_count, &options);
+    } else if (process_count > 0 && options.cluster.hosts > 1) {
+        simulate_cluster(processes, process_count, cpu_count, algorithm, time_quantum, &options);
+    } else if (process_count > 0) {
+        simulate(processes, process_count, cpu_count, algorithm, time_quantum, &options);
+    } else {
+        printf("No processes loaded or simulation not possible.\n");
+    }
+
+    // Clean up
+    free(processes);
+    return EXIT_SUCCESS;
+}
@@ -17,14 +17,18 @@ The framework tests multiple scheduling algorithms:
 - Shortest Job First (SJF)
 - Shortest Remaining Time First (SRTF)
 - Round-Robin (RR) with configurable quantum
+- Preemptive Priority (PRIO) with shared locks under each lock protocol
 
 It also tests various edge cases:
-- Priority inversion scenarios
+- Priority inversion scenarios, with and without priority inheritance or ceilings
 - Many short jobs (starvation potential)
 - Multiple CPUs
 - Simultaneous job arrivals
 - Tie-breaking rules
 
+and checks that a run resumed from checkpoints matches a full re-run of the
+edited workload, and that a recorded schedule verifies against a fresh run.
+
 Usage:
     python test_scheduler.py [options]
 
@@ -36,8 +40,8 @@ Options:
     --no-cleanup         Keep generated test files
 
 Example:
-    # Compile your scheduler
-    gcc scheduler.c -o scheduler -lm
+    # Compile your scheduler (scheduler.c) with the simulator
+    make
     
     # Run the tests
     python test_scheduler.py --verbose
@@ -68,13 +72,18 @@ COLOR_BOLD = "\033[1m" if _supports_color else ""
 COLOR_RESET = "\033[0m" if _supports_color else ""
 
 # --- Types ---
-TestCase = Tuple[str, str, int, int, str, Dict[str, List[Dict[str, str]]]]
+# (name, algorithm, cpus, quantum, input file, expected results[, extra scheduler arguments])
+TestCase = Union[Tuple[str, str, int, int, str, Dict[str, List[Dict[str, str]]]],
+                 Tuple[str, str, int, int, str, Dict[str, List[Dict[str, str]]], List[str]]]
+# (name, kind, algorithm, cpus, quantum, input file, edited input file)
+ConsistencyCheck = Tuple[str, str, str, int, int, str, str]
 ResultsDict = Dict[str, List[Dict[str, str]]]
 
 
 # --- Helper Functions ---
 def run_scheduler(executable: str, algorithm: str, cpus: int, quantum: int, 
-                  input_file: str, verbose: bool = False) -> Optional[str]:
+                  input_file: str, verbose: bool = False,
+                  extra_args: Optional[List[str]] = None) -> Optional[str]:
     """
     Run the CPU scheduler executable with the specified parameters.
     
@@ -85,6 +94,7 @@ def run_scheduler(executable: str, algorithm: str, cpus: int, quantum: int,
         quantum: Time quantum for Round Robin (ignored for other algorithms)
         input_file: Path to the process input file
         verbose: Whether to print the scheduler's output
+        extra_args: Further command-line arguments (e.g. --lock-protocol inherit)
         
     Returns:
         The stdout output from the scheduler, or None if execution failed
@@ -97,6 +107,8 @@ def run_scheduler(executable: str, algorithm: str, cpus: int, quantum: int,
     ]
     if algorithm == 'RR':
         cmd.extend(['-q', str(quantum)])
+    if extra_args:
+        cmd.extend(extra_args)
 
     try:
         print(f"Running: {' '.join(cmd)}")
@@ -418,6 +430,29 @@ def create_test_files() -> Dict[str, str]:
         f.write("3 2 3 4\n")      # High priority, arrives third
         f.write("4 3 1 3\n")      # Medium priority
         f.write("5 4 2 2\n")      # Low-medium priority
+
+    # Priority inversion through a shared lock
+    test_files['lock_inversion'] = 'test_processes_lock_inversion.txt'
+    with open(test_files['lock_inversion'], 'w') as f:
+        f.write("# PID Arrival Burst Priority\n")
+        f.write("1 0 4 1 lock=1:0:3\n")   # Low priority, holds lock 1 for its first 3 ticks
+        f.write("2 1 6 3\n")              # Medium priority, no locks
+        f.write("3 2 2 5 lock=1:0:1\n")   # High priority, needs lock 1 straight away
+
+    # Scenario two with a longer last job, for resuming from checkpoints
+    test_files['scenario_two_edited'] = 'test_processes_scenario_two_edited.txt'
+    with open(test_files['scenario_two_edited'], 'w') as f:
+        f.write("# PID Arrival Burst Priority\n")
+        f.write("1 0 8 2\n")
+        f.write("2 1 2 3\n")
+        f.write("3 2 4 1\n")
+        f.write("4 3 6 2\n")
+        f.write("5 4 7 3\n")
+        f.write("6 5 9 1\n")      # Burst 5 in scenario two
+
+    # Written by the consistency checks
+    test_files['checkpoints'] = 'test_checkpoints.bin'
+    test_files['decisions'] = 'test_decisions.log'
     
     return test_files
 
@@ -729,8 +764,99 @@ def define_test_cases(test_files: Dict[str, str]) -> List[TestCase]:
         ),
     ]
 
+    lock_tests = [
+        # No protocol: the medium job keeps the lock owner off the CPU
+        (
+            "PRIO_LOCK_NONE", "PRIO", 1, 0, test_files['lock_inversion'],
+            {
+                'process': [
+                    {'PID': '1', 'Arrival': '0', 'Burst': '4', 'Priority': '1', 'Start': '0', 'Finish': '12', 'Turnaround': '12', 'Waiting': '8', 'Response': '0'},
+                    {'PID': '2', 'Arrival': '1', 'Burst': '6', 'Priority': '3', 'Start': '1', 'Finish': '7', 'Turnaround': '6', 'Waiting': '0', 'Response': '0'},
+                    {'PID': '3', 'Arrival': '2', 'Burst': '2', 'Priority': '5', 'Start': '2', 'Finish': '11', 'Turnaround': '9', 'Waiting': '7', 'Response': '0'},
+                ],
+                'cpu': [{'CPU_ID': '0', 'BusyTime': '12', 'IdleTime': '0', 'Utilization%': '100.00'}],
+                'average': [{'AvgTurnaround': '9.00', 'AvgWaiting': '5.00', 'AvgResponse': '0.00'}]
+            },
+            ['--lock-protocol', 'none']
+        ),
+        # Inheritance: the owner runs at the blocked job's priority until it releases the lock
+        (
+            "PRIO_LOCK_INHERIT", "PRIO", 1, 0, test_files['lock_inversion'],
+            {
+                'process': [
+                    {'PID': '1', 'Arrival': '0', 'Burst': '4', 'Priority': '1', 'Start': '0', 'Finish': '12', 'Turnaround': '12', 'Waiting': '8', 'Response': '0'},
+                    {'PID': '2', 'Arrival': '1', 'Burst': '6', 'Priority': '3', 'Start': '1', 'Finish': '11', 'Turnaround': '10', 'Waiting': '4', 'Response': '0'},
+                    {'PID': '3', 'Arrival': '2', 'Burst': '2', 'Priority': '5', 'Start': '2', 'Finish': '6', 'Turnaround': '4', 'Waiting': '2', 'Response': '0'},
+                ],
+                'cpu': [{'CPU_ID': '0', 'BusyTime': '12', 'IdleTime': '0', 'Utilization%': '100.00'}],
+                'average': [{'AvgTurnaround': '8.67', 'AvgWaiting': '4.67', 'AvgResponse': '0.00'}]
+            },
+            ['--lock-protocol', 'inherit']
+        ),
+        # Ceiling: the owner runs at priority 5 from the moment it takes the lock
+        (
+            "PRIO_LOCK_CEILING", "PRIO", 1, 0, test_files['lock_inversion'],
+            {
+                'process': [
+                    {'PID': '1', 'Arrival': '0', 'Burst': '4', 'Priority': '1', 'Start': '0', 'Finish': '12', 'Turnaround': '12', 'Waiting': '8', 'Response': '0'},
+                    {'PID': '2', 'Arrival': '1', 'Burst': '6', 'Priority': '3', 'Start': '5', 'Finish': '11', 'Turnaround': '10', 'Waiting': '4', 'Response': '4'},
+                    {'PID': '3', 'Arrival': '2', 'Burst': '2', 'Priority': '5', 'Start': '3', 'Finish': '5', 'Turnaround': '3', 'Waiting': '1', 'Response': '1'},
+                ],
+                'cpu': [{'CPU_ID': '0', 'BusyTime': '12', 'IdleTime': '0', 'Utilization%': '100.00'}],
+                'average': [{'AvgTurnaround': '8.33', 'AvgWaiting': '4.33', 'AvgResponse': '1.67'}]
+            },
+            ['--lock-protocol', 'ceiling']
+        ),
+    ]
+
     # Combine all tests
-    return fcfs_tests + sjf_tests + srtf_tests + rr_tests
+    return fcfs_tests + sjf_tests + srtf_tests + rr_tests + lock_tests
+
+
+def unfinished_processes(results: ResultsDict) -> List[str]:
+    """
+    Find the processes a run did not finish.
+    
+    Args:
+        results: Dictionary of results from the scheduler
+        
+    Returns:
+        PIDs of the process rows whose finish time or metrics are not numbers
+    """
+    unfinished = []
+    for row in results.get('process', []):
+        for col in ["Start", "Finish", "Turnaround", "Waiting", "Response"]:
+            try:
+                int(row.get(col, 'N/A'))
+            except ValueError:
+                unfinished.append(row.get('PID', '?'))
+                break
+    return unfinished
+
+
+def define_consistency_checks(test_files: Dict[str, str]) -> List[ConsistencyCheck]:
+    """
+    Define the checks that compare two runs of the scheduler with each other.
+    
+    'resume' checkpoints a run of the input file, resumes the edited file from
+    those checkpoints and expects the results of a full run of the edited file.
+    'verify' records the schedule of the input file and verifies a second run
+    of it against the log.
+    
+    Args:
+        test_files: Dictionary mapping test file identifiers to their file paths
+        
+    Returns:
+        List of consistency check tuples
+    """
+    base, edited = test_files['scenario_two'], test_files['scenario_two_edited']
+    return [
+        ("FCFS_RESUME", 'resume', "FCFS", 1, 0, base, edited),
+        ("SRTF_RESUME", 'resume', "SRTF", 1, 0, base, edited),
+        ("RR_RESUME_Q2", 'resume', "RR", 1, 2, base, edited),
+        ("SRTF_RECORD_VERIFY", 'verify', "SRTF", 2, 0, base, base),
+        ("RR_RECORD_VERIFY_Q2", 'verify', "RR", 1, 2, base, base),
+    ]
 
 
 def run_tests(executable_path: str, tests: List[TestCase], verbose: bool = False) -> Tuple[int, int]:
@@ -750,12 +876,14 @@ def run_tests(executable_path: str, tests: List[TestCase], verbose: bool = False
 
     print(f"{COLOR_CYAN}--- Running {total_tests} Test Cases ---{COLOR_RESET}")
 
-    for name, algo, cpus, quantum, infile, expected in tests:
+    for test in tests:
+        name, algo, cpus, quantum, infile, expected = test[:6]
+        extra_args = test[6] if len(test) > 6 else []
         print(f"\n{COLOR_YELLOW}--- Test: {name} ({algo}, {cpus} CPU(s), "
               f"Q={quantum if algo=='RR' else 'N/A'}) ---{COLOR_RESET}")
 
         # Run scheduler
-        output = run_scheduler(executable_path, algo, cpus, quantum, infile, verbose)
+        output = run_scheduler(executable_path, algo, cpus, quantum, infile, verbose, extra_args)
         if output is None:
             print(f"{COLOR_RED}>>> TEST FAILED (Scheduler execution error){COLOR_RESET}")
             continue
@@ -781,12 +909,86 @@ def run_tests(executable_path: str, tests: List[TestCase], verbose: bool = False
     return passed_tests, total_tests
 
 
+def run_consistency_checks(executable_path: str, checks: List[ConsistencyCheck],
+                           test_files: Dict[str, str], verbose: bool = False) -> Tuple[int, int]:
+    """
+    Run checks that compare two scheduler runs and report results.
+    
+    Args:
+        executable_path: Path to the scheduler executable
+        checks: List of consistency check tuples to run
+        test_files: Dictionary of test file paths (for the checkpoint and log files)
+        verbose: Whether to show detailed scheduler output
+        
+    Returns:
+        Tuple containing (passed_count, total_count)
+    """
+    total_checks = len(checks)
+    passed_checks = 0
+
+    print(f"\n{COLOR_CYAN}--- Running {total_checks} Consistency Checks ---{COLOR_RESET}")
+
+    for name, kind, algo, cpus, quantum, infile, edited in checks:
+        print(f"\n{COLOR_YELLOW}--- Check: {name} ({algo}, {cpus} CPU(s), "
+              f"Q={quantum if algo=='RR' else 'N/A'}) ---{COLOR_RESET}")
+
+        if kind == 'resume':
+            checkpoints = test_files['checkpoints']
+            runs = [
+                run_scheduler(executable_path, algo, cpus, quantum, infile, verbose,
+                              ['--checkpoint', checkpoints, '--checkpoint-every', '2']),
+                run_scheduler(executable_path, algo, cpus, quantum, edited, verbose),
+                run_scheduler(executable_path, algo, cpus, quantum, edited, verbose,
+                              ['--resume', checkpoints]),
+            ]
+        else:
+            decisions = test_files['decisions']
+            runs = [
+                run_scheduler(executable_path, algo, cpus, quantum, infile, verbose,
+                              ['--record', decisions]),
+                run_scheduler(executable_path, algo, cpus, quantum, edited, verbose,
+                              ['--verify', decisions]),
+            ]
+        if any(output is None for output in runs):
+            print(f"{COLOR_RED}>>> CHECK FAILED (Scheduler execution error){COLOR_RESET}")
+            continue
+
+        results = [parse_all_csv(output) for output in runs]
+        if any(result is None for result in results):
+            print(f"{COLOR_RED}>>> CHECK FAILED (CSV parsing error){COLOR_RESET}")
+            continue
+
+        # Two runs that both schedule nothing agree trivially, so every run must finish every process
+        mismatches = []
+        for run, result in enumerate(results):
+            for pid in unfinished_processes(result):
+                mismatches.append(f"Run {run+1}: PID {pid} has no finish time or metrics")
+
+        if not mismatches and kind == 'resume':
+            mismatches = compare_results(results[2], results[1])
+        elif not mismatches:
+            verdict = next((line for line in runs[1].splitlines() if line.startswith("Schedule ")), None)
+            if verdict is None or not verdict.startswith("Schedule matches"):
+                mismatches.append(f"Verification: expected 'Schedule matches ...', got {verdict!r}")
+
+        if not mismatches:
+            print(f"{COLOR_GREEN}{COLOR_BOLD}>>> CHECK PASSED{COLOR_RESET}")
+            passed_checks += 1
+        else:
+            print(f"{COLOR_RED}{COLOR_BOLD}>>> CHECK FAILED{COLOR_RESET}")
+            print(f"{COLOR_RED}Mismatches found:{COLOR_RESET}")
+            for mismatch in mismatches:
+                print(f"  - {mismatch}")
+
+    return passed_checks, total_checks
+
+
 def main() -> None:
     """Main function to parse arguments and execute tests."""
     parser = argparse.ArgumentParser(description="Test harness for the CPU scheduler implementation.")
     parser.add_argument('--executable', default=SCHEDULER_EXECUTABLE,
                         help=f"Path to the scheduler executable (default: {SCHEDULER_EXECUTABLE})")
-    parser.add_argument('--algorithm', choices=['FCFS', 'SJF', 'SRTF', 'RR'], 
+    parser.add_argument('--algorithm', choices=['FCFS', 'SJF', 'SRTF', 'RR', 'PRIO'], 
                         help="Run only tests for specified algorithm")
     parser.add_argument('--test', help="Run only the specified test by name")
     parser.add_argument('--verbose', action='store_true', help="Show detailed scheduler output")
@@ -797,7 +999,7 @@ def main() -> None:
 
     if not os.path.exists(executable_path):
         print(f"{COLOR_RED}Error: Executable '{executable_path}' not found.{COLOR_RESET}")
-        print("Please compile the C code (e.g., gcc scheduler.c -o scheduler -lm) or provide the correct path.")
+        print("Please compile the C code (e.g., make, or gcc scheduler.c simulator.c -o scheduler -lm -pthread) or provide the correct path.")
         return
 
     # Create all test files
@@ -805,23 +1007,34 @@ def main() -> None:
     
     # Define all test cases
     all_tests = define_test_cases(test_files)
+    all_checks = define_consistency_checks(test_files)
     
     # Filter tests based on command line arguments
     tests_to_run = all_tests
+    checks_to_run = all_checks
     if args.algorithm:
         tests_to_run = [tc for tc in all_tests if tc[1] == args.algorithm]
-        if not tests_to_run:
+        checks_to_run = [cc for cc in all_checks if cc[2] == args.algorithm]
+        if not tests_to_run and not checks_to_run:
             print(f"{COLOR_RED}No tests found for algorithm '{args.algorithm}'{COLOR_RESET}")
             return
             
     if args.test:
         tests_to_run = [tc for tc in tests_to_run if tc[0] == args.test]
-        if not tests_to_run:
+        checks_to_run = [cc for cc in checks_to_run if cc[0] == args.test]
+        if not tests_to_run and not checks_to_run:
             print(f"{COLOR_RED}No test found with name '{args.test}'{COLOR_RESET}")
             return
     
     # Run the filtered tests
-    passed, total = run_tests(executable_path, tests_to_run, args.verbose)
+    passed, total = 0, 0
+    if tests_to_run:
+        passed, total = run_tests(executable_path, tests_to_run, args.verbose)
+    if checks_to_run:
+        checks_passed, checks_total = run_consistency_checks(executable_path, checks_to_run,
+                                                             test_files, args.verbose)
+        passed += checks_passed
+        total += checks_total
     
     # Print summary
     print(f"\n{COLOR_CYAN}--- Test Summary ---{COLOR_RESET}")
@@ -2,21 +2,73 @@
 #include "common.h"
 #include <getopt.h>
 #include <inttypes.h>
+#include <limits.h>
 
-/* Global statistics */
+/* Transfer statistics */
 struct stats {
     uint64_t successful_transfers;
     uint64_t failed_transfers;
     uint64_t deadlock_detections;
     uint64_t retries;
-} stats = {0, 0, 0, 0};
+};
+
+/*
+ * One thread's statistics, alone on its cache line. Only the owning thread
+ * writes them, so counting needs no locked instruction and no shared line.
+ */
+struct stats_shard {
+    struct stats counts;
+    char pad[CACHE_LINE - sizeof(struct stats)];
+};
+
+/*
+ * Totals of the last run, summed from the shards after pthread_join and
+ * overwritten by the next run. Workers never touch them: count with
+ * STAT_INC(field) instead.
+ */
+static struct stats last_totals = {0, 0, 0, 0};
+
+/* The calling worker's shard */
+static __thread struct stats *thread_stats;
+
+/*
+ * Add one to a counter of the calling thread. A relaxed load and store
+ * rather than a read-modify-write: the owner is the only writer, and the
+ * live sampler still never sees a torn value.
+ */
+static inline void stat_inc(uint64_t *counter) {
+    __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+}
+
+#define STAT_INC(field) stat_inc(&thread_stats->field)
+
+/* The calling worker's random number generator, seeded from -s */
+static __thread rng_t thread_rng;
+
+/* Uniform random integer in [0, n) from the calling thread's generator */
+static inline int rand_below(int n) {
+    return (int)rng_below(&thread_rng, (uint32_t)n);
+}
 
 /* Thread worker data */
 struct worker_args {
-    account_t *accounts;
-    int num_accounts;
+    account_table_t *accounts;
     int mode;
     int transfers;
+    struct stats *stats;  /* This worker's shard */
+    uint64_t seed;        /* Run seed (see -s) */
+    int index;            /* Worker number, selects its generator stream */
+    int num_threads;
+    const struct distribution *dist;  /* How accounts are picked (see -d) */
+};
+
+/* Live sampler data (see -i) */
+struct sampler_args {
+    struct stats_shard *shards;
+    int num_threads;
+    int interval_ms;
+    uint64_t t0;
+    int done;  /* Set once the workers are joined */
 };
 
 /* ====== TRANSFER FUNCTION DECLARATIONS ====== */
@@ -66,7 +118,7 @@ static void transfer_naive(account_t *from, account_t *to, int amount) {
     pthread_mutex_unlock(&to->lock);
     pthread_mutex_unlock(&from->lock);
 
-    __sync_fetch_and_add(&stats.successful_transfers, 1);
+    STAT_INC(successful_transfers);
 }
 
 /*
@@ -105,7 +157,7 @@ static int transfer_timeout(account_t *from, account_t *to, int amount) {
     /* Try to lock 'from' with 100ms timeout */
     int ret1 = mutex_trylock_timed(&from->lock, 100);
     if (ret1 == ETIMEDOUT) {
-        /* TODO: Increment deadlock detection counter */
+        /* TODO: Increment deadlock detection counter: STAT_INC(deadlock_detections); */
         return -1;  /* Retry */
     }
 
@@ -116,7 +168,7 @@ static int transfer_timeout(account_t *from, account_t *to, int amount) {
     int ret2 = mutex_trylock_timed(&to->lock, 100);
     if (ret2 == ETIMEDOUT) {
         /* TODO: Release 'from' lock before retrying */
-        /* TODO: Increment deadlock detection counter */
+        /* TODO: Increment deadlock detection counter: STAT_INC(deadlock_detections); */
         return -1;  /* Retry */
     }
 
@@ -128,7 +180,7 @@ static int transfer_timeout(account_t *from, account_t *to, int amount) {
     pthread_mutex_unlock(&to->lock);
     pthread_mutex_unlock(&from->lock);
 
-    __sync_fetch_and_add(&stats.successful_transfers, 1);
+    STAT_INC(successful_transfers);
     return 0;
 }
 
@@ -166,7 +218,7 @@ static void transfer_ordered(account_t *from, account_t *to, int amount) {
 
     /* TODO: Lock in order, perform transfer, unlock in reverse */
 
-    __sync_fetch_and_add(&stats.successful_transfers, 1);
+    STAT_INC(successful_transfers);
 }
 
 /* ====== PART 3B: TRY-LOCK WITH BACKOFF (TODO) ====== */
@@ -185,7 +237,7 @@ static void transfer_ordered(account_t *from, account_t *to, int amount) {
  * - Try to lock 'to' (non-blocking)
  * - If EBUSY, release 'from' and return -1 to retry
  * - If both succeed, perform transfer
- * - Use usleep(rand() % 1000) for random backoff between retries
+ * - Use usleep(rand_below(1000)) for random backoff between retries
  *
  * Questions to think about:
  * - Which deadlock condition does this prevent?
@@ -197,22 +249,242 @@ static int transfer_trylock(account_t *from, account_t *to, int amount) {
     return -1;  /* TODO: implement this function */
 }
 
+/* ====== ACCESS DISTRIBUTIONS ====== */
+/*
+ * How workers pick the two accounts of a transfer (see -d):
+ *   uniform      every account equally likely
+ *   zipf:THETA   account i with probability proportional to 1/(i+1)^THETA
+ *   hot:X/Y      X% of picks go to the first Y% of the accounts
+ *   part:P       P% of transfers stay inside the worker's own slice of the
+ *                accounts; the rest pick uniformly
+ */
+enum { DIST_UNIFORM, DIST_ZIPF, DIST_HOTSET, DIST_PARTITIONED };
+
+struct distribution {
+    int kind;
+    double theta;         /* Zipf exponent */
+    double hot_traffic;   /* Hot set: share of picks (0..1) */
+    double hot_accounts;  /* Hot set: share of accounts (0..1) */
+    double locality;      /* Partitioned: share of transfers kept in the slice (0..1) */
+    int n;                /* Accounts the distribution was prepared for */
+    int hot;              /* Hot set: accounts in it, at least 2 */
+    float *prob;          /* Zipf alias table: keep slot i with this probability... */
+    uint32_t *alias;      /* ...else take alias[i] */
+    float *tail_prob;     /* Zipf alias table of accounts 1..n-1, for a partner of account 0 */
+    uint32_t *tail_alias;
+};
+
+/* Parse a -d argument; returns 0 if it is malformed */
+static int parse_distribution(const char *spec, struct distribution *dist) {
+    memset(dist, 0, sizeof(*dist));
+    char extra;
+    if (strcmp(spec, "uniform") == 0) {
+        dist->kind = DIST_UNIFORM;
+        return 1;
+    }
+    if (sscanf(spec, "zipf:%lf%c", &dist->theta, &extra) == 1) {
+        dist->kind = DIST_ZIPF;
+        return dist->theta >= 0.0 && dist->theta <= 10.0;
+    }
+    if (sscanf(spec, "hot:%lf/%lf%c", &dist->hot_traffic, &dist->hot_accounts, &extra) == 2) {
+        dist->kind = DIST_HOTSET;
+        dist->hot_traffic /= 100.0;
+        dist->hot_accounts /= 100.0;
+        return dist->hot_traffic >= 0.0 && dist->hot_traffic < 1.0 && dist->hot_accounts > 0.0 &&
+               dist->hot_accounts < 1.0;
+    }
+    if (sscanf(spec, "part:%lf%c", &dist->locality, &extra) == 1) {
+        dist->kind = DIST_PARTITIONED;
+        dist->locality /= 100.0;
+        return dist->locality >= 0.0 && dist->locality <= 1.0;
+    }
+    return 0;
+}
+
+static void describe_distribution(const struct distribution *dist, char *buf, size_t size) {
+    switch (dist->kind) {
+    case DIST_ZIPF:
+        snprintf(buf, size, "zipf theta=%.2f", dist->theta);
+        break;
+    case DIST_HOTSET:
+        snprintf(buf, size, "hot %.0f%%/%.0f%%", dist->hot_traffic * 100.0, dist->hot_accounts * 100.0);
+        break;
+    case DIST_PARTITIONED:
+        snprintf(buf, size, "partitioned %.0f%%", dist->locality * 100.0);
+        break;
+    default:
+        snprintf(buf, size, "uniform");
+    }
+}
+
+/*
+ * Build an alias table over n slots where slot i weighs (i + 1 + first)^-theta
+ * (Vose's method, O(n)), so a pick costs one uniform slot and one coin flip
+ * however skewed the weights are.
+ */
+static void build_alias_table(double theta, int first, int n, float **prob_out, uint32_t **alias_out) {
+    double *scaled = malloc((size_t)n * sizeof(double));
+    uint32_t *work = malloc((size_t)n * sizeof(uint32_t));
+    float *prob = malloc((size_t)n * sizeof(float));
+    uint32_t *alias = malloc((size_t)n * sizeof(uint32_t));
+    if (!scaled || !work || !prob || !alias) {
+        die("malloc");
+    }
+
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) {
+        scaled[i] = pow(i + 1.0 + first, -theta);
+        sum += scaled[i];
+    }
+
+    /* Small slots (below the mean) stack up from the front of 'work', large ones from the back */
+    int small = 0, large = n;
+    for (int i = 0; i < n; i++) {
+        scaled[i] *= n / sum;
+        if (scaled[i] < 1.0) work[small++] = (uint32_t)i;
+        else work[--large] = (uint32_t)i;
+    }
+    int small_top = small, large_top = large;
+    while (small_top > 0 && large_top < n) {
+        uint32_t s = work[--small_top], l = work[large_top];
+        prob[s] = (float)scaled[s];
+        alias[s] = l;
+        scaled[l] -= 1.0 - scaled[s];
+        if (scaled[l] < 1.0) {
+            large_top++;
+            work[small_top++] = l;
+        }
+    }
+    /* Leftovers are full slots, up to rounding */
+    while (small_top > 0) {
+        uint32_t s = work[--small_top];
+        prob[s] = 1.0f;
+        alias[s] = s;
+    }
+    for (int i = large_top; i < n; i++) {
+        prob[work[i]] = 1.0f;
+        alias[work[i]] = work[i];
+    }
+    free(scaled);
+    free(work);
+    *prob_out = prob;
+    *alias_out = alias;
+}
+
+/*
+ * Size the distribution for n accounts. Zipf gets two alias tables: one
+ * over all accounts, and one over accounts 1..n-1 for the partner of
+ * account 0, which under a steep exponent is nearly every transfer's
+ * source -- redrawing until the pick differed would spin there. Any other
+ * source carries at most half of the weight, so a redraw almost always
+ * ends after one or two picks.
+ */
+static void prepare_distribution(struct distribution *dist, int n) {
+    dist->n = n;
+    if (dist->kind == DIST_HOTSET) {
+        /* Both sides need two accounts to draw distinct pairs from */
+        dist->hot = (int)(n * dist->hot_accounts);
+        if (dist->hot > n - 2) dist->hot = n - 2;
+        if (dist->hot < 2) dist->hot = 2;
+    }
+    if (dist->kind != DIST_ZIPF) return;
+    build_alias_table(dist->theta, 0, n, &dist->prob, &dist->alias);
+    build_alias_table(dist->theta, 1, n - 1, &dist->tail_prob, &dist->tail_alias);
+}
+
+static void free_distribution(struct distribution *dist) {
+    free(dist->prob);
+    free(dist->alias);
+    free(dist->tail_prob);
+    free(dist->tail_alias);
+    dist->prob = NULL;
+    dist->alias = NULL;
+    dist->tail_prob = NULL;
+    dist->tail_alias = NULL;
+}
+
+/* One of the 'size' accounts starting at 'first', other than 'taken' */
+static inline int pick_other_in(int first, int size, int taken) {
+    int pick = first + rand_below(size - 1);
+    return pick >= taken ? pick + 1 : pick;
+}
+
+/* One slot of an alias table */
+static inline int pick_alias(const float *prob, const uint32_t *alias, int n) {
+    int slot = rand_below(n);
+    return rng_double(&thread_rng) < prob[slot] ? slot : (int)alias[slot];
+}
+
+/* One account from the distribution (partitioned traffic picks in pick_accounts) */
+static inline int pick_account(const struct distribution *dist) {
+    int n = dist->n;
+    if (dist->kind == DIST_ZIPF) {
+        return pick_alias(dist->prob, dist->alias, n);
+    }
+    if (dist->kind == DIST_HOTSET) {
+        int hot = dist->hot;
+        if (hot == n || rng_double(&thread_rng) < dist->hot_traffic) return rand_below(hot);
+        return hot + rand_below(n - hot);
+    }
+    return rand_below(n);
+}
+
+/* An account from the distribution other than 'from', drawn among the remaining n-1 */
+static inline int pick_partner(const struct distribution *dist, int from) {
+    int n = dist->n;
+    if (dist->kind == DIST_ZIPF) {
+        if (from == 0) return 1 + pick_alias(dist->tail_prob, dist->tail_alias, n - 1);
+        int to;
+        do {
+            to = pick_alias(dist->prob, dist->alias, n);
+        } while (to == from);
+        return to;
+    }
+    if (dist->kind == DIST_HOTSET) {
+        int hot = dist->hot;
+        int first = 0, size = hot;
+        if (hot < n - 1 && rng_double(&thread_rng) >= dist->hot_traffic) {
+            first = hot;
+            size = n - hot;
+        }
+        if (from < first || from >= first + size) return first + rand_below(size);
+        return pick_other_in(first, size, from);
+    }
+    return pick_other_in(0, n, from);
+}
+
+/* The two distinct accounts of worker 'index' of 'threads' for its next transfer */
+static inline void pick_accounts(const struct distribution *dist, int index, int threads, int *from_id, int *to_id) {
+    if (dist->kind == DIST_PARTITIONED) {
+        int begin = (int)((int64_t)dist->n * index / threads);
+        int size = (int)((int64_t)dist->n * (index + 1) / threads) - begin;
+        if (size >= 2 && rng_double(&thread_rng) < dist->locality) {
+            *from_id = begin + rand_below(size);
+            *to_id = pick_other_in(begin, size, *from_id);
+            return;
+        }
+    }
+    *from_id = pick_account(dist);
+    *to_id = pick_partner(dist, *from_id);
+}
+
 /* ====== THREAD WORKER ====== */
 static void *worker(void *arg) {
     struct worker_args *args = (struct worker_args *)arg;
+    thread_stats = args->stats;
+    rng_seed(&thread_rng, args->seed);
+    for (int i = 0; i < args->index; i++) {
+        rng_jump(&thread_rng);
+    }
 
     for (int i = 0; i < args->transfers; i++) {
-        /* Pick random source and destination (must be different) */
-        int from_id = rand() % args->num_accounts;
-        int to_id = rand() % args->num_accounts;
-        if (from_id == to_id) {
-            i--;  /* Skip this iteration */
-            continue;
-        }
+        /* Pick random source and destination (always different) */
+        int from_id, to_id;
+        pick_accounts(args->dist, args->index, args->num_threads, &from_id, &to_id);
 
-        account_t *from = &args->accounts[from_id];
-        account_t *to = &args->accounts[to_id];
-        int amount = 1 + (rand() % 10);  /* Transfer 1-10 dollars */
+        account_t *from = account_at(args->accounts, from_id);
+        account_t *to = account_at(args->accounts, to_id);
+        int amount = 1 + rand_below(10);  /* Transfer 1-10 dollars */
 
         /* Call appropriate transfer function based on mode */
         int retry_count = 0;
@@ -222,9 +494,9 @@ static void *worker(void *arg) {
             transfer_naive(from, to, amount);
         } else if (args->mode == 1) {  /* TIMEOUT */
             while (transfer_timeout(from, to, amount) != 0) {
-                __sync_fetch_and_add(&stats.retries, 1);
+                STAT_INC(retries);
                 if (++retry_count > max_retries) {
-                    __sync_fetch_and_add(&stats.failed_transfers, 1);
+                    STAT_INC(failed_transfers);
                     break;
                 }
                 usleep(10 * 1000);  /* 10ms delay between retries */
@@ -233,12 +505,12 @@ static void *worker(void *arg) {
             transfer_ordered(from, to, amount);
         } else if (args->mode == 3) {  /* TRYLOCK */
             while (transfer_trylock(from, to, amount) != 0) {
-                __sync_fetch_and_add(&stats.retries, 1);
+                STAT_INC(retries);
                 if (++retry_count > max_retries) {
-                    __sync_fetch_and_add(&stats.failed_transfers, 1);
+                    STAT_INC(failed_transfers);
                     break;
                 }
-                usleep(rand() % 1000000);  /* Random backoff 0-999999 µs */
+                usleep(rand_below(1000000));  /* Random backoff 0-999999 µs */
             }
         }
     }
@@ -246,30 +518,333 @@ static void *worker(void *arg) {
     return NULL;
 }
 
+/* ====== LIVE SAMPLER ====== */
+/* Sum the shards as they stand; workers may still be counting */
+static struct stats sum_shards(struct stats_shard *shards, int num_threads) {
+    struct stats total = {0, 0, 0, 0};
+    for (int i = 0; i < num_threads; i++) {
+        total.successful_transfers += __atomic_load_n(&shards[i].counts.successful_transfers, __ATOMIC_RELAXED);
+        total.failed_transfers += __atomic_load_n(&shards[i].counts.failed_transfers, __ATOMIC_RELAXED);
+        total.deadlock_detections += __atomic_load_n(&shards[i].counts.deadlock_detections, __ATOMIC_RELAXED);
+        total.retries += __atomic_load_n(&shards[i].counts.retries, __ATOMIC_RELAXED);
+    }
+    return total;
+}
+
+/* Print running totals and the rate since the previous sample every interval_ms */
+static void *sampler(void *arg) {
+    struct sampler_args *args = (struct sampler_args *)arg;
+    uint64_t last_ns = args->t0, last_transfers = 0;
+    uint64_t next_ns = args->t0 + (uint64_t)args->interval_ms * 1000000ULL;
+
+    while (!__atomic_load_n(&args->done, __ATOMIC_ACQUIRE)) {
+        uint64_t now = now_ns();
+        if (now < next_ns) {
+            uint64_t wait_us = (next_ns - now) / 1000;
+            usleep(wait_us < 10000 ? wait_us : 10000);  /* Check 'done' at least every 10ms */
+            continue;
+        }
+        struct stats total = sum_shards(args->shards, args->num_threads);
+        printf("[%7.3fs] transfers: %" PRIu64 " (%.0f/s), retries: %" PRIu64 ", detections: %" PRIu64 "\n",
+               (now - args->t0) / 1e9, total.successful_transfers,
+               (total.successful_transfers - last_transfers) / ((now - last_ns) / 1e9), total.retries,
+               total.deadlock_detections);
+        fflush(stdout);
+        last_ns = now;
+        last_transfers = total.successful_transfers;
+        while (next_ns <= now) {  /* Skip samples missed while descheduled */
+            next_ns += (uint64_t)args->interval_ms * 1000000ULL;
+        }
+    }
+    return NULL;
+}
+
+/* ====== RUNNING TRANSFERS ====== */
+/*
+ * Run the workers over the table, sum their statistics into last_totals and
+ * return the elapsed time in seconds. Worker i draws from stream i of the
+ * generator seeded with 'seed' and picks accounts from 'dist', which must
+ * be prepared for the table. With sample_ms > 0 a sampler thread prints
+ * running totals while they work.
+ */
+static double run_transfers(account_table_t *accounts, int mode, int num_threads, int transfers_per_thread,
+                            int sample_ms, uint64_t seed, const struct distribution *dist) {
+    pthread_t threads[num_threads];
+    struct worker_args args[num_threads];
+    void *shard_memory;
+    int rc = posix_memalign(&shard_memory, CACHE_LINE, num_threads * sizeof(struct stats_shard));
+    if (rc != 0) {
+        die2("posix_memalign", strerror(rc));
+    }
+    struct stats_shard *shards = (struct stats_shard *)shard_memory;
+    memset(shards, 0, num_threads * sizeof(struct stats_shard));
+
+    uint64_t t0 = now_ns();
+
+    for (int i = 0; i < num_threads; i++) {
+        args[i] = (struct worker_args){
+            .accounts = accounts,
+            .mode = mode,
+            .transfers = transfers_per_thread,
+            .stats = &shards[i].counts,
+            .seed = seed,
+            .index = i,
+            .num_threads = num_threads,
+            .dist = dist
+        };
+        if (pthread_create(&threads[i], NULL, worker, &args[i]) != 0) {
+            die("pthread_create");
+        }
+    }
+
+    pthread_t sampler_thread;
+    struct sampler_args sampling = {shards, num_threads, sample_ms, t0, 0};
+    if (sample_ms > 0 && pthread_create(&sampler_thread, NULL, sampler, &sampling) != 0) {
+        die("pthread_create");
+    }
+
+    /* Wait for all threads to complete */
+    for (int i = 0; i < num_threads; i++) {
+        if (pthread_join(threads[i], NULL) != 0) {
+            die("pthread_join");
+        }
+    }
+
+    uint64_t t1 = now_ns();
+
+    if (sample_ms > 0) {
+        __atomic_store_n(&sampling.done, 1, __ATOMIC_RELEASE);
+        if (pthread_join(sampler_thread, NULL) != 0) {
+            die("pthread_join");
+        }
+    }
+
+    last_totals = sum_shards(shards, num_threads);
+    free(shards);
+    return (t1 - t0) / 1e9;
+}
+
+/* ====== PADDING BENCHMARK ====== */
+/*
+ * Transfers/sec of one mode with packed and with padded accounts, at 1 to
+ * MAX_BENCH_THREADS threads. Every run starts from fresh accounts and must
+ * keep the total balance.
+ */
+#define MAX_BENCH_THREADS 64
+
+static const char *mode_names[] = {"NAIVE", "TIMEOUT", "ORDERED", "TRYLOCK"};
+
+static void benchmark_padding(int mode, int num_accounts, int transfers_per_thread, size_t line, int huge,
+                              uint64_t seed, struct distribution *dist) {
+    char dist_name[64];
+    describe_distribution(dist, dist_name, sizeof(dist_name));
+    prepare_distribution(dist, num_accounts);
+    printf("=== Padding Benchmark ===\n");
+    printf("Mode: %s, Accounts: %d (%s), Transfers per thread: %d, Seed: %" PRIu64 "\n", mode_names[mode],
+           num_accounts, dist_name, transfers_per_thread, seed);
+    printf("Account size: %zu bytes packed, %zu bytes padded to %zu-byte lines\n\n", sizeof(account_t),
+           (sizeof(account_t) + line - 1) / line * line, line);
+    printf("%-8s %18s %18s %8s\n", "Threads", "Packed (xfer/s)", "Padded (xfer/s)", "Speedup");
+
+    for (int threads = 1; threads <= MAX_BENCH_THREADS; threads *= 2) {
+        double rate[2];
+        for (int padded = 0; padded <= 1; padded++) {
+            account_table_t accounts;
+            alloc_accounts(&accounts, num_accounts, padded ? line : 0, huge);
+            init_accounts(&accounts, INITIAL_BALANCE);
+            double elapsed_sec = run_transfers(&accounts, mode, threads, transfers_per_thread, 0, seed, dist);
+            rate[padded] = last_totals.successful_transfers / elapsed_sec;
+
+            if (sum_balances(&accounts) != (int64_t)num_accounts * INITIAL_BALANCE) {
+                fprintf(stderr, "ERROR: Balance mismatch at %d threads! Money was lost or created.\n", threads);
+                exit(1);
+            }
+            free_accounts(&accounts);
+        }
+        printf("%-8d %18.0f %18.0f %7.2fx\n", threads, rate[0], rate[1], rate[0] > 0 ? rate[1] / rate[0] : 0.0);
+    }
+    free_distribution(dist);
+}
+
+/* ====== SKEW BENCHMARK ====== */
+/*
+ * Transfers/sec of each mode under increasingly skewed traffic. Strategies
+ * that win on uniform picks can lose once a few accounts take most of the
+ * transfers, as conflicts turn into retries or waits. It runs on
+ * SKEW_ACCOUNTS accounts unless -a says otherwise, and refuses fewer than
+ * MIN_SKEW_ACCOUNTS: on a handful of accounts every level is one hot set.
+ */
+#define SKEW_ACCOUNTS 1000
+#define MIN_SKEW_ACCOUNTS 100  /* hot:95/5 still has 5 hot accounts */
+
+static const char *skew_levels[] = {
+    "uniform", "zipf:0.5", "zipf:0.9", "zipf:0.99", "zipf:1.2", "hot:80/20", "hot:95/5", "part:90"
+};
+
+static void benchmark_skew(int first_mode, int last_mode, int num_accounts, int num_threads,
+                           int transfers_per_thread, size_t line, int huge, uint64_t seed) {
+    printf("=== Skew Benchmark ===\n");
+    printf("Accounts: %d, Threads: %d, Transfers per thread: %d, Seed: %" PRIu64 "\n\n", num_accounts,
+           num_threads, transfers_per_thread, seed);
+    printf("%-20s", "Distribution");
+    for (int mode = first_mode; mode <= last_mode; mode++) {
+        printf(" %14s/s", mode_names[mode]);
+    }
+    printf("\n");
+
+    for (size_t level = 0; level < sizeof(skew_levels) / sizeof(skew_levels[0]); level++) {
+        struct distribution dist;
+        char dist_name[64];
+        parse_distribution(skew_levels[level], &dist);
+        prepare_distribution(&dist, num_accounts);
+        describe_distribution(&dist, dist_name, sizeof(dist_name));
+        printf("%-20s", dist_name);
+        fflush(stdout);
+
+        for (int mode = first_mode; mode <= last_mode; mode++) {
+            account_table_t accounts;
+            alloc_accounts(&accounts, num_accounts, line, huge);
+            init_accounts(&accounts, INITIAL_BALANCE);
+            double elapsed_sec = run_transfers(&accounts, mode, num_threads, transfers_per_thread, 0, seed, &dist);
+            if (sum_balances(&accounts) != (int64_t)num_accounts * INITIAL_BALANCE) {
+                fprintf(stderr, "\nERROR: Balance mismatch under %s! Money was lost or created.\n", dist_name);
+                exit(1);
+            }
+            free_accounts(&accounts);
+            printf(" %16.0f", last_totals.successful_transfers / elapsed_sec);
+            fflush(stdout);
+        }
+        printf("\n");
+        free_distribution(&dist);
+    }
+}
+
+/* Parse a whole decimal number in [min, max] for an option, or exit */
+static int parse_int_arg(const char *text, long min, long max, const char *what) {
+    char *end;
+    errno = 0;
+    long value = strtol(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0' || value < min || value > max) {
+        fprintf(stderr, "Invalid %s: %s (expected %ld to %ld)\n", what, text, min, max);
+        exit(1);
+    }
+    return (int)value;
+}
+
+/* Parse a whole unsigned number (decimal, 0x hex or 0 octal) for an option, or exit */
+static uint64_t parse_u64_arg(const char *text, const char *what) {
+    char *end;
+    errno = 0;
+    unsigned long long value = strtoull(text, &end, 0);
+    /* strtoull also takes leading blanks and a sign, and wraps negative numbers around */
+    if (errno != 0 || text[0] < '0' || text[0] > '9' || *end != '\0') {
+        fprintf(stderr, "Invalid %s: %s (expected 0 to %" PRIu64 ")\n", what, text, UINT64_MAX);
+        exit(1);
+    }
+    return (uint64_t)value;
+}
+
 /* ====== MAIN ====== */
 int main(int argc, char *argv[]) {
     int num_threads = NUM_THREADS;
+    int num_accounts = NUM_ACCOUNTS;
+    int accounts_given = 0;
+    int huge = 0;  /* Map the table with huge pages */
+    int mode_given = 0;
+    int skew_benchmark = 0;
+    struct distribution dist;
+    parse_distribution("uniform", &dist);
     int transfers_per_thread = TRANSFERS_PER_THREAD;
     int mode = 0;  /* 0=naive, 1=timeout, 2=ordered, 3=trylock */
+    size_t line = 0;  /* Account padding: 0 = packed, else the cache line size */
+    int benchmark = 0;
+    int sample_ms = 0;  /* Live sampling interval, 0 = off */
+    uint64_t seed = (uint64_t)time(NULL);
 
     /* Parse command line arguments */
     int opt;
-    while ((opt = getopt(argc, argv, "t:n:m:")) != -1) {
+    while ((opt = getopt(argc, argv, "t:n:m:a:Hp:bSi:s:d:")) != -1) {
         switch (opt) {
         case 't':
-            num_threads = atoi(optarg);
+            num_threads = parse_int_arg(optarg, 1, MAX_THREADS, "thread count");
             break;
         case 'n':
-            transfers_per_thread = atoi(optarg);
+            transfers_per_thread = parse_int_arg(optarg, 1, INT_MAX, "transfer count");
             break;
         case 'm':
-            mode = atoi(optarg);
+            mode = parse_int_arg(optarg, 0, 3, "mode");
+            mode_given = 1;
+            break;
+        case 'd':
+            if (!parse_distribution(optarg, &dist)) {
+                die2("Invalid distribution", "use uniform, zipf:THETA, hot:X/Y or part:P");
+            }
+            break;
+        case 'a':
+            /* A transfer needs two accounts */
+            num_accounts = parse_int_arg(optarg, 2, INT_MAX, "account count");
+            accounts_given = 1;
+            break;
+        case 'H':
+            huge = 1;
+            break;
+        case 'p':
+            line = (size_t)parse_int_arg(optarg, 0, 128, "padding");
+            if (line != 0 && line != 64 && line != 128) {
+                die2("Invalid padding", "use -p 0 (packed), 64 or 128");
+            }
+            break;
+        case 'b':
+            benchmark = 1;
+            break;
+        case 'S':
+            skew_benchmark = 1;
+            break;
+        case 'i':
+            sample_ms = parse_int_arg(optarg, 0, INT_MAX, "sampling interval");
+            break;
+        case 's':
+            seed = parse_u64_arg(optarg, "seed");
             break;
         default:
-            fprintf(stderr, "Usage: %s [-t threads] [-n transfers] [-m mode]\n", argv[0]);
+            fprintf(stderr, "Usage: %s [-t threads] [-n transfers] [-m mode] [-a accounts] [-H] [-d dist] [-p 0|64|128]\n"
+                            "          [-b | -S] [-i ms] [-s seed]\n", argv[0]);
             fprintf(stderr, "  mode: 0=naive, 1=timeout, 2=ordered, 3=trylock\n");
+            fprintf(stderr, "  -a: number of accounts (default: %d)\n", NUM_ACCOUNTS);
+            fprintf(stderr, "  -d: account picks: uniform, zipf:THETA, hot:X/Y (X%% of picks to Y%% of accounts)\n");
+            fprintf(stderr, "      or part:P (P%% of transfers within the thread's own slice)\n");
+            fprintf(stderr, "  -H: map the account table with huge pages\n");
+            fprintf(stderr, "  -p: pad each account to cache lines of this size (0 = packed)\n");
+            fprintf(stderr, "  -s: seed of the per-thread generators (default: the time)\n");
+            fprintf(stderr, "  -i: print running statistics every ms milliseconds\n");
+            fprintf(stderr, "  -b: benchmark packed vs padded accounts at 1-%d threads\n", MAX_BENCH_THREADS);
+            fprintf(stderr, "  -S: benchmark modes 1-3 (or just -m) under each skew level (default -a %d)\n",
+                    SKEW_ACCOUNTS);
+            exit(1);
+        }
+    }
+
+    if (benchmark) {
+        if (mode < 1 || mode > 3) {
+            die2("Invalid benchmark mode", "use -m 1, 2 or 3 (the naive mode deadlocks)");
+        }
+        benchmark_padding(mode, num_accounts, transfers_per_thread, line > 0 ? line : CACHE_LINE, huge, seed,
+                          &dist);
+        return 0;
+    }
+    if (skew_benchmark) {
+        if (mode_given && (mode < 1 || mode > 3)) {
+            die2("Invalid benchmark mode", "use -m 1, 2 or 3 (the naive mode deadlocks)");
+        }
+        if (!accounts_given) num_accounts = SKEW_ACCOUNTS;
+        else if (num_accounts < MIN_SKEW_ACCOUNTS) {
+            fprintf(stderr, "Invalid account count for -S: %d (expected at least %d)\n", num_accounts,
+                    MIN_SKEW_ACCOUNTS);
             exit(1);
         }
+        benchmark_skew(mode_given ? mode : 1, mode_given ? mode : 3, num_accounts, num_threads, transfers_per_thread,
+                       line, huge, seed);
+        return 0;
     }
 
     printf("=== Deadlock Lab ===\n");
@@ -282,60 +857,46 @@ int main(int argc, char *argv[]) {
         fprintf(stderr, "Invalid mode\n");
         exit(1);
     }
-    printf("Threads: %d, Transfers per thread: %d\n\n", num_threads, transfers_per_thread);
+    printf("Threads: %d, Transfers per thread: %d, Seed: %" PRIu64 "\n", num_threads, transfers_per_thread, seed);
 
     /* Initialize accounts */
-    account_t accounts[NUM_ACCOUNTS];
-    init_accounts(accounts, NUM_ACCOUNTS, INITIAL_BALANCE);
-
-    /* Seed random number generator */
-    srand(time(NULL));
-
-    /* Create worker threads */
-    pthread_t threads[num_threads];
-    struct worker_args args = {
-        .accounts = accounts,
-        .num_accounts = NUM_ACCOUNTS,
-        .mode = mode,
-        .transfers = transfers_per_thread
-    };
-
-    uint64_t t0 = now_ns();
-
-    for (int i = 0; i < num_threads; i++) {
-        if (pthread_create(&threads[i], NULL, worker, &args) != 0) {
-            die("pthread_create");
-        }
-    }
-
-    /* Wait for all threads to complete */
-    for (int i = 0; i < num_threads; i++) {
-        if (pthread_join(threads[i], NULL) != 0) {
-            die("pthread_join");
-        }
-    }
-
-    uint64_t t1 = now_ns();
-    double elapsed_sec = (t1 - t0) / 1e9;
+    account_table_t accounts;
+    alloc_accounts(&accounts, num_accounts, line, huge);
+    uint64_t init_start = now_ns();
+    init_accounts(&accounts, INITIAL_BALANCE);
+    printf("Accounts: %d, ", num_accounts);
+    if (line > 0) printf("padded to %zu-byte cache lines", line);
+    else printf("packed");
+    printf(", %s; initialized in %.1f ms by %d thread(s)\n", huge_page_name(accounts.huge),
+           (now_ns() - init_start) / 1e6, setup_threads(num_accounts));
+    char dist_name[64];
+    describe_distribution(&dist, dist_name, sizeof(dist_name));
+    prepare_distribution(&dist, num_accounts);
+    printf("Distribution: %s\n\n", dist_name);
+
+    /* Create worker threads and wait for them */
+    double elapsed_sec = run_transfers(&accounts, mode, num_threads, transfers_per_thread, sample_ms, seed, &dist);
 
     /* Verify results */
     printf("\n=== Results ===\n");
     printf("Elapsed time: %.3f seconds\n", elapsed_sec);
-    printf("Successful transfers: %" PRIu64 "\n", stats.successful_transfers);
-    printf("Failed transfers: %" PRIu64 "\n", stats.failed_transfers);
-    printf("Deadlock detections: %" PRIu64 "\n", stats.deadlock_detections);
-    printf("Retries: %" PRIu64 "\n", stats.retries);
-    printf("Throughput: %.2f transfers/sec\n\n", stats.successful_transfers / elapsed_sec);
+    printf("Successful transfers: %" PRIu64 "\n", last_totals.successful_transfers);
+    printf("Failed transfers: %" PRIu64 "\n", last_totals.failed_transfers);
+    printf("Deadlock detections: %" PRIu64 "\n", last_totals.deadlock_detections);
+    printf("Retries: %" PRIu64 "\n", last_totals.retries);
+    printf("Throughput: %.2f transfers/sec\n\n", last_totals.successful_transfers / elapsed_sec);
 
     /* Check account balances */
-    print_balances(accounts, NUM_ACCOUNTS);
+    print_balances(&accounts);
     printf("\n");
 
-    int expected_total = NUM_ACCOUNTS * INITIAL_BALANCE;
-    if (!verify_total(accounts, NUM_ACCOUNTS, expected_total)) {
+    int64_t expected_total = (int64_t)num_accounts * INITIAL_BALANCE;
+    if (!verify_total(&accounts, expected_total)) {
         printf("FAIL: Balance check failed!\n");
         return 1;
     }
+    free_accounts(&accounts);
+    free_distribution(&dist);
 
     printf("SUCCESS: All transfers completed and balances verified.\n");
     return 0;
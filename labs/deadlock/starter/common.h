@@ -9,12 +9,20 @@
 #include <pthread.h>
 #include <time.h>
 #include <errno.h>
+#include <math.h>
+#include <sys/mman.h>
 
 /* Configuration */
 #define NUM_ACCOUNTS 10
 #define NUM_THREADS 8
+#define MAX_THREADS 1024         /* Upper bound of -t; the worker arrays live on the stack */
 #define TRANSFERS_PER_THREAD 1000
 #define INITIAL_BALANCE 1000
+#define CACHE_LINE 64            /* Default line size of the padded layout (-p) */
+#define HUGE_PAGE_SIZE (2UL << 20)  /* Huge-page tables (-H) are mapped in multiples of this */
+#define PARALLEL_SETUP_MIN 65536 /* Smaller tables are set up and checked by one thread */
+#define MAX_SETUP_THREADS 64
+#define MAX_PRINTED_ACCOUNTS 20
 
 /* Account structure */
 typedef struct {
@@ -23,6 +31,26 @@ typedef struct {
     pthread_mutex_t lock;
 } account_t;
 
+/*
+ * Account table. Accounts sit 'stride' bytes apart: sizeof(account_t) packs
+ * them, so neighbours share cache lines; a multiple of the line size gives
+ * each account lines of its own, and locking one no longer bounces another.
+ */
+typedef struct {
+    char *base;
+    size_t stride;
+    int n;
+    size_t mapped;  /* Bytes mapped with mmap (0: allocated on the heap) */
+    int huge;       /* HUGE_NONE, HUGE_RESERVED or HUGE_TRANSPARENT */
+} account_table_t;
+
+/* Page backing of a table (see -H) */
+enum { HUGE_NONE, HUGE_RESERVED, HUGE_TRANSPARENT };
+
+static inline account_t *account_at(const account_table_t *table, int i) {
+    return (account_t *)(table->base + (size_t)i * table->stride);
+}
+
 /* Error helpers */
 static inline void die(const char *msg) {
     perror(msg);
@@ -34,32 +62,163 @@ static inline void die2(const char *msg, const char *detail) {
     exit(1);
 }
 
-/* Initialize all accounts with locks */
-static inline void init_accounts(account_t accounts[], int n, int initial_balance) {
-    for (int i = 0; i < n; i++) {
-        accounts[i].id = i;
-        accounts[i].balance = initial_balance;
-        if (pthread_mutex_init(&accounts[i].lock, NULL) != 0) {
+/* Allocate a table of n accounts, packed (line 0) or each padded to whole lines of 'line' bytes */
+static inline void alloc_accounts(account_table_t *table, int n, size_t line, int huge) {
+    size_t stride = sizeof(account_t);
+    if (line > 0) {
+        stride = (stride + line - 1) / line * line;
+    }
+    size_t bytes = stride * (size_t)n;
+    table->stride = stride;
+    table->n = n;
+    table->mapped = 0;
+    table->huge = HUGE_NONE;
+
+    if (!huge) {
+        void *base;
+        int rc = posix_memalign(&base, line > 0 ? line : CACHE_LINE, bytes);
+        if (rc != 0) {
+            die2("posix_memalign", strerror(rc));
+        }
+        table->base = (char *)base;
+        return;
+    }
+
+    /* Reserved huge pages if the system has them, else transparent ones where the kernel allows */
+    size_t mapped = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    void *base = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    base = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (base != MAP_FAILED) table->huge = HUGE_RESERVED;
+#endif
+    if (base == MAP_FAILED) {
+        base = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) {
+            die("mmap");
+        }
+#ifdef MADV_HUGEPAGE
+        if (madvise(base, mapped, MADV_HUGEPAGE) == 0) table->huge = HUGE_TRANSPARENT;
+#endif
+    }
+    table->base = (char *)base;
+    table->mapped = mapped;
+}
+
+/* Destroy the locks and release the table */
+static inline void free_accounts(account_table_t *table) {
+    for (int i = 0; i < table->n; i++) {
+        pthread_mutex_destroy(&account_at(table, i)->lock);
+    }
+    if (table->mapped > 0) munmap(table->base, table->mapped);
+    else free(table->base);
+    table->base = NULL;
+}
+
+static inline const char *huge_page_name(int huge) {
+    switch (huge) {
+    case HUGE_RESERVED:
+        return "reserved huge pages";
+    case HUGE_TRANSPARENT:
+        return "transparent huge pages";
+    default:
+        return "base pages";
+    }
+}
+
+/* Threads used to set up or check a table of n accounts */
+static inline int setup_threads(int n) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < PARALLEL_SETUP_MIN || cpus < 2) return 1;
+    return cpus < MAX_SETUP_THREADS ? (int)cpus : MAX_SETUP_THREADS;
+}
+
+/* One thread's slice of the table in init_accounts and sum_balances */
+struct account_range {
+    account_table_t *table;
+    int begin, end;
+    int initial_balance;
+    int64_t total;
+};
+
+static inline void *init_range(void *arg) {
+    struct account_range *range = (struct account_range *)arg;
+    for (int i = range->begin; i < range->end; i++) {
+        account_t *account = account_at(range->table, i);
+        account->id = i;
+        account->balance = range->initial_balance;
+        if (pthread_mutex_init(&account->lock, NULL) != 0) {
             die("pthread_mutex_init");
         }
     }
+    return NULL;
+}
+
+static inline void *sum_range(void *arg) {
+    struct account_range *range = (struct account_range *)arg;
+    int64_t total = 0;
+    for (int i = range->begin; i < range->end; i++) {
+        total += account_at(range->table, i)->balance;
+    }
+    range->total = total;
+    return NULL;
+}
+
+/*
+ * Run fn over the table split into equal slices, one per thread, and
+ * return the sum of the slices' totals. Each thread touches its slice
+ * first, so on NUMA machines the pages of a fresh mapping spread across
+ * the nodes.
+ */
+static inline int64_t for_account_ranges(account_table_t *table, int initial_balance, void *(*fn)(void *)) {
+    int threads = setup_threads(table->n);
+    pthread_t tids[MAX_SETUP_THREADS];
+    struct account_range ranges[MAX_SETUP_THREADS];
+    for (int t = 0; t < threads; t++) {
+        ranges[t] = (struct account_range){table, (int)((int64_t)table->n * t / threads),
+                                           (int)((int64_t)table->n * (t + 1) / threads), initial_balance, 0};
+    }
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&tids[t], NULL, fn, &ranges[t]) != 0) {
+            die("pthread_create");
+        }
+    }
+    fn(&ranges[0]);
+    int64_t total = ranges[0].total;
+    for (int t = 1; t < threads; t++) {
+        if (pthread_join(tids[t], NULL) != 0) {
+            die("pthread_join");
+        }
+        total += ranges[t].total;
+    }
+    return total;
 }
 
-/* Print all account balances */
-static inline void print_balances(account_t accounts[], int n) {
+/* Initialize all accounts with locks */
+static inline void init_accounts(account_table_t *table, int initial_balance) {
+    for_account_ranges(table, initial_balance, init_range);
+}
+
+/* Sum all balances */
+static inline int64_t sum_balances(account_table_t *table) {
+    return for_account_ranges(table, 0, sum_range);
+}
+
+/* Print all account balances (only a count for large tables) */
+static inline void print_balances(const account_table_t *table) {
+    if (table->n > MAX_PRINTED_ACCOUNTS) {
+        printf("Account balances: %d accounts (not listed)\n", table->n);
+        return;
+    }
     printf("Account balances:\n");
-    for (int i = 0; i < n; i++) {
-        printf("  Account %d: $%d\n", accounts[i].id, accounts[i].balance);
+    for (int i = 0; i < table->n; i++) {
+        printf("  Account %d: $%d\n", account_at(table, i)->id, account_at(table, i)->balance);
     }
 }
 
 /* Verify the total balance (money should not be created or destroyed) */
-static inline int verify_total(account_t accounts[], int n, int expected_total) {
-    int total = 0;
-    for (int i = 0; i < n; i++) {
-        total += accounts[i].balance;
-    }
-    printf("Total balance: $%d (expected: $%d)\n", total, expected_total);
+static inline int verify_total(account_table_t *table, int64_t expected_total) {
+    int64_t total = sum_balances(table);
+    printf("Total balance: $%lld (expected: $%lld)\n", (long long)total, (long long)expected_total);
     if (total != expected_total) {
         fprintf(stderr, "ERROR: Balance mismatch! Money was lost or created.\n");
         return 0;
@@ -67,6 +226,71 @@ static inline int verify_total(account_t accounts[], int n, int expected_total)
     return 1;
 }
 
+/*
+ * xoshiro256** (Blackman and Vigna): a small, fast generator with no shared
+ * state, so each thread can own one instead of contending on rand()
+ */
+typedef struct {
+    uint64_t s[4];
+} rng_t;
+
+/* splitmix64 step, used to spread a seed over the xoshiro state */
+static inline uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t rotl64(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static inline void rng_seed(rng_t *rng, uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+        rng->s[i] = splitmix64(&seed);
+    }
+}
+
+static inline uint64_t rng_next(rng_t *rng) {
+    uint64_t *s = rng->s;
+    uint64_t result = rotl64(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl64(s[3], 45);
+    return result;
+}
+
+/* Advance 2^128 steps; jumping i times gives thread i a stream no other thread reaches */
+static inline void rng_jump(rng_t *rng) {
+    static const uint64_t jump[4] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                     0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+    uint64_t s[4] = {0, 0, 0, 0};
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (jump[i] & (1ULL << b)) {
+                for (int k = 0; k < 4; k++) s[k] ^= rng->s[k];
+            }
+            rng_next(rng);
+        }
+    }
+    memcpy(rng->s, s, sizeof(s));
+}
+
+/* Uniform integer in [0, n) by multiply-shift (no division, negligible bias for small n) */
+static inline uint32_t rng_below(rng_t *rng, uint32_t n) {
+    return (uint32_t)(((rng_next(rng) >> 32) * n) >> 32);
+}
+
+/* Uniform double in [0, 1) from the top 53 bits of a draw */
+static inline double rng_double(rng_t *rng) {
+    return (rng_next(rng) >> 11) * 0x1.0p-53;
+}
+
 /* Get current time in nanoseconds */
 static inline uint64_t now_ns(void) {
     struct timespec ts;